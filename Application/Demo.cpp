@@ -1,9 +1,11 @@
 #include "Demo.h"
 
 #include <Graphics/Renderable/FontAtlas.h>
+#include <Graphics/Renderable/DrawableSurface.h>
 #include <Graphics/Resource/DX11TextureImpl.h>
 #include <Utilities/Logger.h>
 #include <algorithm>
+#include <cmath>
 
 
 #pragma region demo
@@ -37,101 +39,243 @@ void demo::Demo::OnUpdate(float delta)
 
 #pragma region launch state
 demo::LaunchState::LaunchState() :
-	m_frameRateMonitor(1.0f)
+	m_frameRateMonitor(1.0f),
+	m_camera({ 0.0f, 0.0f, 0.0f, 0.0f })
 {
 
 }
 
 void demo::LaunchState::Enter(Demo& owner)
 {
-	// create font atlas for rendering text we will use fore demo
+	// create font atlas for rendering text we will use fore demo. its texture upload uses the device context,
+	// which belongs to render thread when there is one
+	std::unique_lock<std::mutex> renderContext = owner.Engine().LockRenderContext();
 	m_fontAtlas = std::make_unique<graphics::renderable::FontAtlas>(std::make_unique<graphics::dx11::resource::DX11TextureImpl>());
 	m_fontAtlas->Initialize("Arial", 24);
 	LOG("[LaunchState] Font atlas created and initialized...");
+
+	// placed at the right edge in Update, once viewport is known
+	m_stateLabel = owner.Engine().RenderList().AddText(*m_fontAtlas, "State: LaunchState", { 0, 10 }, graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f });
+
+	// spread over the screen, drifting slowly in different directions
+	m_particles.resize(2000);
+	for (size_t i = 0; i < m_particles.size(); ++i)
+	{
+		m_particles[i].pos = { static_cast<float>((i * 7919) % 1000) / 1000.0f, static_cast<float>((i * 104729) % 1000) / 1000.0f };
+		m_particles[i].velocity = { static_cast<float>(static_cast<int>(i % 21) - 10) * 0.004f, static_cast<float>(static_cast<int>(i % 13) - 6) * 0.006f };
+	}
+
+	// plain colored surfaces for actors and effects. they are drawn into while we still hold the render context
+	m_actorSurface = std::make_unique<graphics::renderable::DrawableSurface>(std::make_unique<graphics::dx11::resource::DX11TextureImpl>());
+	m_actorSurface->Initialize(32, 32);
+	m_actorSurface->Begin();
+	m_actorSurface->Clear(0.9f, 0.5f, 0.1f, 1.0f);
+	m_actorSurface->End();
+
+	m_effectSurface = std::make_unique<graphics::renderable::DrawableSurface>(std::make_unique<graphics::dx11::resource::DX11TextureImpl>());
+	m_effectSurface->Initialize(16, 16);
+	m_effectSurface->Begin();
+	m_effectSurface->Clear(0.2f, 0.8f, 1.0f, 1.0f);
+	m_effectSurface->End();
+
+	// scatter actors and effects (every third object) over the whole world, so most of them are off screen
+	engine::command::RenderQueue::WorldIndex& world = owner.Engine().World();
+	const math::geometry::RectF& worldBounds = world.GetWorldBounds();
+	m_worldObjects.reserve(15000);
+	for (size_t i = 0; i < 15000; ++i)
+	{
+		bool effect = i % 3 == 0;
+		float size = effect ? 16.0f : 32.0f;
+		float x = worldBounds.left + static_cast<float>((i * 7919) % 10007) / 10007.0f * (worldBounds.GetWidth() - size);
+		float y = worldBounds.top + static_cast<float>((i * 104729) % 10009) / 10009.0f * (worldBounds.GetHeight() - size);
+		float speed = effect ? 120.0f : 40.0f;
+
+		engine::command::RenderQueue::WorldRenderable renderable =
+		{
+			effect ? m_effectSurface.get() : m_actorSurface.get(),
+			graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f },
+			0.0f,
+			effect ? EffectLayer : ActorLayer,
+			0.0f
+		};
+
+		WorldObject object;
+		object.handle = world.Insert({ x, y, x + size, y + size }, renderable);
+		object.velocity = { std::cos(static_cast<float>(i)) * speed, std::sin(static_cast<float>(i)) * speed };
+		m_worldObjects.push_back(object);
+	}
+	m_camera.SetWorldSize(worldBounds.GetWidth(), worldBounds.GetHeight());
 }
 
 void demo::LaunchState::Exit(Demo& owner)
 {
+	owner.Engine().RenderList().Remove(m_stateLabel);
+	owner.Engine().CommandQueue().Clear(engine::command::Type::Render);
+
+	// packets point at surfaces of this state
+	owner.Engine().RenderQueue().Clear();
+	for (const WorldObject& object : m_worldObjects)
+	{
+		owner.Engine().World().Remove(object.handle);
+	}
+	m_worldObjects.clear();
 }
 
 void demo::LaunchState::Update(Demo& owner, float delta)
 {
 	m_frameRateMonitor.OnFrameCompleted(delta);
 
-	// flush the draw commands on queue. we will queue new ones 
+	// flush the draw packets on queue. we will queue new ones 
+	owner.Engine().RenderQueue().Clear();
+
+	// render commands stay on the queue until cleared, so last update's particles go first. batches run on workers
+	// and, while Wait runs them, on main thread. each records into its own thread's buffer, no locks
 	owner.Engine().CommandQueue().Clear(engine::command::Type::Render);
 
+	math::geometry::RectF viewPort = owner.Engine().GetViewPort();
+	job::JobHandle particles = owner.Engine().Jobs().ParallelFor(m_particles.size(), 250, [this, &owner, viewPort, delta](size_t begin, size_t end)
+		{
+			engine::command::CommandBuffer& commands = owner.Engine().CommandQueue().GetWorkerBuffer(owner.Engine().Jobs().GetCurrentWorker());
+			for (size_t i = begin; i < end; ++i)
+			{
+				Particle& particle = m_particles[i];
+				particle.pos += particle.velocity * delta;
+				particle.pos.x -= particle.pos.x >= 1.0f ? 1.0f : (particle.pos.x < 0.0f ? -1.0f : 0.0f);
+				particle.pos.y -= particle.pos.y >= 1.0f ? 1.0f : (particle.pos.y < 0.0f ? -1.0f : 0.0f);
+
+				commands.Record<engine::command::graphics::renderer::DrawQuadCommand>(
+					owner.Engine().Renderer(),
+					spatial::PositionF{ particle.pos.x * viewPort.GetWidth(), particle.pos.y * viewPort.GetHeight() },
+					spatial::SizeF{ 3.0f, 3.0f },
+					graphics::ColorF{ 0.6f, 0.6f, 0.8f, 1.0f },
+					0.0f);
+			}
+		});
+	owner.Engine().Jobs().Wait(particles);
+
+	// move actors and effects, bouncing off world edges. index only relinks those whose center crossed into
+	// another cell
+	engine::command::RenderQueue::WorldIndex& world = owner.Engine().World();
+	const math::geometry::RectF& worldBounds = world.GetWorldBounds();
+	for (WorldObject& object : m_worldObjects)
+	{
+		math::geometry::RectF bounds = world.GetBounds(object.handle);
+		if (bounds.left + object.velocity.x * delta < worldBounds.left || bounds.right + object.velocity.x * delta > worldBounds.right)
+		{
+			object.velocity.x = -object.velocity.x;
+		}
+		if (bounds.top + object.velocity.y * delta < worldBounds.top || bounds.bottom + object.velocity.y * delta > worldBounds.bottom)
+		{
+			object.velocity.y = -object.velocity.y;
+		}
+
+		float x = object.velocity.x * delta;
+		float y = object.velocity.y * delta;
+		world.Move(object.handle, { bounds.left + x, bounds.top + y, bounds.right + x, bounds.bottom + y });
+	}
+
+	// camera circles slowly over the world. only objects in its visible rect become draw packets
+	m_time += delta;
+	m_camera.SetViewport(owner.Engine().GetViewPort());
+	m_camera.CenterOn(
+		spatial::PositionF
+		{
+			worldBounds.left + worldBounds.GetWidth() * (0.5f + 0.4f * std::cos(m_time * 0.05f)),
+			worldBounds.top + worldBounds.GetHeight() * (0.5f + 0.4f * std::sin(m_time * 0.05f))
+		}
+	);
+	m_visibleObjects = owner.Engine().RenderQueue().SubmitVisible(world, m_camera);
+
 	// get engine performance statistics
 	engine::Engine::Statistics stats = owner.Engine().GetStatistics();
 	
-	// render text showing which state are we in
+	// keep the state label at the right edge. it is only rebuilt when the viewport width changed
 	float width = m_fontAtlas->GetWidth("State: LaunchState");
 	float height = m_fontAtlas->GetHeight();
 
-	std::unique_ptr<engine::command::graphics::renderer::DrawTextCommand> drawTextCmd =
-		std::make_unique<engine::command::graphics::renderer::DrawTextCommand>(
-			owner.Engine().Renderer(),
-			*m_fontAtlas,
-			"State: LaunchState",
-			spatial::PositionF
-			{
-				owner.Engine().GetViewPort().GetWidth() - width - 10.0f,
-				10
-			},
-			graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f }
-		);
-	owner.Engine().CommandQueue().Enqueue(std::move(drawTextCmd));
+	owner.Engine().RenderList().SetPosition(
+		m_stateLabel,
+		spatial::PositionF
+		{
+			owner.Engine().GetViewPort().GetWidth() - width - 10.0f,
+			10
+		}
+	);
 
 	std::string text = "State FPS: " +std::to_string(static_cast<int>(m_frameRateMonitor.GetAverageFrameRate()));
 	width = m_fontAtlas->GetWidth(text);
 
-	drawTextCmd =
-		std::make_unique<engine::command::graphics::renderer::DrawTextCommand>(
-			owner.Engine().Renderer(),
-			*m_fontAtlas,
-			text,
-			spatial::PositionF
-			{
-				owner.Engine().GetViewPort().GetWidth() - width - 10.0f,
-				40
-			},
-			graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f }
-		);
-	owner.Engine().CommandQueue().Enqueue(std::move(drawTextCmd));
+	owner.Engine().RenderQueue().SubmitText(
+		*m_fontAtlas,
+		text,
+		spatial::PositionF
+		{
+			owner.Engine().GetViewPort().GetWidth() - width - 10.0f,
+			40
+		},
+		graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f },
+		TextLayer
+	);
 
 	text = "Render FPS: " + std::to_string(static_cast<int>(stats.renderAverageFPS));
 	width = m_fontAtlas->GetWidth(text);
 
-	drawTextCmd =
-		std::make_unique<engine::command::graphics::renderer::DrawTextCommand>(
-			owner.Engine().Renderer(),
-			*m_fontAtlas,
-			text,
-			spatial::PositionF
-			{
-				owner.Engine().GetViewPort().GetWidth() - width - 10.0f,
-				70
-			},
-			graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f }
-		);
-	owner.Engine().CommandQueue().Enqueue(std::move(drawTextCmd));
+	owner.Engine().RenderQueue().SubmitText(
+		*m_fontAtlas,
+		text,
+		spatial::PositionF
+		{
+			owner.Engine().GetViewPort().GetWidth() - width - 10.0f,
+			70
+		},
+		graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f },
+		TextLayer
+	);
 
 	text = "Main Loop FPS: " + std::to_string(static_cast<int>(stats.mainLoopAverageFPS));
 	width = m_fontAtlas->GetWidth(text);
 
-	drawTextCmd =
-		std::make_unique<engine::command::graphics::renderer::DrawTextCommand>(
-			owner.Engine().Renderer(),
+	owner.Engine().RenderQueue().SubmitText(
+		*m_fontAtlas,
+		text,
+		spatial::PositionF
+		{
+			owner.Engine().GetViewPort().GetWidth() - width - 10.0f,
+			100
+		},
+		graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f },
+		TextLayer
+	);
+
+	// renderer counters of last frame. batch breaks and binds show how well draws are ordered by texture
+	const graphics::renderer::RenderStatistics& render = stats.render;
+	std::string renderLines[] =
+	{
+		"Instances: " + std::to_string(render.instances) + ", Draw Calls: " + std::to_string(render.drawCalls),
+		"Flushes (Texture/End): " + std::to_string(render.textureFlushes) + "/" + std::to_string(render.endFlushes),
+		"Binds (Taken/Skipped): " + std::to_string(render.bindsTaken) + "/" + std::to_string(render.bindsSkipped),
+		"Clip Changes: " + std::to_string(render.clipChanges) + ", Uploaded: " + std::to_string(render.bytesUploaded / 1024) + " KB",
+		"Retained (Kept/Uploaded): " + std::to_string(render.retainedDraws) + "/" + std::to_string(render.retainedUploads),
+		"World (Visible/Total): " + std::to_string(m_visibleObjects) + "/" + std::to_string(m_worldObjects.size()),
+	};
+
+	float y = 130;
+	for (const std::string& line : renderLines)
+	{
+		width = m_fontAtlas->GetWidth(line);
+		owner.Engine().RenderQueue().SubmitText(
 			*m_fontAtlas,
-			text,
+			line,
 			spatial::PositionF
 			{
 				owner.Engine().GetViewPort().GetWidth() - width - 10.0f,
-				100
+				y
 			},
-			graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f }
+			graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f },
+			TextLayer
 		);
-	owner.Engine().CommandQueue().Enqueue(std::move(drawTextCmd));
+		y += 30;
+	}
 }
 
 bool demo::LaunchState::IsFinished(Demo& owner)
@@ -2,7 +2,9 @@
 #include <state/State.h>
 #include <state/StateMachine.h>
 #include <Command/ICommand.h>
+#include <Graphics/Renderable/IDrawableSurface.h>
 #include <Performance/FrameRateMonitor.h>
+#include <Spatial/Camera.h>
 
 namespace demo
 {
@@ -27,9 +29,40 @@ namespace demo
 	class LaunchState : public state::State<Demo>
 	{
 	private:
+		// draw packet layers. effects over actors, statistics text over both
+		static constexpr uint8_t ActorLayer = 0;
+		static constexpr uint8_t EffectLayer = 1;
+		static constexpr uint8_t TextLayer = 2;
+
 		std::unique_ptr<graphics::renderable::IFontAtlas> m_fontAtlas;
 		performance::FrameRateMonitor m_frameRateMonitor;
 
+		// state label never changes, it is kept in engine's render list instead of being submitted every update
+		engine::command::RenderList::Handle m_stateLabel;
+
+		// background particles in viewport relative coordinates [0, 1). they are moved and recorded by jobs, each
+		// batch into the command buffer of the thread running it
+		struct Particle
+		{
+			spatial::PositionF pos;
+			spatial::PositionF velocity;
+		};
+		std::vector<Particle> m_particles;
+
+		// actors and effects live in engine's world index and wander around the world. camera pans over it, only
+		// what it sees is submitted
+		struct WorldObject
+		{
+			engine::command::RenderQueue::WorldIndex::Handle handle;
+			spatial::PositionF velocity;
+		};
+		std::unique_ptr<graphics::renderable::IDrawableSurface> m_actorSurface;
+		std::unique_ptr<graphics::renderable::IDrawableSurface> m_effectSurface;
+		std::vector<WorldObject> m_worldObjects;
+		spatial::CameraF m_camera;
+		float m_time = 0.0f;
+		size_t m_visibleObjects = 0;
+
 	public:
 		LaunchState();
 
@@ -543,18 +543,18 @@ namespace TestAsyncFileReader
 
 			math::geometry::RectF vp = owner.GetCanvas().GetViewPort();
 
-			owner.GetCommandQueue().Enqueue(
-				std::make_unique<engine::command::graphics::renderer::DrawTextCommand>(
-					owner.GetRenderer(),
-					owner.GetFontAtlas(),
-					"State: LaunchState",
-					spatial::PositionF
-					{
-						vp.GetWidth() - owner.GetFontAtlas().GetWidth("State: LaunchState") - 10.0f,
-						owner.GetFontAtlas().GetHeight()
-					},
-					graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f }
-				));
+			// recorded into the queue's frame arena, no allocation. literal outlives the command, no copy needed
+			owner.GetCommandQueue().Record<engine::command::graphics::renderer::DrawTextFrameCommand>(
+				owner.GetRenderer(),
+				owner.GetFontAtlas(),
+				"State: LaunchState",
+				spatial::PositionF
+				{
+					vp.GetWidth() - owner.GetFontAtlas().GetWidth("State: LaunchState") - 10.0f,
+					owner.GetFontAtlas().GetHeight()
+				},
+				graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f }
+			);
 
 		}
 		virtual bool IsFinished(TestAsyncFileReader::Test& owner) override
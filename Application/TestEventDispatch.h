@@ -0,0 +1,134 @@
+#pragma once
+#include <Core/Event.h>
+#include <Utilities/Logger.h>
+#include <list>
+#include <vector>
+#include <chrono>
+#include <memory>
+#include <iomanip>
+
+// microbenchmark of event dispatch. compares event::Event against the previous implementation
+// (std::list of heap allocated delegates, kept below as ListEvent) for a few subscriber counts.
+// reports nanoseconds per handler call. run a release build, debug numbers mean nothing
+namespace testEventDispatch
+{
+	// previous event::Event, reduced to what the benchmark uses
+	template<typename... Args>
+	class ListEvent
+	{
+	private:
+		std::list<event::IDelegate<void, Args...>*> m_subscribers;
+		std::list<typename std::list<event::IDelegate<void, Args...>*>::iterator> m_unsubscribers;
+
+	public:
+		~ListEvent()
+		{
+			for (event::IDelegate<void, Args...>* subscriber : m_subscribers)
+			{
+				delete subscriber;
+			}
+		}
+
+		void operator ()(const Args&... args)
+		{
+			for (event::IDelegate<void, Args...>* subscriber : m_subscribers)
+			{
+				if (subscriber && subscriber->IsActive())
+				{
+					(*subscriber)(args...);
+				}
+			}
+
+			for (auto it : m_unsubscribers)
+			{
+				delete* it;
+				m_subscribers.erase(it);
+			}
+			m_unsubscribers.clear();
+		}
+
+		template <typename C>
+		void Add(C* inst, void (C::* func)(Args...))
+		{
+			m_subscribers.push_back(new event::Delegate<void, C, Args...>(func, inst));
+		}
+	};
+
+	// stands in for an animator or pulse listener. work per call is tiny on purpose, dispatch cost dominates
+	struct Listener
+	{
+		float total = 0.0f;
+
+		void OnFrame(float delta)
+		{
+			total += delta;
+		}
+	};
+
+	class Test
+	{
+	private:
+		// fragmented: other allocations happen between subscriptions, as when actors spawn over several frames.
+		// list nodes and delegates then end up spread over the heap instead of back to back
+		template <typename E, typename Subscribe>
+		static double Measure(size_t subscribers, size_t invocations, std::vector<Listener>& listeners, bool fragmented, Subscribe subscribe)
+		{
+			std::vector<std::unique_ptr<char[]>> noise;
+			E evt;
+			for (size_t i = 0; i < subscribers; ++i)
+			{
+				subscribe(evt, listeners[i]);
+				if (fragmented)
+				{
+					noise.push_back(std::make_unique<char[]>(64 + (i * 37) % 512));
+				}
+			}
+
+			// warm up caches and branch predictors
+			for (size_t i = 0; i < 16; ++i)
+			{
+				evt(0.016f);
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			for (size_t i = 0; i < invocations; ++i)
+			{
+				evt(0.016f);
+			}
+			auto end = std::chrono::steady_clock::now();
+
+			double ns = std::chrono::duration<double, std::nano>(end - start).count();
+			return ns / (static_cast<double>(subscribers) * invocations);
+		}
+
+	public:
+		Test()
+		{
+			// same total number of handler calls for every row
+			const size_t totalCalls = 20000000;
+			const size_t counts[] = { 1, 8, 64, 1000, 10000 };
+
+			LOG("event dispatch, ns per handler call (list = previous implementation)");
+			for (size_t subscribers : counts)
+			{
+				std::vector<Listener> listeners(subscribers);
+				size_t invocations = totalCalls / subscribers;
+
+				for (bool fragmented : { false, true })
+				{
+					double list = Measure<ListEvent<float>>(subscribers, invocations, listeners, fragmented,
+						[](ListEvent<float>& evt, Listener& listener) { evt.Add(&listener, &Listener::OnFrame); });
+					double contiguous = Measure<event::Event<float>>(subscribers, invocations, listeners, fragmented,
+						[](event::Event<float>& evt, Listener& listener) { evt += event::Handler(&listener, &Listener::OnFrame); });
+					double ref = Measure<event::Event<float>>(subscribers, invocations, listeners, fragmented,
+						[](event::Event<float>& evt, Listener& listener) { evt += event::FunctionRef<void(float)>::Bind<&Listener::OnFrame>(&listener); });
+
+					LOG(std::setw(6) << subscribers << " subscribers" << (fragmented ? " (fragmented heap)" : "                  ")
+						<< ": list " << std::fixed << std::setprecision(2) << list
+						<< " ns, contiguous " << contiguous << " ns, function_ref " << ref
+						<< " ns, speedup " << list / contiguous << "x");
+				}
+			}
+		}
+	};
+}
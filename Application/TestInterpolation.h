@@ -0,0 +1,135 @@
+#pragma once
+#include <Command/CommandQueue.h>
+#include <Command/ICommand.h>
+#include <Timer/FixedTimestep.h>
+#include <Utilities/Logger.h>
+#include <cmath>
+#include <string>
+
+// checks of interpolated render commands that do not need a window. a quad moves 10 units per simulation step and is
+// recorded once per step, render frames run ten times as often. each check logs PASS or FAIL with the values it compared
+namespace testInterpolation
+{
+	// renderer that only remembers where quads were drawn
+	class Renderer : public graphics::renderer::IRenderer
+	{
+	public:
+		int draws = 0;
+		float lastX = 0.0f;
+
+		std::string GetTypeName() const override { return "Interpolation Test"; }
+		void ShutDown() override {}
+		bool Initialize() override { return true; }
+		void Begin() override {}
+		void End() override {}
+		void SetClipRegion(const math::geometry::RectF& region) override {}
+		void EnableClipping(const bool enable) override {}
+
+		void Draw(const spatial::PositionF pos, const spatial::SizeF size, const graphics::ColorF color, const float rotation) override
+		{
+			++draws;
+			lastX = pos.x;
+		}
+
+		void DrawText(const graphics::renderable::IFontAtlas& font, std::string_view text, const spatial::PositionF pos, const graphics::ColorF color) override {}
+		void DrawChar(const graphics::renderable::IFontAtlas& font, const unsigned char character, const spatial::PositionF pos, const graphics::ColorF color, const float rotation) override {}
+		void DrawRenderable(const graphics::renderable::IRenderable& renderable, const spatial::PositionF pos, const spatial::SizeF size, const graphics::ColorF color, const float rotation) override {}
+	};
+
+	class Test
+	{
+	private:
+		static constexpr float StepRate = 60.0f;
+		static constexpr int FramesPerStep = 10;
+		static constexpr float Speed = 10.0f;	// units per step
+
+		timer::FixedTimestep m_simulation;
+		engine::command::CommandQueue m_queue;
+		Renderer m_renderer;
+
+		// what engine hands render commands as RenderAlpha
+		float m_renderAlpha = 1.0f;
+
+		float m_previousX = 0.0f;
+		float m_x = 0.0f;
+		int m_steps = 0;
+		int m_failed = 0;
+
+		void Check(const std::string& name, bool passed, const std::string& detail)
+		{
+			LOG((passed ? "[PASS] " : "[FAIL] ") << name << " - " << detail);
+			if (!passed)
+			{
+				++m_failed;
+			}
+		}
+
+		// one command per step, the one of the previous step is cleared
+		void Step(float step)
+		{
+			m_previousX = m_x;
+			m_x += Speed;
+			++m_steps;
+
+			m_queue.Clear(engine::command::Type::Render);
+			m_queue.Enqueue(std::make_unique<engine::command::graphics::renderer::DrawInterpolatedQuadCommand>(
+				m_renderer,
+				m_renderAlpha,
+				spatial::PositionF{ m_previousX, 0.0f },
+				spatial::PositionF{ m_x, 0.0f },
+				spatial::SizeF{ 1.0f, 1.0f },
+				graphics::ColorF{ 1.0f, 1.0f, 1.0f, 1.0f },
+				0.0f,
+				0.0f));
+		}
+
+	public:
+		Test() :
+			m_simulation(StepRate)
+		{
+			m_simulation.StepEvent += event::Handler(this, &Test::Step);
+
+			const int frames = 20 * FramesPerStep;
+			int drawnFrames = 0;
+			int steadyFrames = 0;	// frames that drew further along than the frame before
+			int framesSinceStep = 0;
+			float previousDrawn = -1.0f;
+			int stepsBefore = 0;
+			int maxFramesPerStep = 0;
+
+			for (int frame = 0; frame < frames; ++frame)
+			{
+				// same order as engine: simulation first, then a render frame with the alpha that is left
+				m_simulation.Update(1.0f / (StepRate * FramesPerStep));
+				m_renderAlpha = m_simulation.GetAlpha();
+
+				int drawsBefore = m_renderer.draws;
+				m_queue.Dispatch(engine::command::Type::Render, false);
+				if (m_renderer.draws == drawsBefore + 1)
+				{
+					++drawnFrames;
+					if (m_renderer.lastX > previousDrawn)
+					{
+						++steadyFrames;
+					}
+					previousDrawn = m_renderer.lastX;
+				}
+
+				framesSinceStep = m_steps != stepsBefore ? 1 : framesSinceStep + 1;
+				stepsBefore = m_steps;
+				maxFramesPerStep = framesSinceStep > maxFramesPerStep ? framesSinceStep : maxFramesPerStep;
+			}
+
+			// frames before the first step have nothing to draw yet
+			const int expected = frames - (FramesPerStep - 1);
+			Check("interpolated command drawn every frame", drawnFrames >= expected - 1,
+				"drawn in " + std::to_string(drawnFrames) + " of " + std::to_string(frames) + " frames over " + std::to_string(m_steps) + " steps");
+			Check("interpolated command moves every frame", steadyFrames >= drawnFrames - 1,
+				std::to_string(steadyFrames) + " of " + std::to_string(drawnFrames) + " frames moved on, up to " + std::to_string(maxFramesPerStep) + " frames per step");
+			Check("interpolated command lags one step behind", std::fabs(m_renderer.lastX - (m_x - Speed + Speed * m_renderAlpha)) < 0.001f,
+				"drawn at " + std::to_string(m_renderer.lastX) + ", simulation at " + std::to_string(m_x));
+
+			LOG("interpolation checks done, " << m_failed << " failed");
+		}
+	};
+}
@@ -58,7 +58,7 @@ namespace TestLargeMap
 		std::unique_ptr<graphics::renderable::ISpriteAtlas> m_spriteAtlas;
 		timer::StopWatch m_stopwatch;
 		component::tile::Tileset<RenderableTile> m_tileset;
-		component::tile::TileGrid<RenderableTile> m_tilegrid;
+		std::unique_ptr<component::tile::TileLayer<RenderableTile>> m_tileLayer;
 		spatial::SizeF m_tileSize{ 32.0f, 32.0f };
 		spatial::CameraF m_camera;
 		spatial::PositionF m_lastMousePos;
@@ -169,21 +169,22 @@ namespace TestLargeMap
 			m_tileset.Register(0, std::make_unique<RenderableTile>(m_spriteAtlas->MakeSprite(0), true)); // walkable
 			m_tileset.Register(1, std::make_unique<RenderableTile>(m_spriteAtlas->MakeSprite(1), false)); // obstacle
 
-			// load map into tile layer
-			m_tilegrid = utilities::io::TileGridLoader<RenderableTile, int>::LoadFromCSV(
+			// load map into tile layer. map is split into 16x16 regions, each region caches its own render list
+			m_tileLayer = std::make_unique<component::tile::TileLayer<RenderableTile>>(utilities::io::TileLayerLoader<RenderableTile, int>::LoadFromCSV(
 				"../Assets/32x32Map.csv",
 				m_tileset,
 				[](int row, int col, const int& cell, const component::tile::Tileset<RenderableTile>& tileset) -> component::tile::Tile<RenderableTile>
 				{
 					// this is safe. tileset will return "empty" tile if id is invalid. "empty" means does not have reference to tile data. tile is invalid
 					return tileset.MakeTile(cell);
-				}
-			);
+				},
+				{ 16, 16 }
+			));
 
 			// tell camera the size of the world. this will be the tile map
 			m_camera.SetWorldSize(
-				m_tilegrid.GetWidth() * m_tileSize.width,
-				m_tilegrid.GetHeight() * m_tileSize.height
+				m_tileLayer->GetSize().width * m_tileLayer->GetRegionSize().width * m_tileSize.width,
+				m_tileLayer->GetSize().height * m_tileLayer->GetRegionSize().height * m_tileSize.height
 			);
 
 			// setup stopwatch to manage timing and start it
@@ -215,10 +216,10 @@ namespace TestLargeMap
 				m_renderer->Begin();
 				{
 					m_renderer->EnableClipping(false);
-					RenderTiles(m_tilegrid, 0.3f);
+					RenderTiles(*m_tileLayer, 0.3f);
 
 					m_renderer->EnableClipping(true);
-					RenderTiles(m_tilegrid);
+					RenderTiles(*m_tileLayer);
 
 					m_renderer->EnableClipping(false);
 
@@ -273,42 +274,45 @@ namespace TestLargeMap
 			m_canvas->SetViewPort();
 		}
 
-		void RenderTiles(component::tile::TileGrid<RenderableTile>& tilegrid, float alpha = 1.0f)
+		// draws visible regions. each region is drawn from its cached render list, so cost is per region instead of per tile
+		void RenderTiles(const component::tile::TileLayer<RenderableTile>& layer, float alpha = 1.0f)
 		{
 			math::geometry::RectF vp = m_camera.GetViewport();
 			spatial::PositionF camPos = m_camera.GetPosition();
 
-			int left = (int)(camPos.x / m_tileSize.width);
-			int top = (int)(camPos.y / m_tileSize.height);
-			int right = (int)((camPos.x + vp.GetWidth()) / m_tileSize.width);
-			int bottom = (int)((camPos.y + vp.GetHeight()) / m_tileSize.height);
+			// region size in world units
+			float regionWidth = layer.GetRegionSize().width * m_tileSize.width;
+			float regionHeight = layer.GetRegionSize().height * m_tileSize.height;
+
+			int left = (int)(camPos.x / regionWidth);
+			int top = (int)(camPos.y / regionHeight);
+			int right = (int)((camPos.x + vp.GetWidth()) / regionWidth);
+			int bottom = (int)((camPos.y + vp.GetHeight()) / regionHeight);
 
 			for (int row = top; row <= bottom; ++row)
 			{
 				for (int col = left; col <= right; ++col)
 				{
-					if (!tilegrid.IsInBounds(row, col))
+					if (!layer.IsInBounds(row, col))
 					{
 						continue;
 					}
 
-					const component::tile::Tile<RenderableTile>& tile = tilegrid.GetTile(row, col);
-					if (tile.isValid())
-					{
-						spatial::PositionF pos =
+					const component::tile::TileRenderList& renderList = layer.GetRegion(row, col).GetRenderList(
+						m_tileSize,
+						[](const RenderableTile& tile) -> const graphics::renderable::IRenderable*
 						{
-							col * m_tileSize.width,
-							row * m_tileSize.height
-						};
-
-						m_renderer->DrawRenderable(
-							tile->GetSprite(),
-							m_camera.WorldToScreen(pos),
- 							m_tileSize,
-							graphics::ColorF{ 1.0f, 1.0f, 1.0f, alpha },
-							0.0f
-						);
-					}
+							return &tile.GetSprite();
+						}
+					);
+
+					spatial::PositionF pos =
+					{
+						col * regionWidth,
+						row * regionHeight
+					};
+
+					renderList.Draw(*m_renderer, m_camera.WorldToScreen(pos), graphics::ColorF{ 1.0f, 1.0f, 1.0f, alpha });
 				}
 			}
 		}
@@ -0,0 +1,105 @@
+#pragma once
+#include <Timer/Scheduler.h>
+#include <Utilities/Logger.h>
+#include <cmath>
+#include <string>
+
+// checks of timer::Scheduler that do not need a window. each check logs PASS or FAIL with the values it compared
+namespace testScheduler
+{
+	struct Listener
+	{
+		int fired = 0;
+		double firstFiredAt = -1.0;
+		const double* now = nullptr;
+
+		void OnFire(float)
+		{
+			if (fired++ == 0)
+			{
+				firstFiredAt = *now;
+			}
+		}
+	};
+
+	class Test
+	{
+	private:
+		int m_failed = 0;
+
+		void Check(const std::string& name, bool passed, const std::string& detail)
+		{
+			LOG((passed ? "[PASS] " : "[FAIL] ") << name << " - " << detail);
+			if (!passed)
+			{
+				++m_failed;
+			}
+		}
+
+		// steps scheduler in 1 ms updates until listener fired or limit is reached
+		static void RunUntilFired(timer::Scheduler& scheduler, Listener& listener, double& now, double limit)
+		{
+			while (listener.fired == 0 && now < limit)
+			{
+				now += 0.001;
+				scheduler.Update(0.001f);
+			}
+		}
+
+		// schedule parked on level 1 is due before a later one added to level 0. next trigger must be the level 1 one
+		void MixedLevels()
+		{
+			double now = 0.0;
+			timer::Scheduler scheduler(0.001f);
+			Listener early{ 0, -1.0, &now };
+			Listener late{ 0, -1.0, &now };
+
+			scheduler += timer::Schedule(0.26f, &early, &Listener::OnFire);
+			scheduler.Update(0.2f);
+			now = 0.2;
+			scheduler += timer::Schedule(0.25f, &late, &Listener::OnFire);
+
+			float until = scheduler.GetTimeUntilNextTrigger();
+			Check("mixed levels, time until next trigger", std::fabs(until - 0.06f) < 0.002f,
+				"expected 0.060, got " + std::to_string(until));
+
+			RunUntilFired(scheduler, early, now, 1.0);
+			Check("mixed levels, earlier schedule fires first", early.fired == 1 && late.fired == 0 && std::fabs(early.firstFiredAt - 0.26) < 0.002,
+				"fired at " + std::to_string(early.firstFiredAt) + ", later schedule fired " + std::to_string(late.fired) + " times");
+		}
+
+		// schedule added on level 2 is not cascaded yet when a later one is added to level 1
+		void FarLevels()
+		{
+			double now = 0.0;
+			timer::Scheduler scheduler(0.001f);
+			Listener early{ 0, -1.0, &now };
+			Listener late{ 0, -1.0, &now };
+
+			scheduler += timer::Schedule(65.6f, &early, &Listener::OnFire);
+			scheduler.Update(65.5f);
+			now = 65.5;
+			scheduler += timer::Schedule(0.3f, &late, &Listener::OnFire);
+
+			float until = scheduler.GetTimeUntilNextTrigger();
+			Check("far levels, time until next trigger", std::fabs(until - 0.1f) < 0.002f,
+				"expected 0.100, got " + std::to_string(until));
+		}
+
+		void Empty()
+		{
+			timer::Scheduler scheduler(0.001f);
+			Check("empty scheduler", std::isinf(scheduler.GetTimeUntilNextTrigger()), "expected infinity");
+		}
+
+	public:
+		Test()
+		{
+			MixedLevels();
+			FarLevels();
+			Empty();
+
+			LOG("scheduler checks done, " << m_failed << " failed");
+		}
+	};
+}
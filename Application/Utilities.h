@@ -58,10 +58,27 @@ namespace utilities
 			static component::tile::TileLayer<T> LoadFromCSV(
 				const std::string& filename,
 				const component::tile::Tileset<T>& tileset,
-				std::function<component::tile::Tile<T>(int, int, const U&, const component::tile::Tileset<T>&)> tileLoader
+				std::function<component::tile::Tile<T>(int, int, const U&, const component::tile::Tileset<T>&)> tileLoader,
+				spatial::Size<int> regionSize
 			)
 			{
+				// same source as TileGridLoader. tiles are then split into regions
+				component::tile::TileGrid<T> grid = TileGridLoader<T, U>::LoadFromCSV(filename, tileset, tileLoader);
+
+				// partial regions at right and bottom are padded with invalid tiles
+				int rows = (grid.GetHeight() + regionSize.height - 1) / regionSize.height;
+				int cols = (grid.GetWidth() + regionSize.width - 1) / regionSize.width;
+
+				component::tile::TileLayer<T> layer(rows, cols, regionSize);
+				for (int row = 0; row < grid.GetHeight(); ++row)
+				{
+					for (int col = 0; col < grid.GetWidth(); ++col)
+					{
+						layer.SetTile(row, col, grid.GetTile(row, col));
+					}
+				}
 
+				return layer;
 			}
 		};
 	}
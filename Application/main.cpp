@@ -10,6 +10,9 @@
 #include "TestAsyncFileReader.h"
 #include "Demo.h"
 #include "TestFrameRate.h"
+#include "TestEventDispatch.h"
+#include "TestScheduler.h"
+#include "TestInterpolation.h"
 
 int main()
 {
@@ -25,6 +28,9 @@ int main()
 	//TestAsyncFileReader::Test testAsyncFileReader;
 	demo::Demo demoInstance;
 	//testFrameRate::Test::Instance().Run();
+	//testEventDispatch::Test testEventDispatch;
+	//testScheduler::Test testScheduler;
+	//testInterpolation::Test testInterpolation;
 
 
 	return 0;
@@ -0,0 +1,467 @@
+// offline atlas packer. packs sprite sheets and frame folders into a few large pages and writes a cooked
+// atlas file that CookedAtlasLoader reads at runtime.
+//
+// usage:
+//	AtlasPacker -out <file.atlas> [-size <page size>] [-padding <pixels>] <input> [<input> ...]
+//
+// inputs:
+//	-	a png file is one entry named after the file (without extension). its frames are found in this order:
+//		-	a csv with the same name next to it, holding normalized left, top, right, bottom per row (same format
+//			SpriteAtlasLoader reads)
+//		-	name ending with _<w>x<h>_<n>f (e.g. explode0_128x128_16f) is a grid of n frames of w x h, row major
+//		-	otherwise the whole image is one frame
+//	-	a folder is one entry named after the folder. every png in it and in its subfolders adds its frames, folder
+//		by folder in path order, so an actor with hundreds of separate frame files in one folder per animation ends
+//		up as one entry on one page. its animations stay addressable: every subfolder and every png is an entry of
+//		its own too, named by its path relative to the input with / between parts (e.g. isometric_Mini-Crusader/attack
+//		and isometric_Mini-Crusader/attack/crusader_attack_00000). they cover a part of the folder's frames
+//
+// output:
+//	<file.atlas> and <file>_<page>.png for every page, next to each other
+
+#include <Graphics/IO/AtlasPacker.h>
+#include <Graphics/IO/CookedAtlasFile.h>
+#include <Utilities/CSVFile.h>
+#include <Utilities/Logger.h>
+#include <Windows.h>
+#include <wincodec.h>
+#include <wrl/client.h>
+#include <filesystem>
+#include <algorithm>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+using Microsoft::WRL::ComPtr;
+namespace atlas = graphics::imageio::atlas;
+
+namespace
+{
+	struct Image
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<uint32_t> pixels;	// RGBA, top-down
+	};
+
+	struct Frame
+	{
+		size_t image;	// index into images
+		atlas::PackRect source;
+	};
+
+	// named part of an entry's frames, e.g. one animation folder
+	struct Range
+	{
+		std::string name;
+		size_t first = 0;
+		size_t count = 0;
+	};
+
+	struct Entry
+	{
+		std::string name;
+		std::vector<Frame> frames;
+		std::vector<Range> ranges;
+		size_t group = 0;
+	};
+
+	struct Options
+	{
+		std::filesystem::path output;
+		uint32_t pageSize = 2048;
+		uint32_t padding = 2;
+		std::vector<std::filesystem::path> inputs;
+	};
+
+	bool LoadPng(IWICImagingFactory* factory, const std::filesystem::path& filename, Image& image)
+	{
+		ComPtr<IWICBitmapDecoder> decoder;
+		HRESULT hr = factory->CreateDecoderFromFilename(filename.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, &decoder);
+		if (FAILED(hr)) return false;
+
+		ComPtr<IWICBitmapFrameDecode> frame;
+		hr = decoder->GetFrame(0, &frame);
+		if (FAILED(hr)) return false;
+
+		ComPtr<IWICFormatConverter> converter;
+		hr = factory->CreateFormatConverter(&converter);
+		if (FAILED(hr)) return false;
+
+		hr = converter->Initialize(frame.Get(), GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0f, WICBitmapPaletteTypeCustom);
+		if (FAILED(hr)) return false;
+
+		UINT width, height;
+		hr = converter->GetSize(&width, &height);
+		if (FAILED(hr)) return false;
+
+		image.width = width;
+		image.height = height;
+		image.pixels.resize(static_cast<size_t>(width) * height);
+		hr = converter->CopyPixels(nullptr, width * 4, static_cast<UINT>(image.pixels.size() * 4), reinterpret_cast<BYTE*>(image.pixels.data()));
+		return SUCCEEDED(hr);
+	}
+
+	bool SavePng(IWICImagingFactory* factory, const std::filesystem::path& filename, const Image& image)
+	{
+		ComPtr<IWICBitmap> bitmap;
+		HRESULT hr = factory->CreateBitmapFromMemory(
+			image.width,
+			image.height,
+			GUID_WICPixelFormat32bppRGBA,
+			image.width * 4,
+			static_cast<UINT>(image.pixels.size() * 4),
+			reinterpret_cast<BYTE*>(const_cast<uint32_t*>(image.pixels.data())),
+			&bitmap);
+		if (FAILED(hr)) return false;
+
+		ComPtr<IWICStream> stream;
+		hr = factory->CreateStream(&stream);
+		if (FAILED(hr)) return false;
+
+		hr = stream->InitializeFromFilename(filename.c_str(), GENERIC_WRITE);
+		if (FAILED(hr)) return false;
+
+		ComPtr<IWICBitmapEncoder> encoder;
+		hr = factory->CreateEncoder(GUID_ContainerFormatPng, nullptr, &encoder);
+		if (FAILED(hr)) return false;
+
+		hr = encoder->Initialize(stream.Get(), WICBitmapEncoderNoCache);
+		if (FAILED(hr)) return false;
+
+		ComPtr<IWICBitmapFrameEncode> frame;
+		ComPtr<IPropertyBag2> props;
+		hr = encoder->CreateNewFrame(&frame, &props);
+		if (FAILED(hr)) return false;
+
+		hr = frame->Initialize(props.Get());
+		if (FAILED(hr)) return false;
+
+		hr = frame->SetSize(image.width, image.height);
+		if (FAILED(hr)) return false;
+
+		// encoder may pick another format. WriteSource converts for us in that case
+		WICPixelFormatGUID format = GUID_WICPixelFormat32bppRGBA;
+		hr = frame->SetPixelFormat(&format);
+		if (FAILED(hr)) return false;
+
+		hr = frame->WriteSource(bitmap.Get(), nullptr);
+		if (FAILED(hr)) return false;
+
+		hr = frame->Commit();
+		if (FAILED(hr)) return false;
+
+		return SUCCEEDED(encoder->Commit());
+	}
+
+	// finds frame rects of one source image, see usage at the top
+	std::vector<atlas::PackRect> FindFrames(const std::filesystem::path& filename, const Image& image)
+	{
+		std::vector<atlas::PackRect> frames;
+
+		std::filesystem::path csv = filename;
+		csv.replace_extension(".csv");
+		if (std::filesystem::exists(csv))
+		{
+			utilities::fileio::CSVFile csvFile(csv.string(), ',');
+			if (csvFile.read())
+			{
+				for (size_t row = 0; row < csvFile.GetRowCount(); ++row)
+				{
+					int r = static_cast<int>(row);
+					float left = csvFile.GetValue<float>(r, 0) * image.width;
+					float top = csvFile.GetValue<float>(r, 1) * image.height;
+					float right = csvFile.GetValue<float>(r, 2) * image.width;
+					float bottom = csvFile.GetValue<float>(r, 3) * image.height;
+
+					uint32_t x = static_cast<uint32_t>(std::lround(left));
+					uint32_t y = static_cast<uint32_t>(std::lround(top));
+					uint32_t w = static_cast<uint32_t>(std::lround(right)) - x;
+					uint32_t h = static_cast<uint32_t>(std::lround(bottom)) - y;
+					frames.push_back({ x, y, w, h });
+				}
+				return frames;
+			}
+		}
+
+		std::smatch match;
+		std::string stem = filename.stem().string();
+		static const std::regex grid(".*_([0-9]+)x([0-9]+)_([0-9]+)f$");
+		if (std::regex_match(stem, match, grid))
+		{
+			uint32_t w = static_cast<uint32_t>(std::stoul(match[1]));
+			uint32_t h = static_cast<uint32_t>(std::stoul(match[2]));
+			uint32_t count = static_cast<uint32_t>(std::stoul(match[3]));
+			uint32_t columns = w > 0 ? image.width / w : 0;
+
+			for (uint32_t i = 0; columns > 0 && i < count; ++i)
+			{
+				uint32_t x = (i % columns) * w;
+				uint32_t y = (i / columns) * h;
+				if (y + h > image.height)
+				{
+					LOGERROR(filename.string() << " has fewer frames than its name says. Using " << i << ".");
+					break;
+				}
+				frames.push_back({ x, y, w, h });
+			}
+			return frames;
+		}
+
+		frames.push_back({ 0, 0, image.width, image.height });
+		return frames;
+	}
+
+	// copies a frame into the page and repeats its edge pixels into the padding around it
+	void Blit(const Image& source, const atlas::PackRect& from, Image& page, const atlas::PackRect& to, uint32_t padding)
+	{
+		auto sample = [&source, &from](int64_t x, int64_t y)
+			{
+				x = std::clamp<int64_t>(x, 0, static_cast<int64_t>(from.width) - 1);
+				y = std::clamp<int64_t>(y, 0, static_cast<int64_t>(from.height) - 1);
+				return source.pixels[(from.y + y) * source.width + (from.x + x)];
+			};
+
+		const int64_t pad = static_cast<int64_t>(padding);
+		for (int64_t y = -pad; y < static_cast<int64_t>(to.height) + pad; ++y)
+		{
+			for (int64_t x = -pad; x < static_cast<int64_t>(to.width) + pad; ++x)
+			{
+				page.pixels[(to.y + y) * page.width + (to.x + x)] = sample(x, y);
+			}
+		}
+	}
+
+	bool ParseArguments(int argc, char* argv[], Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			if (arg == "-out" && i + 1 < argc)
+			{
+				options.output = argv[++i];
+			}
+			else if (arg == "-size" && i + 1 < argc)
+			{
+				options.pageSize = static_cast<uint32_t>(std::stoul(argv[++i]));
+			}
+			else if (arg == "-padding" && i + 1 < argc)
+			{
+				options.padding = static_cast<uint32_t>(std::stoul(argv[++i]));
+			}
+			else
+			{
+				options.inputs.push_back(arg);
+			}
+		}
+
+		return !options.output.empty() && !options.inputs.empty() && options.pageSize > 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!ParseArguments(argc, argv, options))
+	{
+		std::cout << "usage: AtlasPacker -out <file.atlas> [-size <page size>] [-padding <pixels>] <png or folder> ..." << std::endl;
+		return 1;
+	}
+
+	HRESULT hr = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+	if (FAILED(hr))
+	{
+		LOGERROR("Failed to initialize COM.");
+		return 1;
+	}
+
+	int result = 1;
+	{
+		ComPtr<IWICImagingFactory> factory;
+		hr = CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory));
+		if (FAILED(hr))
+		{
+			LOGERROR("Failed to create WIC factory.");
+			CoUninitialize();
+			return 1;
+		}
+
+		std::vector<Image> images;
+		std::vector<Entry> entries;
+
+		auto addImage = [&](const std::filesystem::path& filename, Entry& entry) -> bool
+			{
+				Image image;
+				if (!LoadPng(factory.Get(), filename, image))
+				{
+					LOGERROR("Failed to load " << filename.string());
+					return false;
+				}
+
+				for (const atlas::PackRect& rect : FindFrames(filename, image))
+				{
+					if (rect.width == 0 || rect.height == 0 || rect.x + rect.width > image.width || rect.y + rect.height > image.height)
+					{
+						LOGERROR(filename.string() << " has a frame outside of the image. Skipped.");
+						continue;
+					}
+					entry.frames.push_back({ images.size(), rect });
+				}
+
+				images.push_back(std::move(image));
+				return true;
+			};
+
+		bool ok = true;
+		for (const std::filesystem::path& input : options.inputs)
+		{
+			Entry entry;
+			if (std::filesystem::is_directory(input))
+			{
+				entry.name = input.filename().string();
+
+				std::vector<std::filesystem::path> files;
+				for (const auto& file : std::filesystem::recursive_directory_iterator(input))
+				{
+					if (file.is_regular_file() && file.path().extension() == ".png")
+					{
+						files.push_back(file.path().lexically_relative(input));
+					}
+				}
+
+				// folder by folder, so the frames of every folder are one run. iteration order is unspecified
+				std::sort(files.begin(), files.end(), [](const std::filesystem::path& a, const std::filesystem::path& b)
+					{
+						return a.parent_path() != b.parent_path() ? a.parent_path() < b.parent_path() : a.filename() < b.filename();
+					});
+
+				// frames of a subfolder follow each other, its range grows with every file in it
+				Range folder;
+				for (const std::filesystem::path& file : files)
+				{
+					if (file.parent_path().generic_string() != folder.name)
+					{
+						if (!folder.name.empty())
+						{
+							entry.ranges.push_back({ entry.name + "/" + folder.name, folder.first, folder.count });
+						}
+						folder = { file.parent_path().generic_string(), entry.frames.size(), 0 };
+					}
+
+					size_t first = entry.frames.size();
+					ok = addImage(input / file, entry) && ok;
+					folder.count += entry.frames.size() - first;
+
+					std::filesystem::path name = file;
+					name.replace_extension();
+					entry.ranges.push_back({ entry.name + "/" + name.generic_string(), first, entry.frames.size() - first });
+				}
+				if (!folder.name.empty())
+				{
+					entry.ranges.push_back({ entry.name + "/" + folder.name, folder.first, folder.count });
+				}
+			}
+			else
+			{
+				entry.name = input.stem().string();
+				ok = addImage(input, entry) && ok;
+			}
+
+			if (entry.frames.empty())
+			{
+				LOGERROR("No frames found in " << input.string());
+				ok = false;
+				continue;
+			}
+			entries.push_back(std::move(entry));
+		}
+
+		// pack. every entry is a group so all of its frames share one page
+		atlas::AtlasPacker packer(options.pageSize, options.pageSize, options.padding);
+		for (Entry& entry : entries)
+		{
+			std::vector<atlas::AtlasPacker::Size> sizes;
+			for (const Frame& frame : entry.frames)
+			{
+				sizes.push_back({ frame.source.width, frame.source.height });
+			}
+			entry.group = packer.AddGroup(sizes);
+		}
+
+		if (ok && packer.Pack())
+		{
+			std::vector<Image> pages(packer.GetPageCount());
+			atlas::CookedAtlas cooked;
+			cooked.pages.resize(pages.size());
+
+			for (size_t i = 0; i < pages.size(); ++i)
+			{
+				pages[i].width = options.pageSize;
+				pages[i].height = options.pageSize;
+				pages[i].pixels.assign(static_cast<size_t>(options.pageSize) * options.pageSize, 0);
+
+				std::filesystem::path pageFile = options.output;
+				pageFile.replace_filename(options.output.stem().string() + "_" + std::to_string(i) + ".png");
+				cooked.pages[i].image = pageFile.filename().string();
+				cooked.pages[i].width = options.pageSize;
+				cooked.pages[i].height = options.pageSize;
+			}
+
+			for (const Entry& entry : entries)
+			{
+				uint32_t page = packer.GetGroupPage(entry.group);
+				const std::vector<atlas::PackRect>& placed = packer.GetGroupRects(entry.group);
+				atlas::CookedAtlas::Page& cookedPage = cooked.pages[page];
+
+				const uint32_t first = static_cast<uint32_t>(cookedPage.uvs.size());
+				cooked.entries.push_back({ entry.name, page, first, static_cast<uint32_t>(entry.frames.size()) });
+				for (const Range& range : entry.ranges)
+				{
+					if (range.count > 0)
+					{
+						cooked.entries.push_back({ range.name, page, first + static_cast<uint32_t>(range.first), static_cast<uint32_t>(range.count) });
+					}
+				}
+
+				for (size_t i = 0; i < entry.frames.size(); ++i)
+				{
+					const atlas::PackRect& to = placed[i];
+					Blit(images[entry.frames[i].image], entry.frames[i].source, pages[page], to, options.padding);
+
+					float w = static_cast<float>(cookedPage.width);
+					float h = static_cast<float>(cookedPage.height);
+					cookedPage.uvs.push_back({ to.x / w, to.y / h, (to.x + to.width) / w, (to.y + to.height) / h });
+				}
+			}
+
+			result = 0;
+			for (size_t i = 0; i < pages.size(); ++i)
+			{
+				std::filesystem::path pageFile = options.output.parent_path() / cooked.pages[i].image;
+				if (!SavePng(factory.Get(), pageFile, pages[i]))
+				{
+					LOGERROR("Failed to save " << pageFile.string());
+					result = 1;
+				}
+				LOG("Page " << i << ": " << cooked.pages[i].image << " occupancy " << (packer.GetPage(i).GetOccupancy() * 100.0f) << "%");
+			}
+
+			if (result == 0 && !cooked.SaveToFile(options.output.string()))
+			{
+				result = 1;
+			}
+
+			if (result == 0)
+			{
+				LOG("Packed " << entries.size() << " entries into " << pages.size() << " pages: " << options.output.string());
+			}
+		}
+	}
+
+	CoUninitialize();
+	return result;
+}
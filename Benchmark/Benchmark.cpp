@@ -0,0 +1,250 @@
+#include "Benchmark.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+namespace
+{
+	struct Case
+	{
+		std::string name;
+		benchmark::Function function;
+	};
+
+	// function local so registrars in other translation units can run before this one is initialized
+	std::vector<Case>& Cases()
+	{
+		static std::vector<Case> cases;
+		return cases;
+	}
+
+	// reads the value after "key": in text starting at from. strings come back without quotes
+	bool FindValue(const std::string& text, const std::string& key, std::string& value)
+	{
+		size_t pos = text.find("\"" + key + "\"");
+		if (pos == std::string::npos)
+		{
+			return false;
+		}
+		pos = text.find(':', pos);
+		if (pos == std::string::npos)
+		{
+			return false;
+		}
+		pos = text.find_first_not_of(" \t\r\n", pos + 1);
+		if (pos == std::string::npos)
+		{
+			return false;
+		}
+
+		if (text[pos] == '"')
+		{
+			size_t end = text.find('"', pos + 1);
+			if (end == std::string::npos)
+			{
+				return false;
+			}
+			value = text.substr(pos + 1, end - pos - 1);
+			return true;
+		}
+
+		size_t end = text.find_first_of(",}\r\n", pos);
+		value = text.substr(pos, end - pos);
+		return true;
+	}
+}
+
+void benchmark::State::Report(uint64_t iterations, std::vector<double>& samples)
+{
+	std::sort(samples.begin(), samples.end());
+
+	m_result.iterations = iterations;
+	m_result.repetitions = samples.size();
+	m_result.minNsPerOp = samples.front();
+	m_result.maxNsPerOp = samples.back();
+	m_result.nsPerOp = samples.size() % 2 == 1 ?
+		samples[samples.size() / 2] :
+		(samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) / 2.0;
+}
+
+benchmark::Registrar::Registrar(const char* name, Function function)
+{
+	Cases().push_back({ name, function });
+}
+
+std::vector<benchmark::Result> benchmark::RunAll(const Options& options, size_t& failures)
+{
+	std::vector<Result> results;
+	failures = 0;
+	for (const Case& c : Cases())
+	{
+		if (!options.filter.empty() && c.name.find(options.filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		Result result;
+		result.name = c.name;
+		State state(options, result);
+		c.function(state);
+
+		if (!result.error.empty())
+		{
+			std::cerr << c.name << ": check failed: " << result.error << std::endl;
+			++failures;
+			continue;
+		}
+
+		if (result.repetitions == 0)
+		{
+			std::cerr << c.name << ": case did not call Run, skipped" << std::endl;
+			continue;
+		}
+
+		std::cout << std::left << std::setw(40) << result.name << std::right
+			<< std::fixed << std::setprecision(1) << std::setw(14) << result.nsPerOp << " ns/op"
+			<< std::setw(12) << result.NsPerItem() << " ns/item"
+			<< "  (" << result.iterations << " x " << result.repetitions << ", min " << result.minNsPerOp << ", max " << result.maxNsPerOp << ")"
+			<< std::endl;
+
+		results.push_back(result);
+	}
+	return results;
+}
+
+std::vector<std::string> benchmark::List()
+{
+	std::vector<std::string> names;
+	for (const Case& c : Cases())
+	{
+		names.push_back(c.name);
+	}
+	return names;
+}
+
+std::string benchmark::ToJson(const std::vector<Result>& results)
+{
+	std::ostringstream out;
+	out << std::setprecision(6) << std::fixed;
+	out << "{\n\t\"benchmarks\": [";
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const Result& result = results[i];
+		out << (i == 0 ? "\n" : ",\n")
+			<< "\t\t{ \"name\": \"" << result.name << "\""
+			<< ", \"iterations\": " << result.iterations
+			<< ", \"repetitions\": " << result.repetitions
+			<< ", \"ns_per_op\": " << result.nsPerOp
+			<< ", \"min_ns_per_op\": " << result.minNsPerOp
+			<< ", \"max_ns_per_op\": " << result.maxNsPerOp
+			<< ", \"items_per_op\": " << result.itemsPerOp
+			<< ", \"ns_per_item\": " << result.NsPerItem()
+			<< " }";
+	}
+	out << "\n\t]\n}\n";
+	return out.str();
+}
+
+bool benchmark::SaveJson(const std::string& file, const std::vector<Result>& results)
+{
+	std::ofstream stream(file, std::ios::binary);
+	if (!stream)
+	{
+		std::cerr << "Failed to open " << file << " for writing." << std::endl;
+		return false;
+	}
+	stream << ToJson(results);
+	return static_cast<bool>(stream);
+}
+
+// only reads what SaveJson writes: one object per case, names without escapes
+bool benchmark::LoadJson(const std::string& file, std::vector<Result>& results)
+{
+	std::ifstream stream(file, std::ios::binary);
+	if (!stream)
+	{
+		std::cerr << "Failed to open baseline " << file << "." << std::endl;
+		return false;
+	}
+	std::stringstream buffer;
+	buffer << stream.rdbuf();
+	const std::string text = buffer.str();
+
+	size_t pos = text.find('[');
+	while (pos != std::string::npos)
+	{
+		size_t begin = text.find('{', pos);
+		if (begin == std::string::npos)
+		{
+			break;
+		}
+		size_t end = text.find('}', begin);
+		if (end == std::string::npos)
+		{
+			break;
+		}
+		const std::string object = text.substr(begin, end - begin + 1);
+		pos = end + 1;
+
+		Result result;
+		std::string value;
+		if (!FindValue(object, "name", result.name) || !FindValue(object, "ns_per_op", value))
+		{
+			continue;
+		}
+		result.nsPerOp = std::strtod(value.c_str(), nullptr);
+		if (FindValue(object, "iterations", value)) result.iterations = std::strtoull(value.c_str(), nullptr, 10);
+		if (FindValue(object, "repetitions", value)) result.repetitions = static_cast<size_t>(std::strtoull(value.c_str(), nullptr, 10));
+		if (FindValue(object, "min_ns_per_op", value)) result.minNsPerOp = std::strtod(value.c_str(), nullptr);
+		if (FindValue(object, "max_ns_per_op", value)) result.maxNsPerOp = std::strtod(value.c_str(), nullptr);
+		if (FindValue(object, "items_per_op", value)) result.itemsPerOp = std::strtoull(value.c_str(), nullptr, 10);
+		results.push_back(result);
+	}
+	return true;
+}
+
+size_t benchmark::Compare(const std::vector<Result>& results, const std::vector<Result>& baseline, double threshold)
+{
+	std::cout << std::endl << "comparison against baseline, threshold " << std::fixed << std::setprecision(1) << threshold * 100.0 << "%" << std::endl;
+
+	size_t regressions = 0;
+	for (const Result& result : results)
+	{
+		auto it = std::find_if(baseline.begin(), baseline.end(), [&result](const Result& b) { return b.name == result.name; });
+		std::cout << std::left << std::setw(40) << result.name << std::right;
+		if (it == baseline.end() || it->nsPerOp <= 0.0)
+		{
+			std::cout << "  new" << std::endl;
+			continue;
+		}
+
+		double change = result.nsPerOp / it->nsPerOp - 1.0;
+		const char* verdict = "";
+		if (change > threshold)
+		{
+			verdict = "  REGRESSION";
+			++regressions;
+		}
+		else if (change < -threshold)
+		{
+			verdict = "  improved";
+		}
+
+		std::cout << std::setw(14) << it->nsPerOp << " -> " << std::setw(14) << result.nsPerOp << " ns/op"
+			<< std::showpos << std::setw(9) << change * 100.0 << "%" << std::noshowpos << verdict << std::endl;
+	}
+
+	for (const Result& b : baseline)
+	{
+		if (std::none_of(results.begin(), results.end(), [&b](const Result& r) { return r.name == b.name; }))
+		{
+			std::cout << std::left << std::setw(40) << b.name << std::right << "  missing (in baseline only)" << std::endl;
+		}
+	}
+
+	std::cout << regressions << " regression(s)" << std::endl;
+	return regressions;
+}
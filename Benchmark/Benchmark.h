@@ -0,0 +1,158 @@
+#pragma once
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace benchmark
+{
+	// keeps the compiler from optimizing away a value that is computed but never used
+	template <typename T>
+	inline void DoNotOptimize(const T& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static const void* volatile sink;
+		sink = &value;
+#endif
+	}
+
+	struct Options
+	{
+		std::string filter;			// only cases whose name contains this run
+		double minTime = 0.05;		// seconds one repetition should at least take
+		size_t repetitions = 5;		// median of these is reported
+	};
+
+	struct Result
+	{
+		std::string name;
+		uint64_t iterations = 0;	// per repetition
+		size_t repetitions = 0;
+		double nsPerOp = 0.0;		// median over repetitions
+		double minNsPerOp = 0.0;
+		double maxNsPerOp = 0.0;
+		uint64_t itemsPerOp = 1;	// e.g. handlers called or tiles visited by one op
+		std::string error;			// first failed Check of the case. empty if all passed
+
+		double NsPerItem() const
+		{
+			return nsPerOp / static_cast<double>(itemsPerOp > 0 ? itemsPerOp : 1);
+		}
+	};
+
+	// handed to every benchmark case. the case does its setup, then calls Run with the operation to measure.
+	// design consideration:
+	//	-	only the loop inside Run is timed, so setup (building maps, writing files, subscribing) costs nothing
+	//	-	iteration count is calibrated per case: doubled until one repetition takes minTime. cheap operations
+	//		run millions of times, an A* search a few hundred, and every case takes about the same wall time
+	//	-	the reported figure is the median of the repetitions. it is what we compare against a baseline, a single
+	//		slow repetition (page fault, other process) does not move it
+	//	-	op is a template parameter, so it is inlined into the timing loop and costs no call per iteration
+	class State
+	{
+	private:
+		const Options& m_options;
+		Result& m_result;
+
+	public:
+		State(const Options& options, Result& result) :
+			m_options(options),
+			m_result(result)
+		{
+		}
+
+		// work one op represents. reported per item next to per op
+		void SetItemsPerOp(uint64_t items)
+		{
+			m_result.itemsPerOp = items;
+		}
+
+		// verifies the code being measured does what it should, so a fast but wrong result is not reported as a win.
+		// a case usually checks the output of one op in its setup and returns if that fails. only the first failure
+		// is kept. returns condition
+		bool Check(bool condition, const char* message)
+		{
+			if (!condition && m_result.error.empty())
+			{
+				m_result.error = message;
+			}
+			return condition;
+		}
+
+		template <typename Op>
+		void Run(Op&& op)
+		{
+			using Clock = std::chrono::steady_clock;
+
+			auto measure = [&op](uint64_t iterations) -> double
+				{
+					Clock::time_point start = Clock::now();
+					for (uint64_t i = 0; i < iterations; ++i)
+					{
+						op();
+					}
+					return std::chrono::duration<double>(Clock::now() - start).count();
+				};
+
+			// calibrate. this also warms caches and branch predictors
+			uint64_t iterations = 1;
+			double elapsed = measure(iterations);
+			while (elapsed < m_options.minTime && iterations < (uint64_t(1) << 40))
+			{
+				// jump close to target once we have a usable measurement, double otherwise
+				double scale = elapsed > 1e-4 ? m_options.minTime / elapsed * 1.2 : 2.0;
+				iterations = static_cast<uint64_t>(iterations * (scale > 2.0 ? scale : 2.0));
+				elapsed = measure(iterations);
+			}
+
+			std::vector<double> samples;
+			for (size_t i = 0; i < m_options.repetitions; ++i)
+			{
+				samples.push_back(measure(iterations) * 1e9 / static_cast<double>(iterations));
+			}
+
+			Report(iterations, samples);
+		}
+
+	private:
+		void Report(uint64_t iterations, std::vector<double>& samples);
+	};
+
+	using Function = void (*)(State&);
+
+	// registers a case at static initialization. use through BENCHMARK
+	struct Registrar
+	{
+		Registrar(const char* name, Function function);
+	};
+
+	// runs registered cases matching options, in registration order, and prints one line per case.
+	// cases with a failed Check are printed to cerr, counted in failures and left out of the results
+	std::vector<Result> RunAll(const Options& options, size_t& failures);
+
+	// names of registered cases
+	std::vector<std::string> List();
+
+	// results as json. see Main.cpp for the format
+	std::string ToJson(const std::vector<Result>& results);
+	bool SaveJson(const std::string& file, const std::vector<Result>& results);
+
+	// reads a file written by SaveJson
+	bool LoadJson(const std::string& file, std::vector<Result>& results);
+
+	// prints current against baseline per case. a case is a regression if it got slower than threshold (0.1 = 10%).
+	// returns number of regressions
+	size_t Compare(const std::vector<Result>& results, const std::vector<Result>& baseline, double threshold);
+}
+
+#define BENCHMARK_CONCAT_INNER(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT_INNER(a, b)
+
+// defines and registers a benchmark case: BENCHMARK("group/case") { setup; state.Run([&] { op; }); }
+#define BENCHMARK(name) \
+	static void BENCHMARK_CONCAT(BenchmarkCase, __LINE__)(benchmark::State& state); \
+	static benchmark::Registrar BENCHMARK_CONCAT(benchmarkRegistrar, __LINE__)(name, &BENCHMARK_CONCAT(BenchmarkCase, __LINE__)); \
+	static void BENCHMARK_CONCAT(BenchmarkCase, __LINE__)(benchmark::State& state)
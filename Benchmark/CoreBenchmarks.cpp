@@ -0,0 +1,663 @@
+// benchmarks of the engine's platform independent core: events, scheduler, commands, tiles, csv, caches, sprite batching
+// and spatial queries.
+// only engine headers are included here. navigation code from the Test project lives in NavigationBenchmarks.cpp
+// because its headers define the same names (Tile.h, Event.h, ...)
+
+#include "Benchmark.h"
+#include <Core/Event.h>
+#include <Timer/Scheduler.h>
+#include <Command/CommandQueue.h>
+#include <Job/JobSystem.h>
+#include <Components/Tile.h>
+#include <Utilities/CSVFile.h>
+#include <Cache/Dictionary.h>
+#include <Cache/BindCache.h>
+#include <Graphics/Renderer/SpriteBatchBuilder.h>
+#include <Spatial/SpatialIndex.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	// stands in for an animator or pulse listener. work per call is tiny on purpose, dispatch cost dominates
+	struct Listener
+	{
+		float total = 0.0f;
+
+		void OnFrame(float delta)
+		{
+			total += delta;
+		}
+	};
+
+	void EventDispatch(benchmark::State& state, size_t subscribers)
+	{
+		std::vector<Listener> listeners(subscribers);
+		event::Event<float> evt;
+		for (Listener& listener : listeners)
+		{
+			evt += event::Handler(&listener, &Listener::OnFrame);
+		}
+
+		state.SetItemsPerOp(subscribers);
+		state.Run([&evt]() { evt(0.016f); });
+		benchmark::DoNotOptimize(listeners.front().total);
+	}
+
+	void EventDispatchFunctionRef(benchmark::State& state, size_t subscribers)
+	{
+		std::vector<Listener> listeners(subscribers);
+		event::Event<float> evt;
+		for (Listener& listener : listeners)
+		{
+			evt += event::FunctionRef<void(float)>::Bind<&Listener::OnFrame>(&listener);
+		}
+
+		state.SetItemsPerOp(subscribers);
+		state.Run([&evt]() { evt(0.016f); });
+		benchmark::DoNotOptimize(listeners.front().total);
+	}
+
+	// timers with intervals spread over a few frames to a few seconds, as in a scene with many animated actors
+	void SchedulerUpdate(benchmark::State& state, size_t timers)
+	{
+		std::vector<Listener> listeners(timers);
+		timer::Scheduler scheduler;
+		for (size_t i = 0; i < timers; ++i)
+		{
+			float interval = 1.0f / 60.0f * static_cast<float>(1 + (i * 7919) % 240);
+			scheduler += timer::Schedule(interval, &listeners[i], &Listener::OnFrame);
+		}
+
+		state.SetItemsPerOp(timers);
+		state.Run([&scheduler]() { scheduler.Update(1.0f / 60.0f); });
+		benchmark::DoNotOptimize(listeners.front().total);
+	}
+
+	// stand ins for the draw text commands. they add up text lengths instead of drawing, so no renderer is needed.
+	// labels are longer than the small string buffer, like most overlay text
+	struct HeapTextCommand : public engine::command::ICommand
+	{
+		size_t& total;
+		std::string text;
+		float x, y;
+
+		HeapTextCommand(size_t& total, const std::string& text, float x, float y) :
+			total(total),
+			text(text),
+			x(x),
+			y(y)
+		{
+		}
+
+		void Execute() override
+		{
+			total += text.size();
+		}
+
+		engine::command::Type GetType() const override
+		{
+			return engine::command::Type::Render;
+		}
+	};
+
+	struct FrameTextCommand
+	{
+		static constexpr engine::command::Type CommandType = engine::command::Type::Render;
+
+		size_t& total;
+		std::string_view text;
+		float x, y;
+
+		void Execute() const
+		{
+			total += text.size();
+		}
+	};
+
+	const std::string CommandLabel = "State: LaunchState, frame label";
+
+	// one frame: submit commands, then dispatch and clear them, as a state's Update and the render loop do
+	void CommandsUniquePtr(benchmark::State& state, size_t commands)
+	{
+		engine::command::CommandQueue queue;
+		size_t total = 0;
+
+		state.SetItemsPerOp(commands);
+		state.Run([&]()
+			{
+				for (size_t i = 0; i < commands; ++i)
+				{
+					queue.Enqueue(std::make_unique<HeapTextCommand>(total, CommandLabel, 10.0f, static_cast<float>(i)));
+				}
+				queue.Dispatch(engine::command::Type::Render, true);
+			});
+		benchmark::DoNotOptimize(total);
+	}
+
+	void CommandsFrameArena(benchmark::State& state, size_t commands)
+	{
+		engine::command::CommandQueue queue;
+		size_t total = 0;
+
+		state.SetItemsPerOp(commands);
+		state.Run([&]()
+			{
+				for (size_t i = 0; i < commands; ++i)
+				{
+					queue.Record<FrameTextCommand>(total, queue.CopyString(CommandLabel), 10.0f, static_cast<float>(i));
+				}
+				queue.Dispatch(engine::command::Type::Render, true);
+			});
+		benchmark::DoNotOptimize(total);
+	}
+
+	// notes where it was recorded when executed: source 0 is the main queue, 1 + i worker buffer i, sequence is
+	// its position there. used to check the order Dispatch merges in
+	struct OrderCommand : public engine::command::ICommand
+	{
+		static constexpr engine::command::Type CommandType = engine::command::Type::Render;
+
+		std::vector<std::pair<size_t, size_t>>& executed;
+		size_t source;
+		size_t sequence;
+
+		OrderCommand(std::vector<std::pair<size_t, size_t>>& executed, size_t source, size_t sequence) :
+			executed(executed),
+			source(source),
+			sequence(sequence)
+		{
+		}
+
+		void Execute() override
+		{
+			executed.emplace_back(source, sequence);
+		}
+
+		engine::command::Type GetType() const override
+		{
+			return engine::command::Type::Render;
+		}
+	};
+
+	// one frame: main thread enqueues a few commands, jobs record the rest into the buffer of the thread they run
+	// on, then everything is dispatched. which thread gets which batch changes from frame to frame
+	void RecordWithJobs(job::JobSystem& jobs, engine::command::CommandQueue& queue, std::vector<std::pair<size_t, size_t>>& executed, size_t mainCommands, size_t jobCommands)
+	{
+		executed.clear();
+		for (size_t i = 0; i < mainCommands; ++i)
+		{
+			queue.Enqueue(std::make_unique<OrderCommand>(executed, 0, i));
+		}
+
+		job::JobHandle handle = jobs.ParallelFor(jobCommands, 250, [&jobs, &queue, &executed](size_t begin, size_t end)
+			{
+				size_t worker = jobs.GetCurrentWorker();
+				engine::command::CommandBuffer& buffer = queue.GetWorkerBuffer(worker);
+				for (size_t i = begin; i < end; ++i)
+				{
+					buffer.Record<OrderCommand>(executed, 1 + worker, buffer.GetSize(engine::command::Type::Render));
+				}
+			});
+		jobs.Wait(handle);
+
+		queue.Dispatch(engine::command::Type::Render, true);
+	}
+
+	// main queue first, then worker buffers by index, each in record order. no matter which thread finished first
+	bool CheckMergeOrder(const std::vector<std::pair<size_t, size_t>>& executed, size_t expected)
+	{
+		if (executed.size() != expected || (!executed.empty() && executed.front().second != 0))
+		{
+			return false;
+		}
+		for (size_t i = 1; i < executed.size(); ++i)
+		{
+			const std::pair<size_t, size_t>& previous = executed[i - 1];
+			const std::pair<size_t, size_t>& current = executed[i];
+			if (current.first < previous.first)
+			{
+				return false;
+			}
+			if (current.second != (current.first == previous.first ? previous.second + 1 : 0))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void CommandsWorkerMerge(benchmark::State& state, size_t workers, size_t commands)
+	{
+		job::JobSystem jobs;
+		jobs.Start(static_cast<int>(workers));
+
+		engine::command::CommandQueue queue;
+		queue.SetWorkerCount(jobs.GetWorkerCount() + 1);
+
+		std::vector<std::pair<size_t, size_t>> executed;
+		executed.reserve(commands + 16);
+
+		// recorded in the wrong order on purpose: buffers interleaved from last to first, main queue after them.
+		// this does not depend on how jobs get scheduled, e.g. on a single core every batch may run on main thread
+		for (size_t i = 0; i < 4; ++i)
+		{
+			for (size_t worker = queue.GetWorkerCount(); worker-- > 0;)
+			{
+				engine::command::CommandBuffer& buffer = queue.GetWorkerBuffer(worker);
+				buffer.Record<OrderCommand>(executed, 1 + worker, buffer.GetSize(engine::command::Type::Render));
+			}
+		}
+		for (size_t i = 0; i < 4; ++i)
+		{
+			queue.Enqueue(std::make_unique<OrderCommand>(executed, 0, i));
+		}
+		queue.Dispatch(engine::command::Type::Render, true);
+		if (!state.Check(CheckMergeOrder(executed, 4 * (queue.GetWorkerCount() + 1)), "dispatch runs main queue, then worker buffers by index, each in record order"))
+		{
+			return;
+		}
+
+		// a few frames recorded by jobs, so batches land on different threads
+		for (int frame = 0; frame < 8; ++frame)
+		{
+			RecordWithJobs(jobs, queue, executed, 16, commands);
+			if (!state.Check(CheckMergeOrder(executed, commands + 16), "dispatch runs main queue, then worker buffers by index, each in record order"))
+			{
+				return;
+			}
+		}
+
+		state.SetItemsPerOp(commands + 16);
+		state.Run([&]() { RecordWithJobs(jobs, queue, executed, 16, commands); });
+		benchmark::DoNotOptimize(executed.size());
+	}
+
+	// 256 x 256 tiles in 32 x 32 regions, checkerboard of two tile types
+	struct TileMap
+	{
+		static constexpr int Size = 256;
+		static constexpr int RegionSize = 32;
+
+		component::tile::Tileset<int> tileset;
+		component::tile::TileLayer<int> layer;
+
+		TileMap() :
+			layer(Size / RegionSize, Size / RegionSize, { RegionSize, RegionSize })
+		{
+			tileset.Register(0, std::make_unique<int>(0));
+			tileset.Register(1, std::make_unique<int>(1));
+			for (int row = 0; row < Size; ++row)
+			{
+				for (int col = 0; col < Size; ++col)
+				{
+					layer.SetTile(row, col, tileset.MakeTile((row + col) % 2));
+				}
+			}
+		}
+	};
+
+	// writes a csv map of given size into temp folder once per process and returns its path
+	std::string MakeCSV(int rows, int cols)
+	{
+		std::filesystem::path path = std::filesystem::temp_directory_path() / ("benchmark_" + std::to_string(rows) + "x" + std::to_string(cols) + ".csv");
+		std::ofstream file(path);
+		file << "// generated tile map for csv benchmark\n";
+		for (int row = 0; row < rows; ++row)
+		{
+			for (int col = 0; col < cols; ++col)
+			{
+				file << (col > 0 ? "," : "") << (row * 31 + col * 17) % 64;
+			}
+			file << "\n";
+		}
+		return path.string();
+	}
+
+	void CSVRead(benchmark::State& state, int rows, int cols)
+	{
+		const std::string path = MakeCSV(rows, cols);
+
+		state.SetItemsPerOp(static_cast<uint64_t>(rows) * cols);
+		state.Run([&path]()
+			{
+				utilities::fileio::CSVFile csv(path);
+				csv.read();
+
+				int sum = 0;
+				for (int row = 0; row < static_cast<int>(csv.GetRowCount()); ++row)
+				{
+					for (int col = 0; col < static_cast<int>(csv.GetColCount(row)); ++col)
+					{
+						sum += csv.GetValue<int>(row, col);
+					}
+				}
+				benchmark::DoNotOptimize(sum);
+			});
+
+		std::error_code error;
+		std::filesystem::remove(path, error);
+	}
+
+	struct Texture
+	{
+		int id;
+	};
+
+	using SpriteSpan = graphics::renderer::SpriteBatchBuilder::Span;
+
+	// one frame as the batch renderer builds it: sprites come sorted by texture, pending instances are handed off
+	// whenever the texture changes and once at the end. clip region changes every 16 sprites, which must not split
+	// a batch. spans are collected instead of drawn
+	void BuildSpriteFrame(graphics::renderer::SpriteBatchBuilder& builder, size_t sprites, size_t perTexture, std::vector<SpriteSpan>& spans)
+	{
+		builder.Reset();
+		builder.EnableClipping(true);
+		spans.clear();
+
+		for (size_t i = 0; i < sprites; ++i)
+		{
+			if (i > 0 && i % perTexture == 0 && builder.HasPending())
+			{
+				spans.push_back(builder.GetPending());
+				builder.MarkSubmitted();
+			}
+			if (i % 16 == 0)
+			{
+				float top = static_cast<float>(i);
+				builder.SetClipRegion({ 0.0f, top, 800.0f, top + 16.0f });
+			}
+
+			float x = static_cast<float>(i % 64) * 12.0f;
+			float y = static_cast<float>(i / 64) * 12.0f;
+			builder.Add({ x, y }, { 12.0f, 12.0f }, { 0.0f, 0.0f, 1.0f, 1.0f }, { 1.0f, 1.0f, 1.0f, 1.0f }, 0.0f, true);
+		}
+
+		if (builder.HasPending())
+		{
+			spans.push_back(builder.GetPending());
+			builder.MarkSubmitted();
+		}
+		builder.EnableClipping(false);
+	}
+
+	// spans must be consecutive runs of perTexture instances starting at 0, last one holding the remainder
+	bool CheckSpriteSpans(const std::vector<SpriteSpan>& spans, size_t sprites, size_t perTexture)
+	{
+		if (spans.size() != (sprites + perTexture - 1) / perTexture)
+		{
+			return false;
+		}
+		for (size_t i = 0; i < spans.size(); ++i)
+		{
+			size_t first = i * perTexture;
+			size_t count = sprites - first < perTexture ? sprites - first : perTexture;
+			if (spans[i].first != first || spans[i].count != count)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// objects of 16 to 48 units scattered over a 8192 x 8192 world, as the demo's actors and effects. views are
+	// 1280 x 720 rects at different places in it, a camera panning over the world
+	struct SpatialWorld
+	{
+		spatial::SpatialIndex<int> index;
+		std::vector<math::geometry::RectF> bounds;
+		std::vector<math::geometry::RectF> views;
+
+		SpatialWorld(size_t objects) :
+			index({ 0.0f, 0.0f, 8192.0f, 8192.0f }, 256.0f)
+		{
+			for (size_t i = 0; i < objects; ++i)
+			{
+				float size = 16.0f + static_cast<float>(i % 3) * 16.0f;
+				float x = static_cast<float>((i * 7919) % 10007) / 10007.0f * (8192.0f - size);
+				float y = static_cast<float>((i * 104729) % 10009) / 10009.0f * (8192.0f - size);
+				bounds.push_back({ x, y, x + size, y + size });
+				index.Insert(bounds.back(), static_cast<int>(i));
+			}
+			for (int i = 0; i < 16; ++i)
+			{
+				float x = static_cast<float>((i * 2741) % 6912);
+				float y = static_cast<float>((i * 3917) % 7472);
+				views.push_back({ x, y, x + 1280.0f, y + 720.0f });
+			}
+		}
+
+		size_t CountBruteForce(const math::geometry::RectF& view) const
+		{
+			size_t count = 0;
+			for (const math::geometry::RectF& object : bounds)
+			{
+				count += object.Overlaps(view) ? 1 : 0;
+			}
+			return count;
+		}
+
+		size_t CountIndexed(const math::geometry::RectF& view) const
+		{
+			size_t count = 0;
+			index.Query(view, [&count](spatial::SpatialIndex<int>::Handle, const int&) { ++count; });
+			return count;
+		}
+	};
+
+	// one view per op, cycling through the views
+	void SpatialQuery(benchmark::State& state, size_t objects, bool indexed)
+	{
+		SpatialWorld world(objects);
+		for (const math::geometry::RectF& view : world.views)
+		{
+			if (!state.Check(world.CountIndexed(view) == world.CountBruteForce(view), "index finds exactly the objects overlapping the view"))
+			{
+				return;
+			}
+		}
+
+		size_t next = 0;
+		size_t found = 0;
+		state.Run([&]()
+			{
+				const math::geometry::RectF& view = world.views[next];
+				next = (next + 1) % world.views.size();
+				found += indexed ? world.CountIndexed(view) : world.CountBruteForce(view);
+			});
+		benchmark::DoNotOptimize(found);
+	}
+
+	void SpriteBatch(benchmark::State& state, size_t sprites, size_t perTexture)
+	{
+		// small initial capacity, so first frame also checks that growing keeps offsets
+		graphics::renderer::SpriteBatchBuilder builder(64);
+		std::vector<SpriteSpan> spans;
+
+		BuildSpriteFrame(builder, sprites, perTexture, spans);
+		if (!state.Check(builder.GetCount() == sprites, "builder holds every sprite added") ||
+			!state.Check(!builder.HasPending(), "nothing pending after final hand off") ||
+			!state.Check(CheckSpriteSpans(spans, sprites, perTexture), "one span per texture run with matching first and count"))
+		{
+			return;
+		}
+
+		// memory is kept after the first frame, a reset builder starts over at offset 0
+		size_t capacity = builder.GetCapacity();
+		BuildSpriteFrame(builder, sprites, perTexture, spans);
+		if (!state.Check(builder.GetCapacity() == capacity, "no growth after first frame") ||
+			!state.Check(CheckSpriteSpans(spans, sprites, perTexture), "spans start over at 0 after reset"))
+		{
+			return;
+		}
+
+		state.SetItemsPerOp(sprites);
+		state.Run([&]() { BuildSpriteFrame(builder, sprites, perTexture, spans); });
+		benchmark::DoNotOptimize(spans.back().count);
+	}
+}
+
+// events
+BENCHMARK("event/dispatch/1") { EventDispatch(state, 1); }
+BENCHMARK("event/dispatch/64") { EventDispatch(state, 64); }
+BENCHMARK("event/dispatch/1000") { EventDispatch(state, 1000); }
+BENCHMARK("event/dispatch_function_ref/64") { EventDispatchFunctionRef(state, 64); }
+BENCHMARK("event/dispatch_function_ref/1000") { EventDispatchFunctionRef(state, 1000); }
+
+// subscribe and unsubscribe one handler on an event that already has 64
+BENCHMARK("event/subscribe_unsubscribe/64")
+{
+	std::vector<Listener> listeners(65);
+	event::Event<float> evt;
+	for (size_t i = 1; i < listeners.size(); ++i)
+	{
+		evt += event::Handler(&listeners[i], &Listener::OnFrame);
+	}
+
+	state.Run([&evt, &listeners]()
+		{
+			event::Subscription subscription = evt += event::Handler(&listeners[0], &Listener::OnFrame);
+			evt -= subscription;
+		});
+}
+
+// scheduler
+BENCHMARK("scheduler/update/100") { SchedulerUpdate(state, 100); }
+BENCHMARK("scheduler/update/10000") { SchedulerUpdate(state, 10000); }
+
+BENCHMARK("scheduler/schedule_cancel/10000")
+{
+	Listener listener;
+	timer::Scheduler scheduler;
+	for (size_t i = 0; i < 10000; ++i)
+	{
+		scheduler += timer::Schedule(1.0f + static_cast<float>(i % 100), &listener, &Listener::OnFrame);
+	}
+
+	state.Run([&scheduler, &listener]()
+		{
+			timer::ScheduleHandle handle = scheduler += timer::Schedule(0.5f, &listener, &Listener::OnFrame);
+			scheduler.Cancel(handle);
+		});
+}
+
+// commands
+BENCHMARK("command/text/unique_ptr/100") { CommandsUniquePtr(state, 100); }
+BENCHMARK("command/text/unique_ptr/10000") { CommandsUniquePtr(state, 10000); }
+BENCHMARK("command/text/frame_arena/100") { CommandsFrameArena(state, 100); }
+BENCHMARK("command/text/frame_arena/10000") { CommandsFrameArena(state, 10000); }
+BENCHMARK("command/worker_merge/3/10000") { CommandsWorkerMerge(state, 3, 10000); }
+
+// tiles
+BENCHMARK("tile/get/row_major")
+{
+	TileMap map;
+	state.SetItemsPerOp(TileMap::Size * TileMap::Size);
+	state.Run([&map]()
+		{
+			int sum = 0;
+			for (int row = 0; row < TileMap::Size; ++row)
+			{
+				for (int col = 0; col < TileMap::Size; ++col)
+				{
+					sum += *map.layer.GetTile(row, col);
+				}
+			}
+			benchmark::DoNotOptimize(sum);
+		});
+}
+
+BENCHMARK("tile/get/column_major")
+{
+	TileMap map;
+	state.SetItemsPerOp(TileMap::Size * TileMap::Size);
+	state.Run([&map]()
+		{
+			int sum = 0;
+			for (int col = 0; col < TileMap::Size; ++col)
+			{
+				for (int row = 0; row < TileMap::Size; ++row)
+				{
+					sum += *map.layer.GetTile(row, col);
+				}
+			}
+			benchmark::DoNotOptimize(sum);
+		});
+}
+
+BENCHMARK("tile/set/row_major")
+{
+	TileMap map;
+	state.SetItemsPerOp(TileMap::Size * TileMap::Size);
+	state.Run([&map]()
+		{
+			for (int row = 0; row < TileMap::Size; ++row)
+			{
+				for (int col = 0; col < TileMap::Size; ++col)
+				{
+					map.layer.SetTile(row, col, map.tileset.MakeTile((row ^ col) & 1));
+				}
+			}
+		});
+}
+
+// csv
+BENCHMARK("csv/read/64x64") { CSVRead(state, 64, 64); }
+BENCHMARK("csv/read/256x256") { CSVRead(state, 256, 256); }
+
+// caches
+BENCHMARK("cache/dictionary_get/1024")
+{
+	cache::Dictionary<int, int> dictionary;
+	for (int i = 0; i < 1024; ++i)
+	{
+		dictionary.Register(i * 7, i);
+	}
+
+	state.SetItemsPerOp(1024);
+	state.Run([&dictionary]()
+		{
+			int sum = 0;
+			for (int i = 0; i < 1024; ++i)
+			{
+				sum += dictionary.Get(i * 7);
+			}
+			benchmark::DoNotOptimize(sum);
+		});
+}
+
+// draws alternating between few textures, half of the binds are redundant
+BENCHMARK("cache/bind_cache/1024")
+{
+	Texture textures[4] = { { 0 }, { 1 }, { 2 }, { 3 } };
+	cache::BindCache<Texture>& bindCache = cache::BindCache<Texture>::Instance();
+
+	state.SetItemsPerOp(1024);
+	state.Run([&textures, &bindCache]()
+		{
+			int binds = 0;
+			for (int i = 0; i < 1024; ++i)
+			{
+				Texture* texture = &textures[(i / 2) % 4];
+				if (bindCache.CanBind(texture))
+				{
+					bindCache.Bind(texture);
+					++binds;
+				}
+			}
+			benchmark::DoNotOptimize(binds);
+		});
+}
+
+// sprite batching. a frame of sprites over few textures (long batches) and over many (short batches)
+BENCHMARK("sprite_batch/build/1000/per_texture_250") { SpriteBatch(state, 1000, 250); }
+BENCHMARK("sprite_batch/build/1000/per_texture_10") { SpriteBatch(state, 1000, 10); }
+
+// spatial queries. index against checking every object, for a camera sized view into a big world
+BENCHMARK("spatial/query/index/20000") { SpatialQuery(state, 20000, true); }
+BENCHMARK("spatial/query/brute_force/20000") { SpatialQuery(state, 20000, false); }
@@ -0,0 +1,111 @@
+// microbenchmarks of the engine's platform independent core (events, scheduler, commands, tiles, csv, caches) and of the
+// tile navigation code (A*, footprint resolution). runs on windows and linux, nothing here touches win32 or dx11.
+//
+// usage:
+//	Benchmark [-filter <text>] [-json <file>] [-baseline <file>] [-threshold <percent>] [-repetitions <n>]
+//	          [-min-time <seconds>] [-list]
+//
+//	-filter			only run cases whose name contains text, e.g. -filter astar
+//	-json			write results to file
+//	-baseline		compare results against a file written by -json. exit code is 1 if any case got slower
+//					than threshold, so a build server can fail on it
+//	-threshold		percent a case may get slower before it counts as a regression. default 10
+//	-repetitions	repetitions per case, median is reported. default 5
+//	-min-time		seconds one repetition should at least take. default 0.05
+//	-list			print case names and exit
+//
+// exit code is 1 if a case failed one of its checks (the measured code gave a wrong result) or got slower than
+// the baseline, 2 on bad arguments or unreadable files
+//
+// json format:
+//	{ "benchmarks": [ { "name": ..., "iterations": ..., "repetitions": ..., "ns_per_op": ..., "min_ns_per_op": ...,
+//	  "max_ns_per_op": ..., "items_per_op": ..., "ns_per_item": ... }, ... ] }
+//	ns_per_op is the median and the only figure compared against a baseline
+//
+// building on linux (from solution folder, one command):
+//	g++ -std=c++17 -O2 -pthread -IEngine/Include -ITest -o benchmark
+//		Benchmark/Main.cpp Benchmark/Benchmark.cpp Benchmark/CoreBenchmarks.cpp Benchmark/NavigationBenchmarks.cpp
+//		Engine/Source/Timer/Scheduler.cpp Engine/Source/Job/JobSystem.cpp Engine/Source/Performance/Profiler.cpp
+//		Engine/Source/Command/CommandQueue.cpp Engine/Source/Command/FrameArena.cpp
+//		Engine/Source/Graphics/Renderer/SpriteBatchBuilder.cpp
+//		Test/FootprintResolver.cpp
+
+#include "Benchmark.h"
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+int main(int argc, char* argv[])
+{
+	benchmark::Options options;
+	std::string jsonFile;
+	std::string baselineFile;
+	double threshold = 0.10;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		bool hasValue = i + 1 < argc;
+
+		if (arg == "-list")
+		{
+			for (const std::string& name : benchmark::List())
+			{
+				std::cout << name << std::endl;
+			}
+			return 0;
+		}
+		else if (arg == "-filter" && hasValue)
+		{
+			options.filter = argv[++i];
+		}
+		else if (arg == "-json" && hasValue)
+		{
+			jsonFile = argv[++i];
+		}
+		else if (arg == "-baseline" && hasValue)
+		{
+			baselineFile = argv[++i];
+		}
+		else if (arg == "-threshold" && hasValue)
+		{
+			threshold = std::atof(argv[++i]) / 100.0;
+		}
+		else if (arg == "-repetitions" && hasValue)
+		{
+			int repetitions = std::atoi(argv[++i]);
+			options.repetitions = repetitions > 0 ? static_cast<size_t>(repetitions) : 1;
+		}
+		else if (arg == "-min-time" && hasValue)
+		{
+			options.minTime = std::atof(argv[++i]);
+		}
+		else
+		{
+			std::cerr << "Unknown or incomplete argument: " << arg << std::endl;
+			return 2;
+		}
+	}
+
+	// read baseline first, a typo in its path should not cost a full run
+	std::vector<benchmark::Result> baseline;
+	if (!baselineFile.empty() && !benchmark::LoadJson(baselineFile, baseline))
+	{
+		return 2;
+	}
+
+	size_t failures = 0;
+	std::vector<benchmark::Result> results = benchmark::RunAll(options, failures);
+
+	if (!jsonFile.empty() && !benchmark::SaveJson(jsonFile, results))
+	{
+		return 2;
+	}
+
+	if (!baselineFile.empty() && benchmark::Compare(results, baseline, threshold) > 0)
+	{
+		return 1;
+	}
+
+	return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,154 @@
+// benchmarks of the tile navigation code in the Test project: A* search and footprint resolution.
+// only Test project headers are included here, they define the same names as the engine headers (Tile.h,
+// Event.h, Rect.h, ...) so the two must not meet in one translation unit
+
+#include "Benchmark.h"
+#include "PathFinder.h"
+#include "FootprintResolver.h"
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+namespace
+{
+	// square map with random obstacles. same seed gives the same map on every machine, so results compare
+	struct GeneratedMap
+	{
+		int size;
+		std::vector<uint8_t> blocked;
+
+		GeneratedMap(int mapSize, int obstaclePercent, uint32_t seed) :
+			size(mapSize),
+			blocked(static_cast<size_t>(mapSize) * mapSize, 0)
+		{
+			// small lcg instead of <random>, its distributions differ between standard libraries
+			uint32_t state = seed;
+			for (uint8_t& cell : blocked)
+			{
+				state = state * 1664525u + 1013904223u;
+				cell = static_cast<int>((state >> 16) % 100) < obstaclePercent ? 1 : 0;
+			}
+
+			// keep corners open, they are start and goal
+			for (int i = 0; i < 3; ++i)
+			{
+				for (int j = 0; j < 3; ++j)
+				{
+					blocked[i * size + j] = 0;
+					blocked[(size - 1 - i) * size + (size - 1 - j)] = 0;
+				}
+			}
+		}
+
+		bool IsWalkable(int row, int col) const
+		{
+			return row >= 0 && row < size && col >= 0 && col < size && blocked[row * size + col] == 0;
+		}
+	};
+
+	// search from top-left to bottom-right corner of the whole map
+	template <typename Finder>
+	void FindPath(benchmark::State& state, int size, int obstaclePercent)
+	{
+		GeneratedMap map(size, obstaclePercent, 12345u);
+		Finder finder(
+			[&map](int, int, int row, int col) { return map.IsWalkable(row, col); },
+			size * size, true, false
+		);
+
+		const math::geometry::Rect<int> region = { 0, 0, size, size };
+		std::vector<component::tile::TileCoord> path;
+
+		state.Run([&]()
+			{
+				finder.FindPath(region, { 0, 0 }, { size - 1, size - 1 }, path);
+				benchmark::DoNotOptimize(path.size());
+			});
+	}
+
+	// tile layer of generated map for footprint resolver
+	struct FootprintMap
+	{
+		static constexpr int Size = 64;
+
+		GeneratedMap map;
+		component::tile::Tileset tileset;
+		component::tile::TileLayer layer;
+		spatial::SizeF tileSize = { 32.0f, 32.0f };
+		std::vector<navigation::tile::Footprint> footprints;
+
+		FootprintMap() :
+			map(Size, 25, 777u)
+		{
+			tileset.Register(0, std::make_unique<component::tile::WalkableTile>());
+			tileset.Register(1, std::make_unique<component::tile::ObstacleTile>());
+			layer.SetSize({ Size, Size });
+			for (int row = 0; row < Size; ++row)
+			{
+				for (int col = 0; col < Size; ++col)
+				{
+					layer.SetTileInstance(row, col, { map.IsWalkable(row, col) ? 0 : 1 });
+				}
+			}
+
+			// footprints a bit smaller than a tile, spread over the map at off grid positions
+			for (int i = 0; i < 256; ++i)
+			{
+				float x = 16.0f + static_cast<float>((i * 37) % (Size - 2)) * tileSize.width + static_cast<float>(i % 7) * 3.0f;
+				float y = 16.0f + static_cast<float>((i * 53) % (Size - 2)) * tileSize.height + static_cast<float>(i % 5) * 4.0f;
+				footprints.push_back({ { x, y }, { 24.0f, 20.0f }, navigation::tile::Anchor::Center });
+			}
+		}
+
+		navigation::tile::FootprintResolver MakeResolver() const
+		{
+			return navigation::tile::FootprintResolver(
+				[this](int row, int col) { return component::tile::IsWalkable(layer, tileset, row, col); },
+				0.1f, 12.0f, 10.0f, true
+			);
+		}
+	};
+}
+
+// a*
+BENCHMARK("astar/list/64_open") { FindPath<navigation::tile::PathFinder>(state, 64, 0); }
+BENCHMARK("astar/list/64_obstacles") { FindPath<navigation::tile::PathFinder>(state, 64, 25); }
+BENCHMARK("astar/priority_queue/64_open") { FindPath<navigation::tile::PathFinderUsingPriorityQueue>(state, 64, 0); }
+BENCHMARK("astar/priority_queue/64_obstacles") { FindPath<navigation::tile::PathFinderUsingPriorityQueue>(state, 64, 25); }
+BENCHMARK("astar/priority_queue/256_obstacles") { FindPath<navigation::tile::PathFinderUsingPriorityQueue>(state, 256, 25); }
+
+// footprint
+BENCHMARK("footprint/is_valid/256")
+{
+	FootprintMap map;
+	navigation::tile::FootprintResolver resolver = map.MakeResolver();
+
+	state.SetItemsPerOp(map.footprints.size());
+	state.Run([&]()
+		{
+			int valid = 0;
+			for (const navigation::tile::Footprint& footprint : map.footprints)
+			{
+				valid += resolver.IsValid(map.layer, map.tileSize, footprint) ? 1 : 0;
+			}
+			benchmark::DoNotOptimize(valid);
+		});
+}
+
+BENCHMARK("footprint/try_resolve/256")
+{
+	FootprintMap map;
+	navigation::tile::FootprintResolver resolver = map.MakeResolver();
+
+	state.SetItemsPerOp(map.footprints.size());
+	state.Run([&]()
+		{
+			int resolved = 0;
+			navigation::tile::Footprint result;
+			for (const navigation::tile::Footprint& footprint : map.footprints)
+			{
+				resolved += resolver.TryResolve(map.layer, map.tileSize, footprint, result) ? 1 : 0;
+			}
+			benchmark::DoNotOptimize(resolved);
+		});
+}
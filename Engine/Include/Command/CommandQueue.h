@@ -0,0 +1,209 @@
+#pragma once
+#include <Command/ICommand.h>
+#include <Command/FrameArena.h>
+#include <vector>
+#include <memory>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <stdexcept>
+#include <type_traits>
+#include <Performance/Profiler.h>
+
+namespace engine
+{
+	namespace command
+	{
+		// command recorder owned by one worker thread.
+		// design consideration:
+		//	-	commands are constructed in place in a FrameArena, so recording is a pointer bump instead of a heap
+		//		allocation per command
+		//	-	commands are kept per type in record order, with one arena per type. destructors run and the arena
+		//		is reset when their type is cleared, so one type can be swapped or cleared without touching others
+		//	-	not thread safe by itself. one buffer belongs to one worker at a time, which is what makes recording
+		//		lock free
+		class CommandBuffer
+		{
+		private:
+			std::array<FrameArena, TypeCount> m_arenas;
+			std::array<std::vector<ICommand*>, TypeCount> m_commands;
+			std::array<uint64_t, TypeCount> m_versions = {};
+			size_t m_count = 0;
+
+		public:
+			CommandBuffer() = default;
+			~CommandBuffer();
+
+			CommandBuffer(const CommandBuffer&) = delete;
+			CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+			// constructs a command of type T in the buffer. T is any ICommand with a static constexpr Type CommandType,
+			// the arena of its type is picked before it is constructed
+			template<typename T, typename... Args>
+			T& Record(Args&&... args)
+			{
+				static_assert(std::is_base_of<ICommand, T>::value, "CommandBuffer can only record ICommand types");
+
+				constexpr size_t index = static_cast<size_t>(T::CommandType);
+				T* command = m_arenas[index].Construct<T>(std::forward<Args>(args)...);
+				m_commands[index].push_back(command);
+				++m_versions[index];
+				++m_count;
+				return *command;
+			}
+
+			// executes recorded commands of type in record order
+			void Execute(Type type) const;
+
+			// exchanges commands of type and their arena with other, other types stay where they are
+			void Swap(Type type, CommandBuffer& other);
+
+			void Clear(Type type);
+			void Clear();
+
+			bool IsEmpty() const
+			{
+				return m_count == 0;
+			}
+
+			size_t GetSize(Type type) const
+			{
+				return m_commands[static_cast<size_t>(type)].size();
+			}
+
+			// moves on whenever commands of type are recorded, cleared or swapped
+			uint64_t GetVersion(Type type) const
+			{
+				return m_versions[static_cast<size_t>(type)];
+			}
+		};
+
+		// design consideration:
+		//	-	main thread enqueues heap allocated commands with Enqueue, same as before
+		//	-	per frame commands (text labels, overlay quads) should be recorded with Record instead. they are
+		//		constructed in a FrameArena, so recording costs a pointer bump instead of a malloc and clearing
+		//		costs nothing instead of a free per command. there is one arena per command type, it is reset as a
+		//		whole when its type is cleared, e.g. by Dispatch(type, true)
+		//	-	arena reset runs no destructors, so Record only takes trivially destructible types. this is checked
+		//		at compile time. that rules out ICommand (virtual destructor) and std::string members: recorded
+		//		commands are plain structs with Execute and a CommandType, text is copied with CopyString
+		//	-	enqueued and recorded commands of a type run in submission order. both are executed through a
+		//		function pointer, enqueued ones then make their virtual call
+		//	-	systems that run on worker threads (actor updates, tile culling) record into a worker buffer instead.
+		//		SetWorkerCount creates the buffers up front on main thread, so getting one is a plain index and
+		//		recording needs no lock. each worker uses its own index, for jobs that is
+		//		job::JobSystem::GetCurrentWorker (main thread 0, workers 1..n), so size it worker count + 1
+		//	-	Dispatch merges deterministically: main queue commands first, then worker buffers by worker index.
+		//		order does not depend on which thread finished first
+		//	-	worker buffers must not be recorded into while Dispatch runs. record during update, dispatch after
+		//		workers are done
+		class CommandQueue
+		{
+		private:
+			struct Entry
+			{
+				void (*execute)(void*);
+				void* command;
+			};
+
+			template<typename T>
+			static void ExecuteCommand(void* command)
+			{
+				static_cast<T*>(command)->Execute();
+			}
+
+			std::array<std::vector<Entry>, TypeCount> m_entries;
+			std::array<std::vector<std::unique_ptr<ICommand>>, TypeCount> m_owned;
+
+			std::array<FrameArena, TypeCount> m_arenas;
+
+			// per type, moves on with every change. also holds versions of worker buffers that were removed, so
+			// GetVersion never goes back
+			std::array<uint64_t, TypeCount> m_versions = {};
+
+			std::vector<std::unique_ptr<CommandBuffer>> m_workerBuffers;
+
+		public:
+			virtual ~CommandQueue() = default;
+
+			void Enqueue(std::unique_ptr<ICommand> command)
+			{
+				const size_t index = static_cast<size_t>(command->GetType());
+				m_entries[index].push_back({ &ExecuteCommand<ICommand>, command.get() });
+				m_owned[index].push_back(std::move(command));
+				++m_versions[index];
+			}
+
+			// constructs a frame command of type T in the arena. T needs a void Execute() and a
+			// static constexpr Type CommandType. returned reference is valid until the command is cleared
+			template<typename T, typename... Args>
+			T& Record(Args&&... args)
+			{
+				static_assert(std::is_trivially_destructible<T>::value,
+					"CommandQueue::Record needs trivially destructible commands, the arena is reset without running destructors");
+
+				constexpr size_t index = static_cast<size_t>(T::CommandType);
+				T* command = m_arenas[index].Construct<T>(std::forward<Args>(args)...);
+				m_entries[index].push_back({ &ExecuteCommand<T>, command });
+				++m_versions[index];
+				return *command;
+			}
+
+			// copies text for a recorded command of type. view is valid until type is cleared
+			std::string_view CopyString(std::string_view text, Type type = Type::Render)
+			{
+				return m_arenas[static_cast<size_t>(type)].CopyString(text);
+			}
+
+			// creates buffers for workers [0, count). call from main thread while no worker is recording.
+			// existing buffers keep their commands
+			void SetWorkerCount(size_t count)
+			{
+				while (m_workerBuffers.size() < count)
+				{
+					m_workerBuffers.push_back(std::make_unique<CommandBuffer>());
+				}
+				for (size_t worker = count; worker < m_workerBuffers.size(); ++worker)
+				{
+					for (size_t type = 0; type < TypeCount; ++type)
+					{
+						m_versions[type] += m_workerBuffers[worker]->GetVersion(static_cast<Type>(type)) + 1;
+					}
+				}
+				m_workerBuffers.resize(count);
+			}
+
+			size_t GetWorkerCount() const
+			{
+				return m_workerBuffers.size();
+			}
+
+			CommandBuffer& GetWorkerBuffer(size_t worker)
+			{
+				if (worker >= m_workerBuffers.size())
+				{
+					throw std::out_of_range("CommandQueue - invalid worker index");
+				}
+				return *m_workerBuffers[worker];
+			}
+
+			// exchanges commands of type with other, enqueued, recorded and those in worker buffers, without copying
+			// them. used to hand a frame's render commands to render thread. commands of other types stay where they
+			// are. both queues end up with the larger worker count
+			void Swap(Type type, CommandQueue& other);
+
+			void Dispatch(Type type, bool clear = true);
+
+			void Clear(Type type);
+			void Clear();
+
+			virtual bool IsEmpty() const;
+
+			// moves on whenever commands of type are enqueued, recorded, cleared or swapped, in the queue or in a
+			// worker buffer. equal versions mean the same commands
+			uint64_t GetVersion(Type type) const;
+		};
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <type_traits>
+
+namespace engine
+{
+	namespace command
+	{
+		// linear (bump) allocator for objects that live until the end of a frame.
+		// design consideration:
+		//	-	memory comes in blocks of BlockSize bytes. allocating is aligning an offset and bumping it
+		//	-	nothing is freed one by one. Reset rewinds to the first block and all memory is reused, blocks are
+		//		kept, so after the first few frames a frame allocates nothing from the heap
+		//	-	destructors are not run. owners either only put trivially destructible objects in here or destroy
+		//		objects themselves before Reset
+		//	-	not thread safe
+		class FrameArena
+		{
+		private:
+			static constexpr size_t BlockSize = 64 * 1024;
+
+			struct Block
+			{
+				std::unique_ptr<std::byte[]> memory;
+				size_t size;
+			};
+
+			std::vector<Block> m_blocks;
+			size_t m_block = 0;		// block being filled
+			size_t m_offset = 0;	// first free byte in that block
+
+		public:
+			FrameArena() = default;
+
+			FrameArena(const FrameArena&) = delete;
+			FrameArena& operator=(const FrameArena&) = delete;
+
+			// returns size bytes aligned to alignment (power of two). valid until Reset
+			void* Allocate(size_t size, size_t alignment);
+
+			// constructs T in the arena. aggregates are brace initialized. its destructor is never called by the arena
+			template<typename T, typename... Args>
+			T* Construct(Args&&... args)
+			{
+				void* memory = Allocate(sizeof(T), alignof(T));
+				if constexpr (std::is_aggregate<T>::value)
+				{
+					return new (memory) T{ std::forward<Args>(args)... };
+				}
+				else
+				{
+					return new (memory) T(std::forward<Args>(args)...);
+				}
+			}
+
+			// copies text into the arena. returned view is valid until Reset
+			std::string_view CopyString(std::string_view text)
+			{
+				if (text.empty())
+				{
+					return {};
+				}
+				char* copy = static_cast<char*>(Allocate(text.size(), 1));
+				std::memcpy(copy, text.data(), text.size());
+				return { copy, text.size() };
+			}
+
+			// makes all memory available again. keeps blocks
+			void Reset()
+			{
+				m_block = 0;
+				m_offset = 0;
+			}
+
+			// exchanges memory with other. views and objects handed out stay valid, they just belong to other now
+			void Swap(FrameArena& other)
+			{
+				m_blocks.swap(other.m_blocks);
+				std::swap(m_block, other.m_block);
+				std::swap(m_offset, other.m_offset);
+			}
+
+			// bytes reserved in blocks
+			size_t GetCapacity() const;
+		};
+	}
+}
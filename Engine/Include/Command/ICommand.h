@@ -1,6 +1,7 @@
 #pragma once
 #include <Graphics/Renderer/IRenderer.h>
 #include <unordered_map>
+#include <string_view>
 
 namespace engine
 {
@@ -14,6 +15,9 @@ namespace engine
 			Input 
 		};
 
+		// number of command types, for arrays indexed by type
+		constexpr size_t TypeCount = 4;
+
 		class ICommand
 		{
 		public:
@@ -22,60 +26,6 @@ namespace engine
 			virtual Type GetType() const = 0;
 		};
 
-		class CommandQueue
-		{
-		private:
-			std::unordered_map<engine::command::Type, std::vector<std::unique_ptr<ICommand>>> queues;
-
-		public:
-			virtual ~CommandQueue() = default;
-			
-			void Enqueue(std::unique_ptr<ICommand> command)
-			{
-				queues[command->GetType()].emplace_back(std::move(command));
-			}
-
-			void Dispatch(engine::command::Type type, bool clear = true)
-			{
-				auto& queue = queues[type];
-				for (auto& cmd : queue)
-				{
-					cmd->Execute();
-				}
-
-				if (clear)
-				{
-					queue.clear();
-				}
-			}
-
-			void Clear(engine::command::Type type)
-			{
-				auto& queue = queues[type];
-				queue.clear();
-			}
-
-			virtual bool IsEmpty() const
-			{
-				for (const auto& pair : queues)
-				{
-					if (!pair.second.empty())
-					{
-						return false;
-					}
-				}
-				return true;
-			}
-
-			void Clear() 
-			{
-				for (auto& [type, q] : queues)
-				{
-					q.clear();
-				}
-			}
-		};
-
 		namespace graphics
 		{
 			namespace renderer
@@ -83,6 +33,10 @@ namespace engine
 				// base class for all render commands
 				class DrawCommandBase : public ICommand
 				{
+				public:
+					// for CommandBuffer::Record, which picks the arena before constructing
+					static constexpr Type CommandType = Type::Render;
+
 				protected:
 					::graphics::renderer::IRenderer& m_renderer;
 
@@ -187,6 +141,157 @@ namespace engine
 						m_renderer.DrawRenderable(m_renderable, m_pos, m_size, m_color, m_rotation);
 					}
 				};
+
+				// draws a quad between its previous and current simulation state. blend factor is read when the
+				// command executes. record one per simulation step, clearing the one before. render commands stay
+				// on the queue until cleared, so it is drawn in every render frame up to the next step, each time
+				// with that frame's alpha, and motion recorded at simulation rate renders smoothly at display rate.
+				// pass Engine::RenderAlpha, the alpha of the frame being drawn, which is safe to read on render thread
+				class DrawInterpolatedQuadCommand : public DrawCommandBase
+				{
+				private:
+					const float& m_alpha;
+					spatial::PositionF m_previousPos;
+					spatial::PositionF m_pos;
+					spatial::SizeF m_size;
+					::graphics::ColorF m_color;
+					float m_previousRotation;
+					float m_rotation;
+
+				public:
+					DrawInterpolatedQuadCommand(
+						::graphics::renderer::IRenderer& renderer,
+						const float& alpha,
+						spatial::PositionF previousPos,
+						spatial::PositionF pos,
+						spatial::SizeF size,
+						::graphics::ColorF color,
+						float previousRotation,
+						float rotation
+					) :
+						DrawCommandBase(renderer),
+						m_alpha(alpha),
+						m_previousPos(previousPos),
+						m_pos(pos),
+						m_size(size),
+						m_color(color),
+						m_previousRotation(previousRotation),
+						m_rotation(rotation)
+					{
+					}
+
+					void Execute() override
+					{
+						float alpha = m_alpha;
+						m_renderer.Draw(
+							m_previousPos + (m_pos - m_previousPos) * alpha,
+							m_size,
+							m_color,
+							m_previousRotation + (m_rotation - m_previousRotation) * alpha);
+					}
+				};
+
+				class DrawInterpolatedRenderableCommand : public DrawCommandBase
+				{
+				private:
+					const ::graphics::renderable::IRenderable& m_renderable;
+					const float& m_alpha;
+					spatial::PositionF m_previousPos;
+					spatial::PositionF m_pos;
+					spatial::SizeF m_size;
+					::graphics::ColorF m_color;
+					float m_previousRotation;
+					float m_rotation;
+
+				public:
+					DrawInterpolatedRenderableCommand(
+						::graphics::renderer::IRenderer& renderer,
+						const ::graphics::renderable::IRenderable& renderable,
+						const float& alpha,
+						spatial::PositionF previousPos,
+						spatial::PositionF pos,
+						spatial::SizeF size,
+						::graphics::ColorF color,
+						float previousRotation,
+						float rotation
+					) :
+						DrawCommandBase(renderer),
+						m_renderable(renderable),
+						m_alpha(alpha),
+						m_previousPos(previousPos),
+						m_pos(pos),
+						m_size(size),
+						m_color(color),
+						m_previousRotation(previousRotation),
+						m_rotation(rotation)
+					{
+					}
+
+					void Execute() override
+					{
+						float alpha = m_alpha;
+						m_renderer.DrawRenderable(
+							m_renderable,
+							m_previousPos + (m_pos - m_previousPos) * alpha,
+							m_size,
+							m_color,
+							m_previousRotation + (m_rotation - m_previousRotation) * alpha);
+					}
+				};
+
+				// frame commands for CommandQueue::Record. same draws as above, but plain structs without a virtual
+				// destructor or owning members, so they can live in the queue's arena and are dropped without cleanup
+
+				struct DrawQuadFrameCommand
+				{
+					static constexpr Type CommandType = Type::Render;
+
+					::graphics::renderer::IRenderer& renderer;
+					spatial::PositionF pos;
+					spatial::SizeF size;
+					::graphics::ColorF color;
+					float rotation;
+
+					void Execute() const
+					{
+						renderer.Draw(pos, size, color, rotation);
+					}
+				};
+
+				// text must stay valid until the command is cleared. pass a view from CommandQueue::CopyString or a
+				// string literal
+				struct DrawTextFrameCommand
+				{
+					static constexpr Type CommandType = Type::Render;
+
+					::graphics::renderer::IRenderer& renderer;
+					const ::graphics::renderable::IFontAtlas& font;
+					std::string_view text;
+					spatial::PositionF pos;
+					::graphics::ColorF color;
+
+					void Execute() const
+					{
+						renderer.DrawText(font, text, pos, color);
+					}
+				};
+
+				struct DrawRenderableFrameCommand
+				{
+					static constexpr Type CommandType = Type::Render;
+
+					::graphics::renderer::IRenderer& renderer;
+					const ::graphics::renderable::IRenderable& renderable;
+					spatial::PositionF pos;
+					spatial::SizeF size;
+					::graphics::ColorF color;
+					float rotation;
+
+					void Execute() const
+					{
+						renderer.DrawRenderable(renderable, pos, size, color, rotation);
+					}
+				};
 			};
 		}
 	}
@@ -0,0 +1,106 @@
+#pragma once
+#include <Command/CommandQueue.h>
+#include <Command/RenderQueue.h>
+#include <Command/RenderList.h>
+#include <array>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+
+namespace engine
+{
+	namespace command
+	{
+		// hands frames from simulation thread to render thread.
+		// design consideration:
+		//	-	a ring of 2 (double buffered) or 3 (triple buffered) frames. each frame owns the draw packets of one
+		//		rendered frame, and the render commands if they changed since the frame before. simulation fills
+		//		frame N+1 while render thread executes frame N
+		//	-	frames go round in order: free -> filled by simulation -> ready -> rendered -> free. render thread
+		//		always takes the oldest ready frame, nothing is skipped or rendered twice
+		//	-	back-pressure: BeginSubmit waits while no frame is free, i.e. when render thread is Count - 1 frames
+		//		behind. simulation can never run further ahead than that, so latency stays bounded and no frame is
+		//		dropped. double buffering lets simulation be one frame ahead, triple buffering two
+		//	-	one producer and one consumer. the mutex is taken twice per frame on each side, never per command
+		//	-	frames keep their allocations (command arena, packet vectors, retained runs) when recycled, steady
+		//		state allocates nothing
+		class RenderFrameQueue
+		{
+		public:
+			static constexpr size_t MaxCount = 3;
+
+			struct Frame
+			{
+				CommandQueue commands;		// render commands, only if newCommands is set
+				RenderQueue packets;
+				RenderList list;			// runs of engine's render list, copied only when they changed
+				float delta = 0.0f;			// render frame time the frame was submitted with
+				float alpha = 1.0f;			// simulation's interpolation alpha when the frame was submitted
+				bool newCommands = false;	// commands replace the set render thread draws. otherwise it keeps drawing that one
+				uint64_t number = 0;		// submission order, starts at 1
+			};
+
+			struct Statistics
+			{
+				uint64_t submitted = 0;		// frames handed to render thread
+				uint64_t rendered = 0;		// frames render thread finished
+				uint64_t stalls = 0;		// submits that had to wait for a free frame
+				float stallTime = 0.0f;		// seconds simulation spent waiting in total
+				float maxStallTime = 0.0f;	// longest single wait
+			};
+
+		private:
+			std::array<Frame, MaxCount> m_frames;
+			size_t m_count;
+
+			// ring positions. frames [m_renderIndex, m_submitIndex) are ready or being rendered
+			size_t m_submitIndex = 0;	// next frame simulation fills
+			size_t m_renderIndex = 0;	// next frame render thread takes
+			size_t m_inFlight = 0;		// ready plus being rendered
+			bool m_filling = false;
+			bool m_rendering = false;
+			bool m_stopped = false;
+			uint64_t m_number = 0;
+
+			Statistics m_statistics;
+
+			mutable std::mutex m_mutex;
+			std::condition_variable m_frameFree;
+			std::condition_variable m_frameReady;
+
+		public:
+			// count is clamped to 2..3
+			explicit RenderFrameQueue(size_t count = 2);
+
+			RenderFrameQueue(const RenderFrameQueue&) = delete;
+			RenderFrameQueue& operator=(const RenderFrameQueue&) = delete;
+
+			// simulation side. waits until a frame is free and returns it for filling, nullptr once stopped
+			Frame* BeginSubmit();
+
+			// simulation side. hands the frame from BeginSubmit to render thread
+			void EndSubmit(float delta, float alpha);
+
+			// render side. waits for the oldest ready frame, nullptr once stopped
+			Frame* Acquire();
+
+			// render side. frame from Acquire is rendered, it can be filled again
+			void Release();
+
+			// wakes both sides. frames not yet rendered are dropped, window and canvas may already be going away
+			void Stop();
+
+			size_t GetCount() const
+			{
+				return m_count;
+			}
+
+			Statistics GetStatistics() const
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				return m_statistics;
+			}
+		};
+	}
+}
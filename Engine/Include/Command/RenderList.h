@@ -0,0 +1,192 @@
+#pragma once
+#include <Graphics/Renderer/IRenderer.h>
+#include <Graphics/Renderer/SpriteInstance.h>
+#include <Graphics/Renderable/IFontAtlas.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace engine
+{
+	namespace command
+	{
+		// retained draw items. for content that stays on screen across frames (static UI, labels, world decoration)
+		// instead of recording the same commands or packets again every frame.
+		// design consideration:
+		//	-	items are added once and addressed by handle afterwards. they can be moved, recolored, given another
+		//		sprite or text, hidden or removed in place. handles carry a generation, same as SpatialIndex, so a
+		//		handle of a removed item does not alias a new item that reuses its slot
+		//	-	items are kept as sprite instances relative to their position, grouped into runs by layer, texture
+		//		and color. a run is one IRenderer::DrawRetained call. runs are drawn by layer, then in the order they
+		//		were created
+		//	-	dirty tracking is per run. changing an item marks its run dirty, only dirty runs are rebuilt and get
+		//		a new version. setters that do not change anything mark nothing, so setting the same position every
+		//		update costs a compare
+		//	-	runs have a process wide unique id. renderers that keep instance data on the GPU (DX11 batch) key
+		//		their buffers by it and upload a run again only when its version changed. on a frame where nothing
+		//		changed, drawing the list is one bind and one draw call per run with no packing and no upload
+		//	-	a run whose last item left (removed, recolored, moved to another layer or texture) is freed. its slot
+		//		is reused by the next new run with a new id, and its id is handed to IRenderer::ReleaseRetained on
+		//		next Draw, so neither the list nor the renderer grows with items that keep changing color
+		//	-	with render thread, the list is copied into the render frame with CopyTo. only runs whose version
+		//		differs from the frame's copy are copied, unchanged runs cost a compare
+		//	-	list keeps pointers to renderables and fonts. they must outlive the items drawn with them
+		//	-	not thread safe. change and draw it from one thread, or copy it over as described above
+		class RenderList
+		{
+		public:
+			struct Handle
+			{
+				uint32_t index = 0xffffffff;
+				uint32_t generation = 0;
+
+				bool IsValid() const
+				{
+					return index != 0xffffffff;
+				}
+
+				bool operator==(const Handle& other) const
+				{
+					return index == other.index && generation == other.generation;
+				}
+
+				bool operator!=(const Handle& other) const
+				{
+					return !(*this == other);
+				}
+			};
+
+		private:
+			struct Item
+			{
+				const ::graphics::renderable::IRenderable* renderable = nullptr;
+				spatial::PositionF pos;
+				::graphics::ColorF color = {};
+				uint8_t layer = 0;
+				bool visible = true;
+				bool alive = false;
+				uint32_t generation = 0;
+				uint32_t run = 0;
+				std::vector<::graphics::renderer::SpriteInstance> instances;	// relative to pos
+			};
+
+			struct Run
+			{
+				uint64_t id = 0;
+				uint64_t version = 0;
+				const ::graphics::renderable::IRenderable* renderable = nullptr;	// binds the texture of the run
+				const void* bindKey = nullptr;
+				::graphics::ColorF color = {};
+				uint8_t layer = 0;
+				bool alive = false;
+				bool dirty = false;
+				std::vector<uint32_t> items;									// in add order
+				std::vector<::graphics::renderer::SpriteInstance> instances;	// built from visible items
+			};
+
+			std::vector<Item> m_items;
+			std::vector<uint32_t> m_freeItems;
+			size_t m_count = 0;
+
+			std::vector<Run> m_runs;
+			std::vector<uint32_t> m_freeRuns;
+			std::vector<uint32_t> m_order;	// live runs sorted by layer, then creation
+			std::vector<uint64_t> m_released;	// ids of freed runs, released on renderer by next Draw
+			bool m_orderDirty = false;
+			bool m_dirty = false;			// any run is dirty
+
+			Item* Find(const Handle handle);
+			const Item* Find(const Handle handle) const;
+
+			// run for layer, texture and color. created if there is none yet
+			uint32_t GetRun(const ::graphics::renderable::IRenderable& renderable, const ::graphics::ColorF color, const uint8_t layer);
+
+			void Attach(uint32_t index);
+			void Detach(uint32_t index);
+			void FreeRun(uint32_t index);
+			void MarkDirty(uint32_t run);
+
+			Handle Add(
+				const ::graphics::renderable::IRenderable& renderable,
+				const spatial::PositionF pos,
+				const ::graphics::ColorF color,
+				const uint8_t layer
+			);
+
+			// replaces item's quads. moves it to another run if texture changed
+			void SetInstances(Item& item, uint32_t index, const ::graphics::renderable::IRenderable& renderable);
+
+			static void LayoutSprite(const ::graphics::renderable::IRenderable& renderable, const spatial::SizeF size, std::vector<::graphics::renderer::SpriteInstance>& instances);
+			static void LayoutText(const ::graphics::renderable::IFontAtlas& font, const std::string& text, std::vector<::graphics::renderer::SpriteInstance>& instances);
+
+		public:
+			RenderList() = default;
+			~RenderList() = default;
+
+			RenderList(const RenderList&) = delete;
+			RenderList& operator=(const RenderList&) = delete;
+
+			// sprite of size at pos. uv is taken from renderable
+			Handle AddSprite(
+				const ::graphics::renderable::IRenderable& renderable,
+				const spatial::PositionF pos,
+				const spatial::SizeF size,
+				const ::graphics::ColorF color,
+				const uint8_t layer = 0
+			);
+
+			// text laid out once from the font's glyphs, pos is its top-left corner
+			Handle AddText(
+				const ::graphics::renderable::IFontAtlas& font,
+				const std::string& text,
+				const spatial::PositionF pos,
+				const ::graphics::ColorF color,
+				const uint8_t layer = 0
+			);
+
+			// setters return false if handle does not refer to a live item
+			bool SetPosition(const Handle handle, const spatial::PositionF pos);
+			bool SetColor(const Handle handle, const ::graphics::ColorF color);
+			bool SetLayer(const Handle handle, const uint8_t layer);
+			bool SetVisible(const Handle handle, const bool visible);
+			bool SetSprite(const Handle handle, const ::graphics::renderable::IRenderable& renderable, const spatial::SizeF size);
+			bool SetText(const Handle handle, const ::graphics::renderable::IFontAtlas& font, const std::string& text);
+
+			bool Remove(const Handle handle);
+
+			bool IsValid(const Handle handle) const
+			{
+				return Find(handle) != nullptr;
+			}
+
+			// rebuilds dirty runs. called by Draw and CopyTo
+			void Build();
+
+			// one DrawRetained call per non empty run. must be called between renderer's Begin and End
+			void Draw(::graphics::renderer::IRenderer& renderer);
+
+			// copies runs into target, e.g. a frame handed to render thread. runs target already has in the same
+			// version are not copied again. target is only good for drawing afterwards, its own items are dropped
+			void CopyTo(RenderList& target);
+
+			// removes all items. handles from before stay invalid, runs get new ids if items are added again
+			void Clear();
+
+			size_t GetSize() const
+			{
+				return m_count;
+			}
+
+			bool IsEmpty() const
+			{
+				return m_count == 0;
+			}
+
+			size_t GetRunCount() const
+			{
+				return m_runs.size() - m_freeRuns.size();
+			}
+		};
+	}
+}
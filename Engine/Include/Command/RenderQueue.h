@@ -0,0 +1,167 @@
+#pragma once
+#include <Graphics/Renderer/IRenderer.h>
+#include <Spatial/SpatialIndex.h>
+#include <Spatial/Camera.h>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+namespace engine
+{
+	namespace command
+	{
+		// render specific command queue made of flat draw packets that are sorted before dispatch.
+		// design consideration:
+		//	-	packets are POD and stored by value in a vector. no allocation per draw and no virtual call per draw
+		//		(unlike ICommand). text is copied into a shared character buffer
+		//	-	every packet has a 64 bit sort key: layer (8 bits) | bind id (24 bits) | depth (32 bits)
+		//		-	layer is the explicit draw order. layer 0 is drawn first
+		//		-	bind id groups draws by texture within a layer, so batch renderers only flush when texture changes
+		//			instead of every time submission order alternates between textures
+		//		-	depth orders draws within same layer and texture. lower depth is drawn first
+		//		-	untextured quads have bind id 0 so they are drawn before textured draws of the same layer
+		//		-	draws that must keep their relative order across textures (e.g. overlapping sprites from different
+		//			atlases) need to be put on different layers
+		//	-	sort is a stable LSD radix sort on (key, index) pairs. equal keys keep submission order. byte passes
+		//		where all keys are equal are skipped, so typical frames (few layers, few textures) need 2-4 passes
+		//	-	Dispatch does not clear, same as engine's dispatch of CommandQueue render commands (with or without
+		//		render thread). packets stay until the application clears them, so they can be submitted at update
+		//		rate and dispatched multiple times at render rate. queue is sorted only once after it changes
+		//	-	world objects can live in a WorldIndex (spatial index of world renderables). SubmitVisible queries it
+		//		with camera's visible rect, so only objects on screen become packets
+		class RenderQueue
+		{
+		public:
+			enum class PacketType : uint8_t
+			{
+				Quad,
+				Renderable,
+				Text,
+				Char,
+			};
+
+			// renderable placed in world space. its world rect is kept by the index
+			struct WorldRenderable
+			{
+				const ::graphics::renderable::IRenderable* renderable;
+				::graphics::ColorF color;
+				float rotation;
+				uint8_t layer;
+				float depth;
+			};
+
+			using WorldIndex = spatial::SpatialIndex<WorldRenderable>;
+
+			struct Packet
+			{
+				uint64_t key;
+				const ::graphics::renderable::IRenderable* renderable; // font atlas for text and char
+				float x, y;
+				float width, height;
+				::graphics::ColorF color;
+				float rotation;
+				uint32_t textOffset;	// character for char packets
+				uint32_t textLength;
+				PacketType type;
+			};
+
+		private:
+			struct SortEntry
+			{
+				uint64_t key;
+				uint32_t index;
+			};
+
+			std::vector<Packet> m_packets;
+			std::vector<char> m_text;
+
+			// sort buffers. kept between frames to avoid allocation
+			std::vector<SortEntry> m_sorted;
+			std::vector<SortEntry> m_scratch;
+			bool m_dirty = false;
+
+			// bind ids are assigned on first sight and stay stable while queue lives. 0 is reserved for no texture
+			std::unordered_map<const void*, uint32_t> m_bindIds;
+			const void* m_lastBindKey = nullptr;
+			uint32_t m_lastBindId = 0;
+
+			uint32_t GetBindId(const ::graphics::renderable::IRenderable& renderable);
+			void Push(const Packet& packet);
+
+		public:
+			static constexpr uint32_t MaxBindId = 0xffffff;
+
+			RenderQueue() = default;
+			~RenderQueue() = default;
+
+			// makes a sort key. depth is any float, it is mapped to an order preserving unsigned integer
+			static uint64_t MakeKey(uint8_t layer, uint32_t bindId, float depth);
+
+			void SubmitQuad(
+				const spatial::PositionF pos,
+				const spatial::SizeF size,
+				const ::graphics::ColorF color,
+				const float rotation,
+				const uint8_t layer = 0,
+				const float depth = 0
+			);
+
+			void SubmitRenderable(
+				const ::graphics::renderable::IRenderable& renderable,
+				const spatial::PositionF pos,
+				const spatial::SizeF size,
+				const ::graphics::ColorF color,
+				const float rotation,
+				const uint8_t layer = 0,
+				const float depth = 0
+			);
+
+			void SubmitText(
+				const ::graphics::renderable::IFontAtlas& font,
+				const std::string& text,
+				const spatial::PositionF pos,
+				const ::graphics::ColorF color,
+				const uint8_t layer = 0,
+				const float depth = 0
+			);
+
+			void SubmitChar(
+				const ::graphics::renderable::IFontAtlas& font,
+				const unsigned char character,
+				const spatial::PositionF pos,
+				const ::graphics::ColorF color,
+				const float rotation,
+				const uint8_t layer = 0,
+				const float depth = 0
+			);
+
+			// submits world renderables that overlap camera's visible rect. positions are converted to screen space.
+			// returns number of submitted renderables
+			size_t SubmitVisible(const WorldIndex& world, const spatial::CameraF& camera);
+
+			// sorts packets by key. called by Dispatch if needed
+			void Sort();
+
+			// sends packets to renderer in sorted order. must be called between renderer's Begin and End
+			void Dispatch(::graphics::renderer::IRenderer& renderer);
+
+			void Clear();
+
+			// copies packets into target, e.g. a frame handed to render thread. this queue keeps its packets, so
+			// draws submitted once keep being drawn, same as when dispatching this queue directly. target keeps its
+			// buffers, copying into it does not allocate once they are big enough
+			void CopyTo(RenderQueue& target) const;
+
+			size_t GetSize() const
+			{
+				return m_packets.size();
+			}
+
+			bool IsEmpty() const
+			{
+				return m_packets.empty();
+			}
+		};
+	}
+}
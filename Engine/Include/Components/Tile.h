@@ -3,6 +3,8 @@
 // tilelayer also represents logic tiles such as walkable, obstacle, etc...
 // tilelayer is composed of a list of tileregions, which are chunks of the map
 // tileregion is a chunk of a map and is composed of tilegrid
+// tileregion also keeps a render list of its tiles. it is rebuilt only when one of its tiles is set, so drawing a region
+// costs one renderer call per texture instead of one per tile
 // tilegrid contains 2d array of tiles
 //
 // tilelayer loader
@@ -24,6 +26,7 @@
 #include <Spatial/Size.h>
 #include <Cache/Dictionary.h>
 #include <Core/View.h>
+#include <Components/TileRenderList.h>
 #include <vector>
 #include <memory>
 #include <stdexcept>
@@ -273,12 +276,18 @@ namespace component::tile
 		
 	};
 
+	// chunk of a tile layer. besides the tiles it keeps a render list that is rebuilt only after a tile changes
 	template<typename T>
 	class TileRegion
 	{
 	private:
 		TileGrid<T> m_tilegrid;
 
+		// render cache. built on demand, so regions that are never seen never build one
+		mutable TileRenderList m_renderList;
+		mutable spatial::SizeF m_renderListTileSize = { 0.0f, 0.0f };
+		mutable bool m_renderListDirty = true;
+
 		friend class TileLayer<T>;
 
 		TileRegion(spatial::Size<int> size)
@@ -290,6 +299,7 @@ namespace component::tile
 		inline void SetTile(int row, int col, Tile<T> tile)
 		{
 			m_tilegrid.SetTile(row, col, tile);
+			m_renderListDirty = true;
 		}
 
 		const Tile<T>& GetTile(int row, int col) const
@@ -302,21 +312,78 @@ namespace component::tile
 			return m_tilegrid.GetTile(coord);
 		}
 
+		int GetWidth() const
+		{
+			return m_tilegrid.GetWidth();
+		}
+
+		int GetHeight() const
+		{
+			return m_tilegrid.GetHeight();
+		}
+
+		// forces a rebuild on next GetRenderList. use it when tile data changed its sprite without SetTile
+		void InvalidateRenderList()
+		{
+			m_renderListDirty = true;
+		}
+
+		bool IsRenderListDirty() const
+		{
+			return m_renderListDirty;
+		}
+
+		// returns render list of this region, building it first if a tile changed since last build.
+		// getRenderable maps tile data to what is drawn (const IRenderable* or nullptr to skip the tile).
+		// positions in the list are relative to region's top-left corner
+		template<typename GetRenderable>
+		const TileRenderList& GetRenderList(const spatial::SizeF& tileSize, GetRenderable getRenderable) const
+		{
+			if (m_renderListDirty || m_renderListTileSize.width != tileSize.width || m_renderListTileSize.height != tileSize.height)
+			{
+				m_renderList.BeginBuild();
+				for (int row = 0; row < m_tilegrid.GetHeight(); ++row)
+				{
+					for (int col = 0; col < m_tilegrid.GetWidth(); ++col)
+					{
+						const Tile<T>& tile = m_tilegrid.GetTile(row, col);
+						if (!tile.isValid())
+						{
+							continue;
+						}
+
+						const graphics::renderable::IRenderable* renderable = getRenderable(*tile);
+						if (renderable)
+						{
+							m_renderList.Add(*renderable, col * tileSize.width, row * tileSize.height, tileSize.width, tileSize.height);
+						}
+					}
+				}
+				m_renderList.EndBuild();
+
+				m_renderListTileSize = tileSize;
+				m_renderListDirty = false;
+			}
+
+			return m_renderList;
+		}
 	};
 
 	template<typename T>
 	class TileLayer
 	{
 	private:
-		std::vector<TileRegion<T>> m_regions;
-
+		// size in regions
 		spatial::Size<int> m_size;
 
+		// size of each region in tiles
 		spatial::Size<int> m_regionSize;
 
+		std::vector<TileRegion<T>> m_regions;
+
 	public:
 		TileLayer(int rows, int cols, spatial::Size<int> regionSize): 
-			m_size({rows, cols}),
+			m_size({ cols, rows }),
 			m_regionSize(regionSize),
 			m_regions(rows * cols, TileRegion<T>(regionSize)) 
 		{
@@ -336,6 +403,26 @@ namespace component::tile
 			return m_regions[row * m_size.width + col];
 		}
 
+		TileRegion<T>& GetRegion(int row, int col)
+		{
+			if (!IsInBounds(row, col))
+			{
+				throw std::out_of_range("TileRegion::GetRegion - index out of bounds");
+			}
+			return m_regions[row * m_size.width + col];
+		}
+
+		// size in regions
+		spatial::Size<int> GetSize() const
+		{
+			return m_size;
+		}
+
+		spatial::Size<int> GetRegionSize() const
+		{
+			return m_regionSize;
+		}
+
 		const component::tile::Tile<T>& GetTile(int worldRow, int worldCol) 
 		{
 			int regionRow = worldRow / m_regionSize.height;
@@ -346,6 +433,7 @@ namespace component::tile
 			return GetRegion(regionRow, regionCol).GetTile(localRow, localCol);
 		}
 
+		// only the region holding this tile has to rebuild its render list
 		void SetTile(int worldRow, int worldCol, component::tile::Tile<T> tile) 
 		{
 			int regionRow = worldRow / m_regionSize.height;
@@ -357,4 +445,3 @@ namespace component::tile
 		}
 	};
 }
-
@@ -0,0 +1,116 @@
+#pragma once
+#include <Graphics/Renderer/IRenderer.h>
+#include <Graphics/Renderable/IRenderable.h>
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+
+namespace component::tile
+{
+	// pre-built draw data of one tile region.
+	// design consideration:
+	//	-	tiles are stored as sprite instances (local position, size, uv) relative to region's top-left corner,
+	//		so drawing a region is one DrawInstances call per texture plus a screen offset
+	//	-	instances are grouped into runs by bind key (texture). a region made from one tileset is one run
+	//	-	list is built by TileRegion when it is dirty and is immutable otherwise. it keeps pointers to
+	//		renderables owned by the tileset, so tileset must outlive the regions that were built from it
+	class TileRenderList
+	{
+	public:
+		// instances [first, first + count) share the texture bound by renderable
+		struct Run
+		{
+			const graphics::renderable::IRenderable* renderable;
+			size_t first;
+			size_t count;
+		};
+
+	private:
+		struct Pending
+		{
+			size_t run;
+			graphics::renderer::SpriteInstance instance;
+		};
+
+		std::vector<graphics::renderer::SpriteInstance> m_instances;
+		std::vector<Run> m_runs;
+
+		// build state. kept to reuse memory between rebuilds
+		std::vector<Pending> m_pending;
+		std::unordered_map<const void*, size_t> m_runIndex;
+
+	public:
+		TileRenderList() = default;
+		~TileRenderList() = default;
+
+		void BeginBuild()
+		{
+			m_instances.clear();
+			m_runs.clear();
+			m_pending.clear();
+			m_runIndex.clear();
+		}
+
+		void Add(const graphics::renderable::IRenderable& renderable, float x, float y, float width, float height)
+		{
+			auto it = m_runIndex.find(renderable.GetBindKey());
+			if (it == m_runIndex.end())
+			{
+				it = m_runIndex.emplace(renderable.GetBindKey(), m_runs.size()).first;
+				m_runs.push_back({ &renderable, 0, 0 });
+			}
+
+			++m_runs[it->second].count;
+			m_pending.push_back({ it->second, { x, y, width, height, renderable.GetUVRect() } });
+		}
+
+		// lays out pending instances run by run. run order is first seen order
+		void EndBuild()
+		{
+			size_t offset = 0;
+			for (Run& run : m_runs)
+			{
+				run.first = offset;
+				offset += run.count;
+			}
+
+			m_instances.resize(offset);
+			std::vector<size_t> cursor(m_runs.size());
+			for (size_t i = 0; i < m_runs.size(); ++i)
+			{
+				cursor[i] = m_runs[i].first;
+			}
+
+			for (const Pending& pending : m_pending)
+			{
+				m_instances[cursor[pending.run]++] = pending.instance;
+			}
+
+			m_pending.clear();
+		}
+
+		// one renderer call per run. offset is the screen position of region's top-left corner
+		void Draw(graphics::renderer::IRenderer& renderer, const spatial::PositionF offset, const graphics::ColorF color) const
+		{
+			for (const Run& run : m_runs)
+			{
+				renderer.DrawInstances(*run.renderable, m_instances.data() + run.first, run.count, offset, color);
+			}
+		}
+
+		const std::vector<graphics::renderer::SpriteInstance>& GetInstances() const
+		{
+			return m_instances;
+		}
+
+		const std::vector<Run>& GetRuns() const
+		{
+			return m_runs;
+		}
+
+		bool IsEmpty() const
+		{
+			return m_instances.empty();
+		}
+	};
+}
@@ -0,0 +1,424 @@
+#pragma once
+#include <Core/Event.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace event
+{
+    namespace detail
+    {
+        // how many concurrent event invocations the calling thread is inside of. a thread that is inside one must
+        // not wait for readers to finish, it would wait for itself (or for a thread that waits for it)
+        inline uint32_t& ConcurrentInvokeDepth()
+        {
+            static thread_local uint32_t depth = 0;
+            return depth;
+        }
+    }
+
+    // event that can be invoked from any thread while other threads subscribe and unsubscribe.
+    // design consideration:
+    //  -   subscribers are kept in an immutable snapshot. invoking loads the current snapshot and walks it,
+    //      no lock is taken and nothing is allocated. subscribing or unsubscribing builds a new snapshot under
+    //      a writer mutex and publishes it with one atomic exchange (copy on write)
+    //  -   old snapshots are freed after a grace period (read-copy-update). readers register in one of two
+    //      counters picked by the current epoch. Synchronize flips the epoch twice and waits for each counter to
+    //      drain, after that no invocation that could have loaded an old snapshot is still running
+    //  -   a writer waits for the grace period outside the mutex, so invocations are never blocked by writers.
+    //      a writer that is itself inside an invocation (handler subscribing from a handler) does not wait,
+    //      its old snapshot is freed by the next writer that can wait
+    //  -   an invocation already running when Unsubscribe returns may still call the removed handler once.
+    //      call Synchronize after unsubscribing if the handler's object is about to be destroyed
+    //  -   snapshot copies cost O(subscribers) per change. fine for events that are invoked a lot more often than
+    //      their subscribers change, which is what this is for. use Event for single threaded events
+    template<typename... Args>
+    class ConcurrentEvent
+    {
+    private:
+        using Ops = detail::CallableOps<Args...>;
+
+        struct Entry
+        {
+            const Ops* ops;
+            uint32_t generation;
+            alignas(void*) unsigned char storage[detail::InlineCallableSize];
+        };
+
+        struct Snapshot
+        {
+            std::vector<Entry> entries;
+
+            Snapshot() = default;
+
+            // copies entries of other. boxed callables are cloned so each snapshot owns its own
+            explicit Snapshot(const Snapshot* other)
+            {
+                if (!other)
+                {
+                    return;
+                }
+
+                entries.reserve(other->entries.size() + 1);
+                for (const Entry& src : other->entries)
+                {
+                    Entry entry;
+                    entry.ops = src.ops;
+                    entry.generation = src.generation;
+                    src.ops->copy(entry.storage, src.storage);
+                    entries.push_back(entry);
+                }
+            }
+
+            ~Snapshot()
+            {
+                for (Entry& entry : entries)
+                {
+                    entry.ops->destroy(entry.storage);
+                }
+            }
+
+            Snapshot(const Snapshot&) = delete;
+            Snapshot& operator=(const Snapshot&) = delete;
+        };
+
+        struct Retired
+        {
+            Snapshot* snapshot;
+            uint64_t sequence;
+        };
+
+        // registers calling thread as a reader for the scope. pins every snapshot loaded in it
+        class ReadScope
+        {
+        private:
+            std::atomic<uint32_t>& m_readers;
+
+        public:
+            explicit ReadScope(const ConcurrentEvent& evt) :
+                m_readers(evt.m_readers[evt.m_epoch.load() & 1])
+            {
+                m_readers.fetch_add(1);
+                ++detail::ConcurrentInvokeDepth();
+            }
+
+            ~ReadScope()
+            {
+                --detail::ConcurrentInvokeDepth();
+                m_readers.fetch_sub(1);
+            }
+        };
+
+        std::atomic<Snapshot*> m_current{ nullptr };
+        mutable std::atomic<uint64_t> m_epoch{ 0 };
+        mutable std::atomic<uint32_t> m_readers[2] = { {0}, {0} };
+
+        // writer state
+        std::mutex m_writeMutex;
+        std::vector<Retired> m_retired;
+        uint64_t m_retireSequence = 0;
+        uint32_t m_nextGeneration = 1;
+
+        // publishes next and retires the snapshot it replaces. call with writer mutex held
+        void Publish(Snapshot* next)
+        {
+            if (next && next->entries.empty())
+            {
+                delete next;
+                next = nullptr;
+            }
+
+            Snapshot* old = m_current.exchange(next);
+            if (old)
+            {
+                m_retired.push_back({ old, ++m_retireSequence });
+            }
+        }
+
+        // frees retired snapshots once no reader can see them. skipped when called from inside an invocation
+        void Reclaim()
+        {
+            if (detail::ConcurrentInvokeDepth() > 0)
+            {
+                return;
+            }
+
+            uint64_t sequence;
+            {
+                std::lock_guard<std::mutex> lock(m_writeMutex);
+                if (m_retired.empty())
+                {
+                    return;
+                }
+                sequence = m_retireSequence;
+            }
+
+            Synchronize();
+
+            // snapshots retired after our grace period started may still be in use, keep those
+            std::vector<Snapshot*> expired;
+            {
+                std::lock_guard<std::mutex> lock(m_writeMutex);
+                size_t kept = 0;
+                for (Retired& retired : m_retired)
+                {
+                    if (retired.sequence <= sequence)
+                    {
+                        expired.push_back(retired.snapshot);
+                    }
+                    else
+                    {
+                        m_retired[kept++] = retired;
+                    }
+                }
+                m_retired.resize(kept);
+            }
+
+            // destroy outside the lock, boxed callables may run arbitrary destructors
+            for (Snapshot* snapshot : expired)
+            {
+                delete snapshot;
+            }
+        }
+
+        template <typename F>
+        Subscription Add(F callable)
+        {
+            Subscription subscription;
+            {
+                std::lock_guard<std::mutex> lock(m_writeMutex);
+
+                Snapshot* next = new Snapshot(m_current.load());
+
+                Entry entry;
+                entry.generation = m_nextGeneration++;
+                if (m_nextGeneration == 0)
+                {
+                    m_nextGeneration = 1;
+                }
+
+                if constexpr (std::is_trivially_copyable<F>::value && sizeof(F) <= detail::InlineCallableSize && alignof(F) <= alignof(void*))
+                {
+                    entry.ops = &detail::InlineCallable<F, Args...>::Ops;
+                    new (entry.storage) F(callable);
+                }
+                else
+                {
+                    entry.ops = &detail::BoxedCallable<F, Args...>::Ops;
+                    new (entry.storage) F*(new F(std::move(callable)));
+                }
+
+                subscription = Subscription{ static_cast<uint32_t>(next->entries.size()), entry.generation };
+                next->entries.push_back(entry);
+                Publish(next);
+            }
+
+            Reclaim();
+            return subscription;
+        }
+
+        // removes first entry pred is true for
+        template <typename Pred>
+        void RemoveFirst(Pred pred)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_writeMutex);
+
+                Snapshot* current = m_current.load();
+                if (!current)
+                {
+                    return;
+                }
+
+                size_t found = current->entries.size();
+                for (size_t i = 0; i < current->entries.size(); ++i)
+                {
+                    if (pred(current->entries[i]))
+                    {
+                        found = i;
+                        break;
+                    }
+                }
+                if (found == current->entries.size())
+                {
+                    return;
+                }
+
+                Snapshot* next = new Snapshot();
+                next->entries.reserve(current->entries.size() - 1);
+                for (size_t i = 0; i < current->entries.size(); ++i)
+                {
+                    if (i == found)
+                    {
+                        continue;
+                    }
+
+                    const Entry& src = current->entries[i];
+                    Entry entry;
+                    entry.ops = src.ops;
+                    entry.generation = src.generation;
+                    src.ops->copy(entry.storage, src.storage);
+                    next->entries.push_back(entry);
+                }
+                Publish(next);
+            }
+
+            Reclaim();
+        }
+
+        template <typename F>
+        void RemoveEqual(const F& callable)
+        {
+            const Ops* ops = &detail::InlineCallable<F, Args...>::Ops;
+            RemoveFirst([ops, &callable](const Entry& entry)
+                {
+                    return entry.ops == ops && ops->equals(entry.storage, &callable);
+                });
+        }
+
+    public:
+        ConcurrentEvent() = default;
+
+        ConcurrentEvent(const ConcurrentEvent&) = delete;
+        ConcurrentEvent& operator=(const ConcurrentEvent&) = delete;
+
+        // no invocation may be running when the event is destroyed
+        ~ConcurrentEvent()
+        {
+            delete m_current.exchange(nullptr);
+            for (Retired& retired : m_retired)
+            {
+                delete retired.snapshot;
+            }
+        }
+
+        // invokes subscribers of the current snapshot in subscription order. lock free, safe from any thread
+        void operator ()(const Args&... args) const
+        {
+            ReadScope scope(*this);
+
+            const Snapshot* snapshot = m_current.load();
+            if (!snapshot)
+            {
+                return;
+            }
+
+            for (const Entry& entry : snapshot->entries)
+            {
+                entry.ops->invoke(entry.storage, args...);
+            }
+        }
+
+        size_t Size() const
+        {
+            ReadScope scope(*this);
+
+            const Snapshot* snapshot = m_current.load();
+            return snapshot ? snapshot->entries.size() : 0;
+        }
+
+        // waits until every invocation that started before this call has returned. must not be called from a
+        // handler of a concurrent event
+        void Synchronize() const
+        {
+            // two flips: a reader that read the epoch just before the first flip may register in the counter
+            // the first flip moved away from, the second wait covers it
+            for (int i = 0; i < 2; ++i)
+            {
+                uint64_t epoch = m_epoch.fetch_add(1);
+                std::atomic<uint32_t>& readers = m_readers[epoch & 1];
+                while (readers.load() != 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        void Clear()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_writeMutex);
+                Publish(nullptr);
+            }
+            Reclaim();
+        }
+
+        template <typename C>
+        Subscription Subscribe(Handler<void, C, Args...> handler)
+        {
+            return Add(detail::MemberCallable<C, Args...>{ handler.m_pFunc, handler.m_pInst });
+        }
+
+        Subscription Subscribe(Handler<void, void, Args...> handler)
+        {
+            return Add(detail::FreeCallable<Args...>{ handler.m_pFunc });
+        }
+
+        Subscription Subscribe(Handler<void, std::function<void(Args...)>, Args...> handler)
+        {
+            return Add(std::move(handler.m_func));
+        }
+
+        // referenced callable must outlive the subscription, and any invocation still running after Unsubscribe
+        Subscription Subscribe(FunctionRef<void(Args...)> ref)
+        {
+            return Add(ref);
+        }
+
+        void Unsubscribe(Subscription subscription)
+        {
+            if (!subscription.IsValid())
+            {
+                return;
+            }
+
+            RemoveFirst([subscription](const Entry& entry)
+                {
+                    return entry.generation == subscription.generation;
+                });
+        }
+
+        template <typename C>
+        Subscription operator += (Handler<void, C, Args...> handler)
+        {
+            return Subscribe(handler);
+        }
+
+        Subscription operator += (Handler<void, void, Args...> handler)
+        {
+            return Subscribe(handler);
+        }
+
+        Subscription operator += (Handler<void, std::function<void(Args...)>, Args...> handler)
+        {
+            return Subscribe(std::move(handler));
+        }
+
+        Subscription operator += (FunctionRef<void(Args...)> ref)
+        {
+            return Subscribe(ref);
+        }
+
+        template <typename C>
+        void operator -= (Handler<void, C, Args...> handler)
+        {
+            RemoveEqual(detail::MemberCallable<C, Args...>{ handler.m_pFunc, handler.m_pInst });
+        }
+
+        void operator -= (Handler<void, void, Args...> handler)
+        {
+            RemoveEqual(detail::FreeCallable<Args...>{ handler.m_pFunc });
+        }
+
+        void operator -= (FunctionRef<void(Args...)> ref)
+        {
+            RemoveEqual(ref);
+        }
+
+        void operator -= (Subscription subscription)
+        {
+            Unsubscribe(subscription);
+        }
+    };
+}
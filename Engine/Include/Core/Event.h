@@ -4,6 +4,12 @@
 #include <iostream>
 #include <string>
 #include <functional>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <memory>
 
 
 namespace event
@@ -21,6 +27,17 @@ namespace event
         virtual R operator ()(const Args&...) = 0;
 
         virtual bool Equals(const IDelegate<R, Args...>* other) const = 0;
+
+        // identifies concrete delegate type. Equals compares tags instead of dynamic_cast
+        virtual const void* GetTypeTag() const = 0;
+
+    protected:
+        template <typename D>
+        static const void* TypeTag()
+        {
+            static const char tag = 0;
+            return &tag;
+        }
     };
 
     // delegate implementation
@@ -65,8 +82,17 @@ namespace event
         // if delegate's calling object and function pointer is same, then they are equal
         bool Equals(const IDelegate<R, Args...>* other) const override
         {
-            auto otherDelegate = dynamic_cast<const Delegate<R, C, Args...>*>(other);
-            return otherDelegate && otherDelegate->m_pFunc == m_pFunc && otherDelegate->m_pInst == m_pInst;
+            if (other->GetTypeTag() != GetTypeTag())
+            {
+                return false;
+            }
+            auto otherDelegate = static_cast<const Delegate<R, C, Args...>*>(other);
+            return otherDelegate->m_pFunc == m_pFunc && otherDelegate->m_pInst == m_pInst;
+        }
+
+        const void* GetTypeTag() const override
+        {
+            return IDelegate<R, Args...>::template TypeTag<Delegate>();
         }
     };
 
@@ -107,8 +133,17 @@ namespace event
 
         bool Equals(const IDelegate<R, Args...>* other) const override
         {
-            auto otherDelegate = dynamic_cast<const Delegate<R, void, Args...>*>(other);
-            return otherDelegate && otherDelegate->m_pFunc == m_pFunc;
+            if (other->GetTypeTag() != GetTypeTag())
+            {
+                return false;
+            }
+            auto otherDelegate = static_cast<const Delegate<R, void, Args...>*>(other);
+            return otherDelegate->m_pFunc == m_pFunc;
+        }
+
+        const void* GetTypeTag() const override
+        {
+            return IDelegate<R, Args...>::template TypeTag<Delegate>();
         }
     };
 
@@ -140,8 +175,89 @@ namespace event
             // For simplicity, always return false (or compare addresses if stored).
             return false;
         }
+
+        const void* GetTypeTag() const override
+        {
+            return IDelegate<R, Args...>::template TypeTag<Delegate>();
+        }
+    };
+
+
+    // non-owning reference to a callable: object pointer plus a call thunk. never allocates, whatever is
+    // referenced (lambda with captures, functor, member function, free function).
+    // design consideration:
+    //  -   it does not own what it refers to. a lambda or functor must outlive every event it is subscribed to
+    //  -   Bind<&C::Method>(inst) calls the method directly from the thunk, the method is a template argument.
+    //      cheaper than Handler, which calls through a member function pointer stored at runtime
+    //  -   two refs are equal if they refer to the same object through the same thunk, so -= works for
+    //      lambdas subscribed through a FunctionRef
+    template <typename Signature>
+    class FunctionRef;
+
+    template <typename R, typename... Args>
+    class FunctionRef<R(Args...)>
+    {
+    private:
+        void* m_object = nullptr;
+        R(*m_function)(Args...) = nullptr;
+        R(*m_thunk)(const FunctionRef&, Args...) = nullptr;
+
+        FunctionRef() = default;
+
+    public:
+        // refers to callable. callable is not copied
+        template <typename F, typename = std::enable_if_t<!std::is_same<std::decay_t<F>, FunctionRef>::value>>
+        FunctionRef(F& callable) :
+            m_object(const_cast<void*>(static_cast<const void*>(std::addressof(callable)))),
+            m_thunk([](const FunctionRef& ref, Args... args) -> R
+                {
+                    return (*static_cast<F*>(ref.m_object))(std::forward<Args>(args)...);
+                })
+        {
+        }
+
+        FunctionRef(R(*func)(Args...)) :
+            m_function(func),
+            m_thunk([](const FunctionRef& ref, Args... args) -> R
+                {
+                    return ref.m_function(std::forward<Args>(args)...);
+                })
+        {
+        }
+
+        template <auto Method, typename C>
+        static FunctionRef Bind(C* inst)
+        {
+            FunctionRef ref;
+            ref.m_object = inst;
+            ref.m_thunk = [](const FunctionRef& r, Args... args) -> R
+                {
+                    return (static_cast<C*>(r.m_object)->*Method)(std::forward<Args>(args)...);
+                };
+            return ref;
+        }
+
+        R operator()(Args... args) const
+        {
+            return m_thunk(*this, std::forward<Args>(args)...);
+        }
+
+        bool operator==(const FunctionRef& other) const
+        {
+            return m_object == other.m_object && m_function == other.m_function && m_thunk == other.m_thunk;
+        }
+
+        bool operator!=(const FunctionRef& other) const
+        {
+            return !(*this == other);
+        }
     };
 
+    template <typename... Args>
+    class Event;
+
+    template <typename... Args>
+    class ConcurrentEvent;
 
     // this is the "view" wrapper of delegate class. instead of creating an instance of delegate class, application creates this and pass to Event class
     // the Event class will internally create an instance of delegate class with information contained in this "view" class. 
@@ -156,6 +272,9 @@ namespace event
         template <typename... EArgs>
         friend class Event;
 
+        template <typename... EArgs>
+        friend class ConcurrentEvent;
+
     public:
         Handler(C* inst, R(C::* func)(Args...))
         {
@@ -174,6 +293,9 @@ namespace event
         template <typename... EArgs>
         friend class Event;
 
+        template <typename... EArgs>
+        friend class ConcurrentEvent;
+
     public:
         Handler(R(*func)(Args...))
         {
@@ -192,6 +314,9 @@ namespace event
         template <typename... EArgs>
         friend class Event;
 
+        template <typename... EArgs>
+        friend class ConcurrentEvent;
+
     public:
         Handler(std::function<R(Args...)> func) : m_func(std::move(func)) {}
     };
@@ -223,16 +348,374 @@ namespace event
     template <typename F, typename R, typename... Args>
     Handler(F f) -> Handler<void, std::function<R(Args...)>>;
 
+    // identifies one subscription of an Event. returned by Event::Subscribe
+    // generation is unique per subscription within an event and never 0, so a handle of a removed subscriber
+    // can't remove someone else. index is where the subscriber was stored, it is only a lookup hint
+    struct Subscription
+    {
+        uint32_t index = 0;
+        uint32_t generation = 0;
+
+        bool IsValid() const
+        {
+            return generation != 0;
+        }
+    };
+
+    namespace detail
+    {
+        // bytes of a callable stored inline in an event slot. member function pointer plus instance fits on all
+        // compilers we use (msvc member function pointers can be up to 24 bytes)
+        static constexpr size_t InlineCallableSize = 4 * sizeof(void*);
+
+        // type erased operations on a stored callable. one static table per callable type, so a slot is just a
+        // pointer to this plus the callable bytes, and invoking is an indirect call instead of a virtual one
+        template <typename... Args>
+        struct CallableOps
+        {
+            void (*invoke)(const void* storage, const Args&... args);
+            void (*copy)(void* dst, const void* src);
+            void (*destroy)(void* storage);
+            bool (*equals)(const void* a, const void* b);
+        };
+
+        template <typename C, typename... Args>
+        struct MemberCallable
+        {
+            void (C::* func)(Args...);
+            C* inst;
+
+            void operator()(const Args&... args) const
+            {
+                (inst->*func)(args...);
+            }
+
+            bool operator==(const MemberCallable& other) const
+            {
+                return func == other.func && inst == other.inst;
+            }
+        };
+
+        template <typename... Args>
+        struct FreeCallable
+        {
+            void (*func)(Args...);
+
+            void operator()(const Args&... args) const
+            {
+                (*func)(args...);
+            }
+
+            bool operator==(const FreeCallable& other) const
+            {
+                return func == other.func;
+            }
+        };
+
+        // callables that are trivially copyable and small enough are stored in the slot itself.
+        // the callable is copied to the stack before the call, so a handler that subscribes to the same event
+        // (and so may grow the slot storage) does not pull the callable from under itself
+        template <typename F, typename... Args>
+        struct InlineCallable
+        {
+            static void Invoke(const void* storage, const Args&... args)
+            {
+                F f = *static_cast<const F*>(storage);
+                f(args...);
+            }
+
+            static void Copy(void* dst, const void* src)
+            {
+                new (dst) F(*static_cast<const F*>(src));
+            }
+
+            static void Destroy(void*)
+            {
+            }
+
+            static bool Equals(const void* a, const void* b)
+            {
+                return *static_cast<const F*>(a) == *static_cast<const F*>(b);
+            }
+
+            static constexpr CallableOps<Args...> Ops = { &Invoke, &Copy, &Destroy, &Equals };
+        };
+
+        // anything else (std::function) lives on heap and the slot keeps the pointer.
+        // allocated once on subscribe, never on dispatch. these never compare equal, same as before
+        template <typename F, typename... Args>
+        struct BoxedCallable
+        {
+            static void Invoke(const void* storage, const Args&... args)
+            {
+                F* f = *static_cast<F* const*>(storage);
+                (*f)(args...);
+            }
+
+            static void Copy(void* dst, const void* src)
+            {
+                new (dst) F*(new F(**static_cast<F* const*>(src)));
+            }
+
+            static void Destroy(void* storage)
+            {
+                delete* static_cast<F**>(storage);
+            }
+
+            static bool Equals(const void*, const void*)
+            {
+                return false;
+            }
+
+            static constexpr CallableOps<Args...> Ops = { &Invoke, &Copy, &Destroy, &Equals };
+        };
+
+        // vector of trivially copyable elements with room for N elements inside the object.
+        // events with few subscribers (most of them) never allocate
+        template <typename T, size_t N>
+        class SmallVector
+        {
+        private:
+            static_assert(std::is_trivially_copyable<T>::value, "SmallVector only holds trivially copyable types");
+
+            T m_inline[N];
+            T* m_data = m_inline;
+            uint32_t m_size = 0;
+            uint32_t m_capacity = N;
+
+            void Release()
+            {
+                if (m_data != m_inline)
+                {
+                    delete[] m_data;
+                }
+                m_data = m_inline;
+                m_capacity = N;
+            }
+
+        public:
+            SmallVector() = default;
+
+            ~SmallVector()
+            {
+                Release();
+            }
+
+            SmallVector(const SmallVector&) = delete;
+            SmallVector& operator=(const SmallVector&) = delete;
+
+            void Reserve(uint32_t capacity)
+            {
+                if (capacity <= m_capacity)
+                {
+                    return;
+                }
+
+                T* data = new T[capacity];
+                std::memcpy(data, m_data, sizeof(T) * m_size);
+                uint32_t size = m_size;
+                Release();
+                m_data = data;
+                m_size = size;
+                m_capacity = capacity;
+            }
+
+            T& PushBack(const T& value)
+            {
+                if (m_size == m_capacity)
+                {
+                    Reserve(m_capacity * 2);
+                }
+                m_data[m_size] = value;
+                return m_data[m_size++];
+            }
+
+            // removes elements for which pred is true, keeps order of the rest
+            template <typename Pred>
+            void RemoveIf(Pred pred)
+            {
+                uint32_t out = 0;
+                for (uint32_t i = 0; i < m_size; ++i)
+                {
+                    if (!pred(m_data[i]))
+                    {
+                        m_data[out++] = m_data[i];
+                    }
+                }
+                m_size = out;
+            }
+
+            void Clear()
+            {
+                m_size = 0;
+            }
+
+            uint32_t Size() const
+            {
+                return m_size;
+            }
+
+            T& operator[](uint32_t i)
+            {
+                return m_data[i];
+            }
+
+            const T& operator[](uint32_t i) const
+            {
+                return m_data[i];
+            }
+        };
+    }
+
     // this is the event class
+    // design consideration:
+    //  -   subscribers are stored by value in one contiguous array of slots. a slot holds a pointer to a static
+    //      operation table and the callable itself (see detail::InlineCallable). member and free function
+    //      handlers don't allocate, and the first subscriber is stored inside the event
+    //  -   invoking is a walk over contiguous memory with one indirect call per subscriber. no list nodes, no
+    //      virtual calls, no heap allocated delegates
+    //  -   subscribers are invoked in subscription order. subscribers added while the event is being invoked are
+    //      first invoked on the next invocation
+    //  -   removing only deactivates the slot. slots are compacted before the next invocation or subscription
+    //      (after the outermost invocation if removed from a handler), so order of the others is kept and a burst
+    //      of removals (e.g. actors despawning) costs one compaction instead of one per removal
+    //  -   Subscribe and += return a Subscription with a generation. removing by subscription compares
+    //      generations, no handler comparison, and works for lambdas. a stale subscription is harmless
+    //  -   -= with a handler still works. it compares stored callables of the same type only, no RTTI
+    //  -   FunctionRef subscribers are non-owning references and never allocate, even for capturing lambdas
     template<typename... Args>
     class Event
     {
     private:
-        std::list<IDelegate<void, Args...>*> m_subscribers;
-        std::list<typename std::list<IDelegate<void, Args...>*>::iterator> m_unsubscribers;
+        using Ops = detail::CallableOps<Args...>;
+
+        struct Slot
+        {
+            const Ops* ops;
+            uint32_t generation;
+            bool active;
+            alignas(void*) unsigned char storage[detail::InlineCallableSize];
+        };
+
+        detail::SmallVector<Slot, 1> m_slots;
+        uint32_t m_activeCount = 0;
+        uint32_t m_nextGeneration = 1;
+        uint32_t m_invokeDepth = 0;
+        bool m_pendingRemoval = false;
+
+        template <typename F>
+        Subscription Add(F callable)
+        {
+            if (m_pendingRemoval && m_invokeDepth == 0)
+            {
+                Compact();
+            }
+
+            Slot slot;
+            slot.generation = m_nextGeneration++;
+            slot.active = true;
+
+            if constexpr (std::is_trivially_copyable<F>::value && sizeof(F) <= detail::InlineCallableSize && alignof(F) <= alignof(void*))
+            {
+                slot.ops = &detail::InlineCallable<F, Args...>::Ops;
+                new (slot.storage) F(callable);
+            }
+            else
+            {
+                slot.ops = &detail::BoxedCallable<F, Args...>::Ops;
+                new (slot.storage) F*(new F(std::move(callable)));
+            }
+
+            // generation wraps after 4 billion subscriptions. skip 0, it marks an invalid handle
+            if (m_nextGeneration == 0)
+            {
+                m_nextGeneration = 1;
+            }
+
+            uint32_t index = m_slots.Size();
+            m_slots.PushBack(slot);
+            ++m_activeCount;
+            return Subscription{ index, slot.generation };
+        }
+
+        // slot may still be read by an invocation in progress, and more removals often follow.
+        // compacted later, see Compact
+        void Remove(uint32_t index)
+        {
+            m_slots[index].active = false;
+            --m_activeCount;
+            m_pendingRemoval = true;
+        }
+
+        // removes first active subscriber equal to callable. only callables of the same type are compared
+        template <typename F>
+        void RemoveEqual(const F& callable)
+        {
+            const Ops* ops = &detail::InlineCallable<F, Args...>::Ops;
+            for (uint32_t i = 0; i < m_slots.Size(); ++i)
+            {
+                Slot& slot = m_slots[i];
+                if (slot.active && slot.ops == ops && ops->equals(slot.storage, &callable))
+                {
+                    Remove(i);
+                    return;
+                }
+            }
+        }
+
+        void Compact()
+        {
+            for (uint32_t i = 0; i < m_slots.Size(); ++i)
+            {
+                if (!m_slots[i].active)
+                {
+                    m_slots[i].ops->destroy(m_slots[i].storage);
+                }
+            }
+            m_slots.RemoveIf([](const Slot& s) { return !s.active; });
+            m_pendingRemoval = false;
+        }
+
+        void CopyFrom(const Event& other)
+        {
+            for (uint32_t i = 0; i < other.m_slots.Size(); ++i)
+            {
+                const Slot& src = other.m_slots[i];
+                if (!src.active)
+                {
+                    continue;
+                }
+
+                Slot slot;
+                slot.ops = src.ops;
+                slot.generation = src.generation;
+                slot.active = true;
+                src.ops->copy(slot.storage, src.storage);
+                m_slots.PushBack(slot);
+                ++m_activeCount;
+            }
+            m_nextGeneration = other.m_nextGeneration;
+        }
+
     public:
         Event() = default;
 
+        // copies subscribers. boxed callables are cloned, so both events own theirs
+        Event(const Event& other)
+        {
+            CopyFrom(other);
+        }
+
+        Event& operator=(const Event& other)
+        {
+            if (this != &other)
+            {
+                Clear();
+                CopyFrom(other);
+            }
+            return *this;
+        }
+
         virtual ~Event()
         {
             Clear();
@@ -240,116 +723,164 @@ namespace event
 
         void Clear()
         {
-            // we store pointers. explicitly destroy the objects the pointers points to first
-            for (IDelegate<void, Args...>* subscriber : m_subscribers)
+            if (m_invokeDepth > 0)
             {
-                if (subscriber)
+                for (uint32_t i = 0; i < m_slots.Size(); ++i)
                 {
-                    delete subscriber;
+                    m_slots[i].active = false;
                 }
+                m_activeCount = 0;
+                m_pendingRemoval = true;
+                return;
             }
 
-            // then we clear the list. safe now as the objects all the pointers in list points to are now destroyed
-            m_subscribers.clear();
+            for (uint32_t i = 0; i < m_slots.Size(); ++i)
+            {
+                m_slots[i].ops->destroy(m_slots[i].storage);
+            }
+            m_slots.Clear();
+            m_activeCount = 0;
+            m_pendingRemoval = false;
         }
 
         size_t Size() const
         {
-            return m_subscribers.size();
+            return m_activeCount;
         }
 
         void operator ()(const Args&... args)
         {
-            // notify all listeners
-            for (IDelegate<void, Args...>* subscriber : m_subscribers)
+            // compacts deferred removals when outermost invocation ends, even if a handler throws
+            struct InvokeScope
             {
-                if (subscriber && subscriber->IsActive())
+                Event& event;
+
+                explicit InvokeScope(Event& e) : event(e)
                 {
-                    (*subscriber)(args...);
+                    ++event.m_invokeDepth;
                 }
+
+                ~InvokeScope()
+                {
+                    if (--event.m_invokeDepth == 0 && event.m_pendingRemoval)
+                    {
+                        event.Compact();
+                    }
+                }
+            } scope(*this);
+
+            if (m_pendingRemoval && m_invokeDepth == 1)
+            {
+                Compact();
             }
 
-            // Sweep deferred removals
-            for (auto it : m_unsubscribers)
+            // count is taken up front. subscribers added by handlers are not invoked this time
+            const uint32_t count = m_slots.Size();
+            for (uint32_t i = 0; i < count; ++i)
             {
-                delete* it;                 // Destroy the delegate
-                m_subscribers.erase(it);    // Remove from listener list
+                const Slot& slot = m_slots[i];
+                if (slot.active)
+                {
+                    slot.ops->invoke(slot.storage, args...);
+                }
             }
-            m_unsubscribers.clear();
         }
 
+        // subscribes and returns a handle for Unsubscribe
         template <typename C>
-        void operator += (Handler<void, C, Args...> handler)
+        Subscription Subscribe(Handler<void, C, Args...> handler)
         {
-            IDelegate<void, Args...>* dlgt = new Delegate<void, C, Args...>(handler.m_pFunc, handler.m_pInst);
+            return Add(detail::MemberCallable<C, Args...>{ handler.m_pFunc, handler.m_pInst });
+        }
 
-            m_subscribers.push_back(dlgt); 
+        Subscription Subscribe(Handler<void, void, Args...> handler)
+        {
+            return Add(detail::FreeCallable<Args...>{ handler.m_pFunc });
         }
 
-        void operator += (Handler<void, void, Args...> handler)
+        Subscription Subscribe(Handler<void, std::function<void(Args...)>, Args...> handler)
         {
-            IDelegate<void, Args...>* dlgt = new Delegate<void, void, Args...>(handler.m_pFunc);
+            return Add(std::move(handler.m_func));
+        }
 
-            m_subscribers.push_back(dlgt);
+        // referenced callable must outlive the subscription
+        Subscription Subscribe(FunctionRef<void(Args...)> ref)
+        {
+            return Add(ref);
+        }
+
+        // removes subscriber by handle. does nothing if it was already removed
+        void Unsubscribe(Subscription subscription)
+        {
+            if (!subscription.IsValid())
+            {
+                return;
+            }
+
+            // index is exact unless earlier subscribers were compacted away since, then it's somewhere before it.
+            // walk back from there. i wraps around past 0 and ends the loop
+            uint32_t i = subscription.index < m_slots.Size() ? subscription.index : m_slots.Size() - 1;
+            for (; i < m_slots.Size(); --i)
+            {
+                if (m_slots[i].generation == subscription.generation)
+                {
+                    if (m_slots[i].active)
+                    {
+                        Remove(i);
+                    }
+                    return;
+                }
+            }
+        }
+
+        template <typename C>
+        Subscription operator += (Handler<void, C, Args...> handler)
+        {
+            return Subscribe(handler);
+        }
+
+        Subscription operator += (Handler<void, void, Args...> handler)
+        {
+            return Subscribe(handler);
         }
 
         // Add operator += for lambda handlers
         // note: don't credit me for this implementation. got this from copilot. getting lazy now :P
         // note: function signature is limited to void return type for now
-        void operator += (Handler<void, std::function<void(Args...)>, Args...> handler)
+        Subscription operator += (Handler<void, std::function<void(Args...)>, Args...> handler)
         {
-            IDelegate<void, Args...>* dlgt = new Delegate<void, std::function<void(Args...)>, Args...>(handler.m_func);
+            return Subscribe(std::move(handler));
+        }
 
-            m_subscribers.push_back(dlgt);
+        Subscription operator += (FunctionRef<void(Args...)> ref)
+        {
+            return Subscribe(ref);
         }
 
         template <typename C>
         void operator -= (Handler<void, C, Args...> handler)
         {
-            Delegate<void, C, Args...> temp(handler.m_pFunc, handler.m_pInst);
-
-            for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it)
-            {
-                if ((*it)->Equals(&temp))
-                {
-                    (*it)->Deactivate();            // Prevent dispatch
-                    m_unsubscribers.push_back(it);   // Store iterator for deferred removal
-                    break;
-                }
-            }
+            RemoveEqual(detail::MemberCallable<C, Args...>{ handler.m_pFunc, handler.m_pInst });
         }
 
         void operator -= (Handler<void, void, Args...> handler)
         {
-            Delegate<void, void, Args...> temp(handler.m_pFunc);
-
-            for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it)
-            {
-                if ((*it)->Equals(&temp))
-                {
-                    (*it)->Deactivate();            // Prevent dispatch
-                    m_unsubscribers.push_back(it);   // Store iterator for deferred removal
-                    break;
-                }
-            }
+            RemoveEqual(detail::FreeCallable<Args...>{ handler.m_pFunc });
         }
 
-        // Add operator -= for lambda handlers
-        // note: don't credit me for this implementation. got this from copilot. getting lazy now :P
-		// note: function signature is limited to void return type for now
+        // lambdas can't be compared, so this never finds one. unsubscribe lambdas with the Subscription += returned
         void operator -= (Handler<void, std::function<void(Args...)>, Args...> handler)
         {
-            Delegate<void, std::function<void(Args...)>, Args...> temp(handler.m_func);
+        }
+
+        void operator -= (FunctionRef<void(Args...)> ref)
+        {
+            RemoveEqual(ref);
+        }
 
-            for (auto it = m_subscribers.begin(); it != m_subscribers.end(); ++it)
-            {
-                if ((*it)->Equals(&temp))
-                {
-                    (*it)->Deactivate();
-                    m_unsubscribers.push_back(it);
-                    break;
-                }
-            }
+        void operator -= (Subscription subscription)
+        {
+            Unsubscribe(subscription);
         }
 
     };
@@ -0,0 +1,291 @@
+#pragma once
+#include <Core/Event.h>
+#include <vector>
+#include <memory>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <typeinfo>
+#include <atomic>
+
+namespace event
+{
+	namespace detail
+	{
+		// sequential id per event struct type, used to index channels without hashing
+		inline size_t NextEventTypeId()
+		{
+			static std::atomic<size_t> next{ 0 };
+			return next.fetch_add(1);
+		}
+
+		template <typename T>
+		size_t EventTypeId()
+		{
+			static const size_t id = NextEventTypeId();
+			return id;
+		}
+	}
+
+	// throughput of one channel. counts are since last ResetStatistics
+	struct EventChannelStatistics
+	{
+		uint64_t posted = 0;		// Post calls
+		uint64_t coalesced = 0;		// posts merged into the previous event instead of queued
+		uint64_t delivered = 0;		// events handed to subscribers
+		uint64_t batches = 0;		// dispatches that had at least one event
+		float lastDispatchTime = 0.0f;	// seconds spent in subscribers on last dispatch
+	};
+
+	// type independent part of a channel, so the bus can dispatch all channels in one pass
+	class IEventChannel
+	{
+	public:
+		virtual ~IEventChannel() = default;
+
+		virtual void Dispatch() = 0;
+		virtual void Clear() = 0;
+		virtual size_t GetPendingCount() const = 0;
+		virtual const std::string& GetName() const = 0;
+		virtual const EventChannelStatistics& GetStatistics() const = 0;
+		virtual void ResetStatistics() = 0;
+	};
+
+	// queue of posted events of one type.
+	// design consideration:
+	//	-	events are stored by value in a ring buffer. capacity is a power of two and doubles when full, events are
+	//		never dropped
+	//	-	dispatch moves pending events into a contiguous batch first, then delivers the batch. events posted to a
+	//		channel by its own subscribers are delivered on next dispatch, so one event can't cascade into a chain of
+	//		synchronous calls in the same pass
+	//	-	subscribers can take events one by one (OnEvent) or the whole batch at once (OnBatch). batch handlers
+	//		get the events back to back in memory
+	//	-	optional coalescing. if coalesce(queued, posted) returns true, posted event replaces the last queued one
+	//		instead of being added. e.g. mouse moves within a frame collapse to the last position
+	template <typename T>
+	class EventChannel : public IEventChannel
+	{
+	private:
+		std::vector<T> m_ring;
+		size_t m_head = 0;		// oldest pending event
+		size_t m_count = 0;
+
+		std::vector<T> m_batch;
+		std::function<bool(const T&, const T&)> m_coalesce;
+
+		std::string m_name;
+		EventChannelStatistics m_statistics;
+
+		void Grow()
+		{
+			std::vector<T> ring(m_ring.empty() ? 16 : m_ring.size() * 2);
+			for (size_t i = 0; i < m_count; ++i)
+			{
+				ring[i] = std::move(m_ring[(m_head + i) & (m_ring.size() - 1)]);
+			}
+			m_ring.swap(ring);
+			m_head = 0;
+		}
+
+	public:
+		// subscribers for single events
+		Event<const T&> OnEvent;
+
+		// subscribers for the whole batch (first event, count)
+		Event<const T*, size_t> OnBatch;
+
+		explicit EventChannel(size_t capacity = 64) :
+			m_name(typeid(T).name())
+		{
+			size_t size = 16;
+			while (size < capacity)
+			{
+				size *= 2;
+			}
+			m_ring.resize(size);
+		}
+
+		virtual ~EventChannel() = default;
+
+		void Post(const T& evt)
+		{
+			++m_statistics.posted;
+
+			if (m_coalesce && m_count > 0)
+			{
+				T& last = m_ring[(m_head + m_count - 1) & (m_ring.size() - 1)];
+				if (m_coalesce(last, evt))
+				{
+					last = evt;
+					++m_statistics.coalesced;
+					return;
+				}
+			}
+
+			if (m_count == m_ring.size())
+			{
+				Grow();
+			}
+
+			m_ring[(m_head + m_count) & (m_ring.size() - 1)] = evt;
+			++m_count;
+		}
+
+		// coalesce(queued, posted) decides if posted replaces queued. pass nullptr to turn coalescing off
+		void SetCoalesce(std::function<bool(const T&, const T&)> coalesce)
+		{
+			m_coalesce = std::move(coalesce);
+		}
+
+		// coalesces every event of this type, only the last one posted between dispatches is delivered
+		void SetCoalesceAll()
+		{
+			m_coalesce = [](const T&, const T&) { return true; };
+		}
+
+		virtual void Dispatch() override
+		{
+			if (m_count == 0)
+			{
+				m_statistics.lastDispatchTime = 0.0f;
+				return;
+			}
+
+			// take pending events out of the ring first. posts made by subscribers go to the ring for next time
+			m_batch.clear();
+			for (size_t i = 0; i < m_count; ++i)
+			{
+				m_batch.push_back(std::move(m_ring[(m_head + i) & (m_ring.size() - 1)]));
+			}
+			m_head = 0;
+			m_count = 0;
+
+			auto start = std::chrono::steady_clock::now();
+
+			OnBatch(m_batch.data(), m_batch.size());
+			for (const T& evt : m_batch)
+			{
+				OnEvent(evt);
+			}
+
+			m_statistics.lastDispatchTime = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+			m_statistics.delivered += m_batch.size();
+			++m_statistics.batches;
+		}
+
+		virtual void Clear() override
+		{
+			m_head = 0;
+			m_count = 0;
+		}
+
+		virtual size_t GetPendingCount() const override
+		{
+			return m_count;
+		}
+
+		virtual const std::string& GetName() const override
+		{
+			return m_name;
+		}
+
+		virtual const EventChannelStatistics& GetStatistics() const override
+		{
+			return m_statistics;
+		}
+
+		virtual void ResetStatistics() override
+		{
+			m_statistics = EventChannelStatistics();
+		}
+	};
+
+	// deferred event bus. producers Post event structs, subscribers get them when the bus is dispatched.
+	// design consideration:
+	//	-	one channel per event struct type, created on first use. channel lookup is an index by a per type id,
+	//		no hashing or string compare per post
+	//	-	Dispatch drains channels in the order they were created. engine dispatches its bus once per lap, right
+	//		after input is updated, so that is the one place in a frame where deferred events are handled
+	//	-	channels are independent. DispatchChannel lets a job system drain different channels on different
+	//		worker threads, as long as subscribers of those channels don't share state
+	//	-	not thread safe. post from the thread that owns the bus, or from workers only while it is not dispatched
+	class EventBus
+	{
+	private:
+		std::vector<std::unique_ptr<IEventChannel>> m_channels;	// by type id. null for types this bus never used
+		std::vector<IEventChannel*> m_order;					// creation order
+
+	public:
+		EventBus() = default;
+		~EventBus() = default;
+
+		EventBus(const EventBus&) = delete;
+		EventBus& operator=(const EventBus&) = delete;
+
+		template <typename T>
+		EventChannel<T>& Channel()
+		{
+			size_t id = detail::EventTypeId<T>();
+			if (id >= m_channels.size())
+			{
+				m_channels.resize(id + 1);
+			}
+
+			if (!m_channels[id])
+			{
+				m_channels[id] = std::make_unique<EventChannel<T>>();
+				m_order.push_back(m_channels[id].get());
+			}
+			return static_cast<EventChannel<T>&>(*m_channels[id]);
+		}
+
+		template <typename T>
+		void Post(const T& evt)
+		{
+			Channel<T>().Post(evt);
+		}
+
+		void Dispatch()
+		{
+			// channels created by subscribers during dispatch are dispatched next time
+			size_t count = m_order.size();
+			for (size_t i = 0; i < count; ++i)
+			{
+				m_order[i]->Dispatch();
+			}
+		}
+
+		size_t GetChannelCount() const
+		{
+			return m_order.size();
+		}
+
+		IEventChannel& GetChannel(size_t index)
+		{
+			return *m_order[index];
+		}
+
+		void DispatchChannel(size_t index)
+		{
+			m_order[index]->Dispatch();
+		}
+
+		void Clear()
+		{
+			for (IEventChannel* channel : m_order)
+			{
+				channel->Clear();
+			}
+		}
+
+		void ResetStatistics()
+		{
+			for (IEventChannel* channel : m_order)
+			{
+				channel->ResetStatistics();
+			}
+		}
+	};
+}
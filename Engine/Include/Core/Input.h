@@ -3,6 +3,7 @@
 #include <array>
 #include <cassert>
 #include "Event.h"
+#include "EventBus.h"
 #include <Windows.h>
 #include "Singleton.h"
 
@@ -28,12 +29,32 @@ namespace input
 		int				x, y;        // mouse position (valid for move/down/up)
 	};
 
+	// input events as posted to an event bus (see Input::SetEventBus)
+	struct KeyEvent
+	{
+		unsigned int	code;
+		bool			pressed;
+	};
+
+	struct MouseButtonEvent
+	{
+		unsigned int	button;
+		bool			pressed;
+		int				x, y;
+	};
+
+	struct MouseMoveEvent
+	{
+		int				x, y;
+	};
+
 	class Input: public core::Singleton<Input>
 	{
 	protected:
 		std::vector<InputEvent>      events;
 		std::array<bool, 256>        keyState = {};
 		std::array<bool, 5>          mouseState = {};  // 1=left, 2=right, ...
+		event::EventBus*             bus = nullptr;
 
 	public:
 		Input() = default;
@@ -45,6 +66,13 @@ namespace input
 		event::Event<int, int, int> OnMouseUp;
 		event::Event<int, int> OnMouseMove;
 
+		// input events are also posted to this bus on Update, for subscribers that want them deferred and batched.
+		// pass nullptr to stop posting
+		void SetEventBus(event::EventBus* eventBus)
+		{
+			bus = eventBus;
+		}
+
 
 		virtual void HandleMouseMove(int x, int y) noexcept
 		{
@@ -142,6 +170,30 @@ namespace input
 				}
 			}
 
+			// post to bus. delivered when bus is dispatched
+			if (bus)
+			{
+				for (InputEvent& evt : events)
+				{
+					switch (evt.type)
+					{
+					case InputType::KeyDown:
+					case InputType::KeyUp:
+						bus->Post(KeyEvent{ evt.code, evt.type == InputType::KeyDown });
+						break;
+					case InputType::MouseDown:
+					case InputType::MouseUp:
+						bus->Post(MouseButtonEvent{ evt.code, evt.type == InputType::MouseDown, evt.x, evt.y });
+						break;
+					case InputType::MouseMove:
+						bus->Post(MouseMoveEvent{ evt.x, evt.y });
+						break;
+					default:
+						break;
+					}
+				}
+			}
+
 			// dispatch key held??
 			// TODO: add later if needed. provide option to enable/disable
 
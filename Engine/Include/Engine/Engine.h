@@ -16,16 +16,28 @@
 #include <Timer/Scheduler.h>
 #include <Graphics/Core/ICanvas.h>
 #include <Graphics/Renderer/IRenderer.h>
+#include <Graphics/Renderer/DrawStreamRecorderImpl.h>
+#include <Core/EventBus.h>
 #include <Command/ICommand.h>
 #include <Command/CommandQueue.h>
+#include <Command/RenderQueue.h>
+#include <Command/RenderList.h>
+#include <Command/RenderFrameQueue.h>
 #include <Win32/Window.h>
 #include <Performance/FrameRateMonitor.h>
+#include <Performance/Profiler.h>
 #include <Timer/FrameRateController.h>
+#include <Timer/FramePacer.h>
+#include <Timer/FixedTimestep.h>
+#include <Timer/Clock.h>
+#include <Job/JobSystem.h>
 
 #include <memory>
 #include <deque>
 #include <vector>
 #include <list>
+#include <thread>
+#include <mutex>
 
 namespace engine
 {
@@ -38,9 +50,84 @@ namespace engine
 		std::unique_ptr<graphics::renderer::IRenderer> m_renderer;
 		timer::StopWatch m_stopwatch;
 		command::CommandQueue m_commandQueue;
+		command::RenderQueue m_renderQueue;
+
+		// retained items, drawn every frame after render commands and draw packets, so static UI ends up on top.
+		// items are only rebuilt and uploaded when they change
+		command::RenderList m_renderList;
+
+		// world renderables (actors, effects) by their world rect. applications insert and move them and submit the
+		// ones a camera sees with RenderQueue().SubmitVisible(World(), camera). world is 8192 x 8192 in 256 cells,
+		// assign a new index before inserting anything for another size
+		command::RenderQueue::WorldIndex m_world;
+
+		event::EventBus m_eventBus;
+
+		// worker threads. "WorkerThreads" in environment config sets how many, default is one per core but one.
+		// continuations of finished jobs run once per lap right after the scheduler. command queue has a worker
+		// buffer for each of them plus main thread
+		job::JobSystem m_jobSystem;
 		performance::FrameRateMonitor m_mainLoopMonitor;
 		performance::FrameRateMonitor m_renderMonitorMonitor;
 		timer::FrameRateController m_renderController;
+		timer::FramePacer m_framePacer;
+		timer::FramePacer::Mode m_pacingMode = timer::FramePacer::Mode::Hybrid;	// mode to go back to when a virtual clock is replaced
+
+		// renderer counters of last rendered frame, copied right after renderer's End
+		graphics::renderer::RenderStatistics m_renderStatistics;
+
+		// fixed timestep simulation. only used if "SimulationRate" (Hz) is in environment config, scheduler is then
+		// stepped at that rate instead of with frame deltas. "MaxSimulationSteps" caps catch up steps per lap
+		timer::FixedTimestep m_simulation;
+		bool m_fixedTimestep = false;
+
+		// interpolation alpha of the frame being drawn. set by the thread that draws it before render commands run
+		float m_renderAlpha = 1.0f;
+
+		// clock the main loop is timed with. "Clock" in environment config picks one: "Steady" (default), "Tsc",
+		// or "Virtual", which advances by "VirtualTimeStep" seconds (default 1/60) every lap instead of real time
+		std::unique_ptr<timer::IClock> m_clock;
+		timer::VirtualClock* m_virtualClock = nullptr;
+		float m_virtualTimeStep = 1.0f / 60.0f;
+
+		// draw stream capture. only set up if "DrawStreamCapture" is in environment config, its value is the output file
+		std::unique_ptr<graphics::renderer::DrawStream> m_drawStream;
+		graphics::renderer::DrawStreamRecorderImpl* m_drawStreamRecorder = nullptr;
+		std::string m_drawStreamFile;
+		size_t m_drawStreamFramesLeft = 0;
+
+		// profile capture. output file is "ProfileCapture" in environment config
+		std::string m_profileFile;
+		size_t m_profileLapsLeft = 0;
+
+		// render thread. only used if "RenderThread" in environment config is "Double" or "Triple".
+		// design consideration:
+		//	-	main thread stays the simulation thread: input, events, scheduler and jobs run in Lap as before. when a
+		//		render frame is due, Lap no longer renders. it hands the frame to render thread (SubmitFrame) and goes
+		//		on with the next lap while render thread draws, so simulation and rendering overlap on two cores
+		//	-	the handoff is the fence between the threads. draw packets are copied, so submitted packets keep being
+		//		drawn as before. render commands are swapped into the frame (no copy, the queue comes back empty) only
+		//		when they changed since last handoff. render thread keeps drawing the last set it got every frame
+		//		until the next one arrives, same as commands staying on the queue without render thread. so clear and
+		//		record the whole set when it changes, commands recorded after a handoff without Clear replace the
+		//		handed off set instead of adding to it. render list runs are copied only when they changed since the
+		//		frame last carried them
+		//	-	back-pressure comes from RenderFrameQueue: handoff waits while all frames are still queued or being
+		//		drawn. simulation is at most one (double) or two (triple) frames ahead of what is on screen
+		//	-	render thread owns the device context while it draws a frame. code on main thread that uses the
+		//		context (texture uploads, font atlas creation) holds LockRenderContext. resources created in StartEvent
+		//		handlers need no lock, render thread starts after it
+		//	-	resize requests from the window are applied by render thread before its next frame. viewport and render
+		//		statistics are published by render thread and read from main thread under a mutex
+		std::unique_ptr<command::RenderFrameQueue> m_renderFrames;
+		std::thread m_renderThread;
+		command::CommandQueue m_renderCommands;		// render thread only, set it draws every frame
+		uint64_t m_submittedCommands = 0;			// command queue's render version at last handoff
+		std::mutex m_renderContextMutex;
+		mutable std::mutex m_renderStateMutex;	// guards render monitor, statistics, viewport and pending resize
+		math::geometry::RectF m_viewPort;
+		spatial::Size<uint32_t> m_pendingSize;
+		bool m_resizePending = false;
 
 		void Initialize();
 		void Idle();
@@ -52,10 +139,16 @@ namespace engine
 		void ProcessWin32Message(UINT msg, WPARAM wParam, LPARAM lParam);
 
 		void Lap(float delta);
+		void Step(float step);
 
 		void DebugShowStatistics(float delta);
 
 		void OnRender(float delta);
+		void Render(float delta, float alpha, command::CommandQueue& commands, command::RenderQueue& packets, command::RenderList& list);
+
+		void SubmitFrame(float delta);
+		void RenderThread();
+		void StopRenderThread();
 
 	public:
 
@@ -65,6 +158,16 @@ namespace engine
 			float mainLoopLastFPS;
 			float renderAverageFPS;
 			float renderLastFPS;
+			float pacingAverageJitter;
+			float pacingMaxJitter;
+			float simulationAlpha;
+			uint64_t simulationSteps;
+			uint64_t simulationCaughtUpSteps;
+			uint64_t simulationDroppedSteps;
+			performance::FrameTimeStatistics mainLoopFrameTimes;
+			performance::FrameTimeStatistics renderFrameTimes;
+			graphics::renderer::RenderStatistics render;
+			command::RenderFrameQueue::Statistics renderFrames;	// all zero without render thread
 		};
 
 		Engine(
@@ -84,31 +187,130 @@ namespace engine
 			return m_stopwatch;
 		}
 
+		// with render thread, only use it from render commands
 		graphics::renderer::IRenderer& Renderer()
 		{
 			return *m_renderer;
 		}
 
+		timer::FramePacer& FramePacer()
+		{
+			return m_framePacer;
+		}
+
+		// interpolation alpha stays 1 when fixed timestep is off. render commands take RenderAlpha instead of GetAlpha
+		timer::FixedTimestep& Simulation()
+		{
+			return m_simulation;
+		}
+
+		// alpha of the frame being drawn, for interpolated render commands. it is simulation's alpha when the frame
+		// was handed off, so it matches the state the commands were recorded with even if render thread lags behind
+		const float& RenderAlpha() const
+		{
+			return m_renderAlpha;
+		}
+
+		bool IsFixedTimestep() const
+		{
+			return m_fixedTimestep;
+		}
+
+		// times the main loop with clock instead of steady_clock. clock must outlive the engine.
+		// frame pacing is turned off for virtual clocks, sleeping does not move them. it is turned back to the mode it
+		// had when a real clock is set again
+		void SetClock(const timer::IClock& clock);
+
+		const timer::IClock& Clock() const
+		{
+			return m_stopwatch.GetClock();
+		}
+
 		command::CommandQueue& CommandQueue()
 		{
 			return m_commandQueue;
 		}
 
+		command::RenderQueue& RenderQueue()
+		{
+			return m_renderQueue;
+		}
+
+		// change it from main thread only, also with render thread
+		command::RenderList& RenderList()
+		{
+			return m_renderList;
+		}
+
+		// main thread only, same as render queue it is submitted to
+		command::RenderQueue::WorldIndex& World()
+		{
+			return m_world;
+		}
+
+		job::JobSystem& Jobs()
+		{
+			return m_jobSystem;
+		}
+
+		// deferred events. dispatched once per lap, right after input
+		event::EventBus& EventBus()
+		{
+			return m_eventBus;
+		}
+
+		// with render thread, viewport of the last rendered frame. canvas is only queried on render thread
 		math::geometry::RectF GetViewPort() const
 		{
+			if (m_renderFrames)
+			{
+				std::lock_guard<std::mutex> lock(m_renderStateMutex);
+				return m_viewPort;
+			}
 			return m_canvas->GetViewPort();
 		}
 
+		bool HasRenderThread() const
+		{
+			return m_renderFrames != nullptr;
+		}
+
+		// holds off render thread while main thread uses the device context, e.g. to create textures. without
+		// render thread it costs an uncontended lock. never call it from a render command, render thread already
+		// holds it while drawing
+		std::unique_lock<std::mutex> LockRenderContext()
+		{
+			return std::unique_lock<std::mutex>(m_renderContextMutex);
+		}
+
 		void Run();
 
+		// records the next frameCount rendered frames into draw stream file set in "DrawStreamCapture" environment config
+		void CaptureDrawStream(size_t frameCount);
+
+		// records profiling markers of the next lapCount laps and saves them as chrome trace json into file set in
+		// "ProfileCapture" environment config. markers are compiled in for debug builds or with ENABLE_PROFILER
+		void CaptureProfile(size_t lapCount);
+
 		Statistics GetStatistics()
 		{
+			std::lock_guard<std::mutex> lock(m_renderStateMutex);
 			return Statistics
 			{
 				m_mainLoopMonitor.GetAverageFrameRate(),
 				m_mainLoopMonitor.GetLastFrameRate(),
 				m_renderMonitorMonitor.GetAverageFrameRate(),
 				m_renderMonitorMonitor.GetLastFrameRate(),
+				m_framePacer.GetAverageJitter(),
+				m_framePacer.GetMaxJitter(),
+				m_simulation.GetAlpha(),
+				m_simulation.GetStatistics().steps,
+				m_simulation.GetStatistics().caughtUpSteps,
+				m_simulation.GetStatistics().droppedSteps,
+				m_mainLoopMonitor.GetFrameTimeStatistics(),
+				m_renderMonitorMonitor.GetFrameTimeStatistics(),
+				m_renderStatistics,
+				m_renderFrames ? m_renderFrames->GetStatistics() : command::RenderFrameQueue::Statistics(),
 			};
 		}
 
@@ -4,6 +4,7 @@
 //#include <Graphics/Renderer/IRenderer.h>
 #include <Graphics/Renderer/DX11RendererBatchImpl.h>
 #include <Graphics/Renderer/DX11RendererImmediateImpl.h>
+#include <Graphics/Renderer/SoftwareRendererImpl.h>
 #include <Cache/Registry.h>
 #include <Cache/Dictionary.h>
 #include <Core/Factory.h>
@@ -66,6 +67,19 @@ namespace graphics::factory
                         return std::make_unique<graphics::renderer::Renderer>(std::make_unique<graphics::dx11::renderer::DX11RendererImmediateImpl>());
                     });
 
+                // register type for renderer = software. it rasterizes immediately on CPU so there is no batch vs immediate distinction.
+                // we register it for both render modes so switching API alone is enough to go headless
+                for (const char* mode : { "Batch", "Immediate" })
+                {
+                    key.first = graphics::software::renderer::SoftwareRendererImpl::TypeName;   // software (CPU) renderer
+                    key.second = mode;
+                    core::Factory<std::pair<std::string, std::string>, graphics::renderer::IRenderer, PairHasher>::Instance().Register(
+                        key, []()
+                        {
+                            return std::make_unique<graphics::renderer::Renderer>(std::make_unique<graphics::software::renderer::SoftwareRendererImpl>());
+                        });
+                }
+
                 // set to true so we never load again
                 loaded = true;
             }
@@ -1,5 +1,6 @@
 #pragma once
 #include <Graphics/Resource/DX11TextureImpl.h>
+#include <Graphics/Resource/SoftwareTextureImpl.h>
 #include <Graphics/Resource/ITexture.h>
 #include <Core/Factory.h>
 #include <Cache/Registry.h>
@@ -30,6 +31,12 @@ namespace graphics
                         return std::make_unique<graphics::dx11::resource::DX11TextureImpl>();
                     });
 
+                core::Factory<std::string, graphics::resource::ITexture>::Instance().Register(
+                    graphics::software::resource::SoftwareTextureImpl::TypeName, []()
+                    {
+                        return std::make_unique<graphics::software::resource::SoftwareTextureImpl>();
+                    });
+
                 loaded = true;
             }
             return core::Factory<std::string, graphics::resource::ITexture>::Instance().Create(typeName);
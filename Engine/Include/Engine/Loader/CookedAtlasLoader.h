@@ -0,0 +1,134 @@
+// Utility class for hydrating sprite atlases from a cooked atlas file.
+//
+// The CookedAtlasLoader is the runtime side of the atlas packer tool. The tool packs many
+// source images (sprite sheets or folders of frames) into a few large pages and writes a
+// binary UV table (see graphics::imageio::atlas::CookedAtlas). The loader:
+// 1. Reads the cooked file.
+// 2. Creates one ISpriteAtlas per page (via SpriteAtlasFactory) and initializes it with the page image.
+// 3. Adds the remapped UV rects of every frame on that page using ISpriteAtlas::AddUVRect.
+//
+// Frames are looked up by the name of the source they came from, so code that used to load
+// "explode0_128x128_16f.png" into its own atlas now asks the set for "explode0_128x128_16f"
+// and gets sprites that share the page texture with everything else packed next to it.
+//
+//Typical usage:
+//  - CookedAtlasSet set;
+//  - CookedAtlasLoader::Load(set, "../Assets/Cooked/actors.atlas");
+//  - Sprite sprite = set.MakeSprite("explode0_128x128_16f", frame);
+
+#pragma once
+#include <Graphics/Renderable/ISpriteAtlas.h>
+#include <Graphics/IO/CookedAtlasFile.h>
+#include <Engine/Factory/SpriteAtlasFactory.h>
+#include <Utilities/Logger.h>
+#include <filesystem>
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+
+namespace graphics::loader
+{
+    class CookedAtlasSet
+    {
+    public:
+        // frames of one source. index of a frame in its page atlas is first + frame
+        struct Entry
+        {
+            size_t page = 0;
+            int first = 0;
+            int count = 0;
+        };
+
+    private:
+        friend class CookedAtlasLoader;
+
+        std::vector<std::unique_ptr<graphics::renderable::ISpriteAtlas>> m_pages;
+        std::unordered_map<std::string, Entry> m_entries;
+
+    public:
+        const Entry* Find(const std::string& name) const
+        {
+            auto it = m_entries.find(name);
+            return it != m_entries.end() ? &it->second : nullptr;
+        }
+
+        bool Has(const std::string& name) const
+        {
+            return m_entries.find(name) != m_entries.end();
+        }
+
+        int GetFrameCount(const std::string& name) const
+        {
+            const Entry* entry = Find(name);
+            return entry ? entry->count : 0;
+        }
+
+        const graphics::renderable::ISpriteAtlas& GetPage(size_t page) const
+        {
+            return *m_pages[page];
+        }
+
+        size_t GetPageCount() const
+        {
+            return m_pages.size();
+        }
+
+        // throws if name or frame is unknown, same as asking an atlas for a UV index it does not have
+        graphics::renderable::Sprite MakeSprite(const std::string& name, int frame) const
+        {
+            const Entry* entry = Find(name);
+            if (!entry || frame < 0 || frame >= entry->count)
+            {
+                throw std::out_of_range("Unknown cooked atlas frame: " + name + " #" + std::to_string(frame));
+            }
+            return m_pages[entry->page]->MakeSprite(entry->first + frame);
+        }
+    };
+
+    class CookedAtlasLoader
+    {
+    public:
+        static bool Load(CookedAtlasSet& set, const std::string& cookedFilePath)
+        {
+            graphics::imageio::atlas::CookedAtlas cooked;
+            if (!cooked.LoadFromFile(cookedFilePath))
+            {
+                return false;
+            }
+
+            set.m_pages.clear();
+            set.m_entries.clear();
+
+            // page images are stored relative to the cooked file
+            std::filesystem::path directory = std::filesystem::path(cookedFilePath).parent_path();
+
+            for (const graphics::imageio::atlas::CookedAtlas::Page& page : cooked.pages)
+            {
+                std::unique_ptr<graphics::renderable::ISpriteAtlas> atlas = graphics::factory::SpriteAtlasFactory::Create();
+                std::wstring imagePath = (directory / page.image).wstring();
+                if (!atlas || !atlas->Initialize(imagePath.c_str()))
+                {
+                    LOGERROR("Failed to load cooked atlas page: " << page.image);
+                    set.m_pages.clear();
+                    return false;
+                }
+
+                for (const math::geometry::RectF& uv : page.uvs)
+                {
+                    atlas->AddUVRect(uv);
+                }
+
+                set.m_pages.push_back(std::move(atlas));
+            }
+
+            for (const graphics::imageio::atlas::CookedAtlas::Entry& entry : cooked.entries)
+            {
+                set.m_entries[entry.name] = { entry.page, static_cast<int>(entry.first), static_cast<int>(entry.count) };
+            }
+
+            return true;
+        }
+    };
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// platform independent rectangle packer used by offline atlas tools. it only deals with sizes and positions,
+// loading and copying pixels is the tool's job.
+// design consideration:
+//	-	each page is a MaxRects bin. new rects go to the free rect with best short side fit, then free rects that
+//		overlap it are split and the ones contained in other free rects are pruned
+//	-	rects are added in groups. all rects of a group land on the same page, so an animation set (or a whole
+//		actor) ends up in one texture and drawing it never needs a bind in between
+//	-	groups are packed largest first and each group tries existing pages before a new page is opened
+//	-	padding is added around every rect so linear filtering does not bleed neighbouring frames. the returned
+//		rect is the inner one, the tool may extrude edge pixels into the padding
+namespace graphics::imageio::atlas
+{
+	struct PackRect
+	{
+		uint32_t x;
+		uint32_t y;
+		uint32_t width;
+		uint32_t height;
+	};
+
+	class MaxRectsBin
+	{
+	private:
+		uint32_t m_width = 0;
+		uint32_t m_height = 0;
+		uint64_t m_usedArea = 0;
+		std::vector<PackRect> m_free;
+
+		bool SplitFreeRect(const PackRect& freeRect, const PackRect& used);
+		void PruneFreeRects();
+
+	public:
+		MaxRectsBin(uint32_t width, uint32_t height);
+		~MaxRectsBin() = default;
+
+		// finds a place for a width x height rect. returns false if it does not fit anywhere
+		bool Insert(uint32_t width, uint32_t height, PackRect& placed);
+
+		// used area / page area
+		float GetOccupancy() const;
+
+		uint32_t GetWidth() const
+		{
+			return m_width;
+		}
+
+		uint32_t GetHeight() const
+		{
+			return m_height;
+		}
+	};
+
+	class AtlasPacker
+	{
+	public:
+		struct Size
+		{
+			uint32_t width;
+			uint32_t height;
+		};
+
+	private:
+		struct Group
+		{
+			std::vector<Size> sizes;
+			std::vector<PackRect> placed;
+			uint32_t page = 0;
+			uint64_t area = 0;
+		};
+
+		uint32_t m_pageWidth;
+		uint32_t m_pageHeight;
+		uint32_t m_padding;
+		std::vector<Group> m_groups;
+		std::vector<MaxRectsBin> m_pages;
+
+		bool PackGroup(MaxRectsBin& bin, Group& group) const;
+
+	public:
+		AtlasPacker(uint32_t pageWidth, uint32_t pageHeight, uint32_t padding = 2);
+		~AtlasPacker() = default;
+
+		// adds rects that must share a page. returns group index
+		size_t AddGroup(const std::vector<Size>& sizes);
+
+		// packs all groups. fails if a group does not fit on an empty page
+		bool Pack();
+
+		size_t GetPageCount() const
+		{
+			return m_pages.size();
+		}
+
+		const MaxRectsBin& GetPage(size_t page) const
+		{
+			return m_pages[page];
+		}
+
+		// valid after Pack. rects are in the same order as sizes given to AddGroup
+		uint32_t GetGroupPage(size_t group) const
+		{
+			return m_groups[group].page;
+		}
+
+		const std::vector<PackRect>& GetGroupRects(size_t group) const
+		{
+			return m_groups[group].placed;
+		}
+	};
+}
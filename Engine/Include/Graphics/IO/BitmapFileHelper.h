@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// platform independent BMP reader/writer. used by software (CPU) resources that cannot go through WIC.
+// pixels are always exchanged as 32 bit RGBA with bytes laid out as R, G, B, A in memory.
+// this is the same layout as DXGI_FORMAT_R8G8B8A8_UNORM so data can be shared with DX11 textures as is
+namespace graphics::imageio::bmp
+{
+	// supports uncompressed 24 and 32 bit bitmaps, both bottom-up and top-down
+	bool LoadFromFile(
+		const wchar_t* filename,
+		unsigned int& width,
+		unsigned int& height,
+		std::vector<uint32_t>& pixels
+	);
+
+	// always saves as 32 bit top-down bitmap so alpha channel is preserved
+	bool SaveToFile(
+		const wchar_t* filename,
+		unsigned int width,
+		unsigned int height,
+		const uint32_t* pixels
+	);
+}
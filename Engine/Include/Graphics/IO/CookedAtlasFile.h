@@ -0,0 +1,46 @@
+#pragma once
+#include <Math/Rect.h>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// binary UV table written by the atlas packer tool and read at runtime by CookedAtlasLoader.
+// design consideration:
+//	-	a cooked atlas is a few page images plus, per page, the normalized UV rects of every frame packed into it.
+//		UVs are already remapped to page space so they can be fed to ISpriteAtlas::AddUVRect as is
+//	-	an entry is a named run of frames (e.g. one source sprite sheet or one animation folder). all frames of
+//		an entry are on the same page, so sprites made from it share one bind. entries may overlap: a packed
+//		folder is one entry, and its subfolders and files are entries over parts of its run
+//	-	page image names are relative to the cooked file, so the cooked file and its pages can be moved together
+//	-	file is little endian: magic "PEAT", version, pages (name, width, height, uv count, uvs),
+//		entries (name, page, first uv, uv count). strings are a uint32 length followed by the characters
+namespace graphics::imageio::atlas
+{
+	struct CookedAtlas
+	{
+		static constexpr uint32_t Magic = 0x54414550; // "PEAT"
+		static constexpr uint32_t Version = 1;
+
+		struct Page
+		{
+			std::string image;
+			uint32_t width = 0;
+			uint32_t height = 0;
+			std::vector<math::geometry::RectF> uvs;
+		};
+
+		struct Entry
+		{
+			std::string name;
+			uint32_t page = 0;
+			uint32_t first = 0;
+			uint32_t count = 0;
+		};
+
+		std::vector<Page> pages;
+		std::vector<Entry> entries;
+
+		bool SaveToFile(const std::string& filename) const;
+		bool LoadFromFile(const std::string& filename);
+	};
+}
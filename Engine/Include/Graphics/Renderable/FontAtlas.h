@@ -3,6 +3,9 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <unordered_map>
+#include <string_view>
+#include <list>
 
 namespace graphics
 {
@@ -23,6 +26,30 @@ namespace graphics::renderable
 		std::vector<text::Glyph> glyphs;
 		std::vector<std::array<float, 4>> m_textNormalizedCoords;
 
+		// text layouts by string. most text (HUD labels, counters) is the same string frame after frame.
+		// design consideration:
+		//	-	layouts are kept in a list, most recently used first. when the cache is full the least recently used
+		//		one is evicted, so a frame drawing more distinct strings than fit only lays out the ones that fell out
+		//		instead of dropping every layout
+		//	-	index is keyed by string_view into the list's own copy of the string. list nodes never move, so the
+		//		views stay valid, and a lookup with a string_view needs no std::string
+		//	-	not thread safe. the cache is used by whichever thread draws text
+		struct CachedLayout
+		{
+			std::string text;
+			text::TextLayout layout;
+		};
+
+		static constexpr size_t MaxCachedLayouts = 256;
+		mutable std::list<CachedLayout> m_layouts;
+		mutable std::unordered_map<std::string_view, std::list<CachedLayout>::iterator> m_layoutIndex;
+
+		void ClearLayouts() const
+		{
+			m_layoutIndex.clear();
+			m_layouts.clear();
+		}
+
 	public:
 		FontAtlas(std::unique_ptr<graphics::resource::ITexture> tex);
 
@@ -45,6 +72,8 @@ namespace graphics::renderable
 		virtual const float GetHeight(const unsigned char character) const override final;
 		virtual const float GetWidth(const std::string& text) const override final;
 
+		virtual const text::TextLayout* GetTextLayout(std::string_view text) const override final;
+
 		// ISizeable methods implementation
 		virtual float GetWidth() const override final;
 		virtual float GetHeight() const override final;
@@ -2,7 +2,10 @@
 #include <Graphics/Renderable/IRenderable.h>
 #include <Spatial/ISizeable.h>
 #include <Spatial/Size.h>
+#include <Graphics/Renderer/SpriteInstance.h>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace graphics
 {
@@ -14,6 +17,15 @@ namespace graphics
 			spatial::SizeF size;
 		};
 
+		// text laid out as glyph quads relative to its top-left corner. built once per string by the font atlas
+		// and drawn with one IRenderer::DrawInstances call
+		struct TextLayout
+		{
+			std::vector<graphics::renderer::SpriteInstance> quads;
+			float width = 0.0f;
+			float height = 0.0f;
+		};
+
 	}
 	namespace renderable
 	{
@@ -37,6 +49,13 @@ namespace graphics
 			virtual const float GetHeight(const unsigned char character) const = 0;
 			virtual const float GetWidth(const std::string& text) const = 0;
 
+			// cached layout of text. returns nullptr if this atlas does not cache layouts, renderers then draw char by char.
+			// layout stays valid until the next call, later calls may evict it
+			virtual const text::TextLayout* GetTextLayout(std::string_view) const
+			{
+				return nullptr;
+			}
+
 			// need to declare this IRenderable methods here because IFontAtlas has the same method name. it's a C++ thing.
 			virtual float GetWidth() const = 0;
 			virtual float GetHeight() const = 0;
@@ -11,5 +11,12 @@ namespace graphics::renderable
 		virtual void Bind() const = 0;
 		virtual bool CanBind() const = 0;
 		virtual math::geometry::RectF GetUVRect() const = 0;
+
+		// identifies what Bind() binds. renderables sharing a texture (e.g. sprites of one atlas) return the same key.
+		// used to group draws by texture. default is this object since most renderables own their texture
+		virtual const void* GetBindKey() const
+		{
+			return this;
+		}
 	};
 }
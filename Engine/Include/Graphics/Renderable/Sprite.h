@@ -15,6 +15,7 @@
 // - Bind(): Binds the sprite's texture for rendering by delegating to the sprite atlas.
 // - CanBind(): Checks if the sprite's texture can be bound for rendering by delegating to the sprite atlas.
 // - GetUVRect(): Returns the UV rectangle defining the portion of the sprite atlas used by this sprite.
+// - GetBindKey(): Returns the sprite atlas' bind key so all sprites of the same atlas are grouped together.
 
 #pragma once
 #include <Graphics/Renderable/IRenderable.h>
@@ -61,6 +62,7 @@ namespace graphics::renderable
 		virtual void Bind() const override final;
 		virtual bool CanBind() const override final;
 		virtual math::geometry::RectF GetUVRect() const override final;
+		virtual const void* GetBindKey() const override final;
 	};
 }
 
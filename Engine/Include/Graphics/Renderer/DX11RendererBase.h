@@ -22,6 +22,8 @@ namespace graphics::dx11::renderer
 	protected:
 		// helper function to create resources. decided to implement helper function this way instead of internally creating resources so this function can be reused in future where a different resource is to be created
 		HRESULT CreateVertexBuffer(const void* pVertices, size_t vertexCount, size_t vertexSize, Microsoft::WRL::ComPtr<ID3D11Buffer>& pd3dVertexBuffer);
+		// vertex buffer that is written by CPU every frame via Map/Unmap
+		HRESULT CreateDynamicVertexBuffer(size_t vertexCount, size_t vertexSize, Microsoft::WRL::ComPtr<ID3D11Buffer>& pd3dVertexBuffer);
 		HRESULT CompileShader(const char* code, const char* sourceName, const char* entryPoint, const char* shaderModel, Microsoft::WRL::ComPtr<ID3DBlob>& pd3dShaderBlob);
 		HRESULT CreateShadersAndInputLayout(
 			const char* vsCode, const char* vsEntryPoint,
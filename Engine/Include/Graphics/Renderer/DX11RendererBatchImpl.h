@@ -3,6 +3,9 @@
 #include <Math/Rect.h>
 #include <DirectXMath.h>
 #include <Graphics/Renderer/IRendererImpl.h>
+#include <Graphics/Renderer/SpriteBatchBuilder.h>
+#include <unordered_map>
+#include <cstdint>
 
 // TODO: remove this. we will always use shader with clipping region
 #define SPRITEBATCH_USESHADERWITHRECTVIEW 1
@@ -27,18 +30,21 @@ namespace graphics::dx11::renderer
 		const char* m_VSCodeWithView;
 		const char* m_PSCodeWithView;
 
-		// number of draw quad requests before batch drawing is performed
-		static const unsigned int MAXSPRITEBATCH = 200;
+		// draw requests are accumulated here until texture changes or End is called. there is no limit on batch size
+		graphics::renderer::SpriteBatchBuilder m_batch;
 
-		// counter quad draw requests
-		unsigned int m_nCurrSpriteCount;
+		// per instance vertex buffer. it grows when a batch does not fit
+		Microsoft::WRL::ComPtr<ID3D11Buffer> m_pd3dInstanceBuffer;
+		size_t m_instanceCapacity = 0;
+
+		// counters of current frame
+		graphics::renderer::RenderStatistics m_statistics;
 
 		// perform draw quad in batch
-		void DrawBatch();
+		void DrawBatch(const graphics::renderer::FlushCause cause);
 
-		// clipping region for rendering
-		math::geometry::RectF m_clipRegion;
-		bool m_clippingEnabled = false;
+		// (re)creates instance buffer that can hold at least given number of instances
+		bool ReserveInstanceBuffer(size_t count);
 
 	private:
 #pragma region // data structures
@@ -62,51 +68,58 @@ namespace graphics::dx11::renderer
 			float z;
 			float w;
 		};
-		struct Transform2D
-		{
-			float x;
-			float y;
-		};
-		struct Color2D
-		{
-			float r;
-			float g;
-			float b;
-			float a;
-		};
 		struct MatrixTransform
 		{
 			DirectX::XMMATRIX transform;
 		};
 
-		struct ConstantBufferUpdate
+		// per instance data in instance buffer. packed from batch builder's columns when batch is drawn
+		struct InstanceData
 		{
-			struct
-			{
-				Transform2D scale;
-				Transform2D translate;
-			}vertex[MAXSPRITEBATCH];
-			struct
-			{
-				Transform2D scale;
-				Transform2D translate;
-			}texture[MAXSPRITEBATCH];
-			Color2D color[MAXSPRITEBATCH];
-			struct
-			{
-				float rotate;
-				int useTexture; // 0 = no texture, 1 = use texture
-				int clippingEnabled; // 0 = clipping disabled, 1 = clipping enabled 
-				float padding2; // 1 floats = 4 bytes padding to align structure in 16 bytes boundary
-			}Misc[MAXSPRITEBATCH];
-
-#if SPRITEBATCH_USESHADERWITHRECTVIEW
-			Float4 view[MAXSPRITEBATCH];
-#endif
+			Float4 vertex;		// xy = scale, zw = translate
+			Float4 texcoord;	// xy = scale, zw = translate
+			Float4 color;
+			Float4 misc;		// x = rotation, y = use texture, z = clipping enabled
+			Float4 view;		// clip region in D3D viewport space
 		};
 #pragma endregion
 
-		ConstantBufferUpdate m_UpdateConstantBuffer;
+		// instance buffer of one retained span (DrawRetained).
+		// design consideration:
+		//	-	span is packed and uploaded the first time it is drawn, and again only when something baked into its
+		//		instance data changes: version, offset, color, clip state or viewport. otherwise drawing it is a
+		//		buffer bind and one draw call, no packing and no upload
+		//	-	each span has its own buffer so an unchanged span is never rewritten because a neighbour changed
+		//	-	spans are keyed by id. ReleaseRetained frees a span's buffer when its owner drops it (RenderList
+		//		does for runs that went empty). buffers of spans nobody released that were not drawn for
+		//		RetainedEvictFrames frames, e.g. of a list that was destroyed, are released at End
+		struct RetainedBuffer
+		{
+			Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+			size_t capacity = 0;
+			size_t count = 0;
+			uint64_t version = 0;
+			spatial::PositionF offset = {};
+			graphics::ColorF color = {};
+			D3D11_VIEWPORT viewPort = {};
+			bool clipped = false;
+			math::geometry::RectF clip = {};
+			uint64_t lastFrame = 0;
+		};
+
+		static constexpr uint64_t RetainedEvictFrames = 120;
+
+		std::unordered_map<uint64_t, RetainedBuffer> m_retained;
+		uint64_t m_frame = 0;
+
+		// packs span into retained buffer, growing it if needed
+		bool UploadRetained(
+			RetainedBuffer& retained,
+			const graphics::renderer::SpriteInstance* instances,
+			const size_t count,
+			const spatial::PositionF offset,
+			const graphics::ColorF color
+		);
 
 	public:
 		DX11RendererBatchImpl();
@@ -123,6 +136,11 @@ namespace graphics::dx11::renderer
 		virtual void Begin() override final;
 		virtual void End() override final;
 
+		virtual graphics::renderer::RenderStatistics GetStatistics() const override final
+		{
+			return m_statistics;
+		}
+
 		// clipping region for rendering
 		virtual void SetClipRegion(const math::geometry::RectF& region) override final;
 		virtual void EnableClipping(const bool enable) override final;
@@ -138,7 +156,7 @@ namespace graphics::dx11::renderer
 		// Draws a string using a font atlas at the specified position and color
 		virtual void DrawText(
 			const graphics::renderable::IFontAtlas& font, // Font atlas
-			const std::string& text,                    // Text to render
+			std::string_view text,                    // Text to render
 			const spatial::PositionF pos,                                 // Top-left screen position
 			const graphics::ColorF color                                   // RGBA color tint
 		) override final;
@@ -160,6 +178,29 @@ namespace graphics::dx11::renderer
 			const graphics::ColorF color,                                   // RGBA color tint
 			const float rotation                                                    // Rotation in radians
 		) override final;
+
+		// Draws quads that share the texture of renderable
+		virtual void DrawInstances(
+			const graphics::renderable::IRenderable& renderable,                    // renderable that binds the texture
+			const graphics::renderer::SpriteInstance* instances,                    // quads to draw
+			const size_t count,                                                     // number of quads
+			const spatial::PositionF offset,                                        // added to every quad position
+			const graphics::ColorF color                                            // RGBA color tint
+		) override final;
+
+		// Draws a span the caller keeps between frames. it is uploaded only when it changed
+		virtual void DrawRetained(
+			const graphics::renderable::IRenderable& renderable,                    // renderable that binds the texture
+			const graphics::renderer::SpriteInstance* instances,                    // quads to draw
+			const size_t count,                                                     // number of quads
+			const spatial::PositionF offset,                                        // added to every quad position
+			const graphics::ColorF color,                                           // RGBA color tint
+			const uint64_t id,                                                      // span identity
+			const uint64_t version                                                  // changes when instances change
+		) override final;
+
+		// Frees the buffer of a span that will not be drawn again
+		virtual void ReleaseRetained(const uint64_t id) override final;
 	};
 }
 
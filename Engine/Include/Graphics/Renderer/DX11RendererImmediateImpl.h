@@ -93,6 +93,16 @@ namespace graphics::dx11::renderer
 
 		ConstantBufferUpdate m_UpdateConstantBuffer;
 
+		// counters of current frame. every quad is its own draw call and constant buffer update
+		graphics::renderer::RenderStatistics m_statistics;
+
+		void CountDraw()
+		{
+			++m_statistics.instances;
+			++m_statistics.drawCalls;
+			m_statistics.bytesUploaded += sizeof(ConstantBufferUpdate);
+		}
+
 	public:
 		DX11RendererImmediateImpl();
 		virtual ~DX11RendererImmediateImpl();
@@ -108,6 +118,11 @@ namespace graphics::dx11::renderer
 		virtual void Begin() override final;
 		virtual void End() override final;
 
+		virtual graphics::renderer::RenderStatistics GetStatistics() const override final
+		{
+			return m_statistics;
+		}
+
 		// clipping region for rendering
 		virtual void SetClipRegion(const math::geometry::RectF& region) override final;
 		virtual void EnableClipping(const bool enable) override final;
@@ -123,7 +138,7 @@ namespace graphics::dx11::renderer
 		// Draws a string using a font atlas at the specified position and color
 		virtual void DrawText(
 			const graphics::renderable::IFontAtlas& font, // Font atlas
-			const std::string& text,                    // Text to render
+			std::string_view text,                    // Text to render
 			const spatial::PositionF pos,                                 // Top-left screen position
 			const graphics::ColorF color                                   // RGBA color tint
 		) override final;
@@ -0,0 +1,204 @@
+#pragma once
+#include <Math/Rect.h>
+#include <Spatial/Size.h>
+#include <Spatial/Position.h>
+#include <vector>
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <type_traits>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+// -----------------------------------------------------------------------------------------------------------
+// compact binary capture of every call that reaches a renderer, grouped in frames (Begin...End).
+//
+// design consideration:
+//	-	written by DrawStreamRecorderImpl, read by DrawStreamPlayer
+//	-	records are an opcode byte followed by its fields written back to back. no padding, no pointers
+//	-	renderables and fonts cannot be serialized. instead we store what the backends actually consume:
+//		-	renderable draws store the UV rect and an id of the texture that was bound for it. this preserves
+//			the bind pattern (CanBind changes) which is what drives batch flushes
+//		-	fonts are stored once as a font definition (glyph UVs and sizes) so text can be replayed without the
+//			original font atlas
+//	-	texture and font definitions live outside the frames so any frame can be replayed on its own
+//	-	values are stored in native byte order. stream files are not meant to travel between architectures
+// -----------------------------------------------------------------------------------------------------------
+
+namespace graphics::renderer
+{
+	class DrawStream
+	{
+	public:
+		enum class Opcode : uint8_t
+		{
+			Begin = 1,
+			End,
+			SetClipRegion,
+			EnableClipping,
+			Draw,
+			DrawRenderable,
+			DrawText,
+			DrawChar,
+		};
+
+		// first and last printable ASCII characters supported by font atlas
+		static constexpr unsigned char FirstGlyph = 32;
+		static constexpr unsigned char LastGlyph = 127;
+		static constexpr size_t GlyphCount = LastGlyph - FirstGlyph + 1;
+
+		// texture id used when nothing is bound
+		static constexpr uint16_t NoTexture = 0xffff;
+
+		// snapshot of a font atlas' metrics at the time it was first used
+		struct FontDefinition
+		{
+			uint16_t texture = NoTexture;
+			spatial::SizeF atlasSize{};
+			std::array<math::geometry::RectF, GlyphCount> uv{};
+			std::array<spatial::SizeF, GlyphCount> size{};
+		};
+
+		// sequential reader over one frame's records
+		class Reader
+		{
+		private:
+			const uint8_t* m_curr;
+			const uint8_t* m_end;
+
+		public:
+			Reader(const uint8_t* begin, const uint8_t* end) :
+				m_curr(begin),
+				m_end(end)
+			{
+			}
+
+			bool IsEnd() const
+			{
+				return m_curr >= m_end;
+			}
+
+			template<typename T>
+			T Read()
+			{
+				static_assert(std::is_trivially_copyable_v<T>, "DrawStream can only read trivially copyable types");
+				T value;
+				std::memcpy(&value, ReadBytes(sizeof(T)), sizeof(T));
+				return value;
+			}
+
+			// position is not trivially copyable (it has a user declared destructor) so it is read per component
+			spatial::PositionF ReadPosition()
+			{
+				float x = Read<float>();
+				float y = Read<float>();
+				return { x, y };
+			}
+
+			const uint8_t* ReadBytes(size_t size)
+			{
+				if (m_curr + size > m_end)
+				{
+					throw std::out_of_range("DrawStream::Reader::ReadBytes - read past end of frame");
+				}
+				const uint8_t* bytes = m_curr;
+				m_curr += size;
+				return bytes;
+			}
+		};
+
+	private:
+		static constexpr uint32_t Magic = 0x53444550; // "PEDS" paper engine draw stream
+		static constexpr uint32_t Version = 1;
+
+		struct Frame
+		{
+			uint64_t begin;
+			uint64_t end;
+		};
+
+		std::vector<uint8_t> m_data;
+		std::vector<Frame> m_frames;
+		std::vector<FontDefinition> m_fonts;
+		uint16_t m_textureCount = 0;
+		bool m_inFrame = false;
+
+		// capture-time lookup tables. these hold addresses of live objects and are never saved
+		std::unordered_map<const void*, uint16_t> m_textureIds;
+		std::unordered_map<const void*, uint16_t> m_fontIds;
+
+	public:
+		DrawStream() = default;
+		~DrawStream() = default;
+
+		void Clear();
+
+		size_t GetFrameCount() const
+		{
+			return m_frames.size();
+		}
+
+		size_t GetByteSize() const
+		{
+			return m_data.size();
+		}
+
+		uint16_t GetTextureCount() const
+		{
+			return m_textureCount;
+		}
+
+		const std::vector<FontDefinition>& GetFonts() const
+		{
+			return m_fonts;
+		}
+
+		Reader GetFrame(size_t index) const;
+
+		bool SaveToFile(const std::string& filename) const;
+		bool LoadFromFile(const std::string& filename);
+
+		// writer. used by recorder
+		void BeginFrame();
+		void EndFrame();
+
+		bool IsInFrame() const
+		{
+			return m_inFrame;
+		}
+
+		template<typename T>
+		void Write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "DrawStream can only write trivially copyable types");
+			WriteBytes(&value, sizeof(T));
+		}
+
+		void Write(const spatial::PositionF& pos)
+		{
+			Write(pos.x);
+			Write(pos.y);
+		}
+
+		void WriteBytes(const void* data, size_t size)
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			m_data.insert(m_data.end(), bytes, bytes + size);
+		}
+
+		void WriteOpcode(Opcode op)
+		{
+			Write(static_cast<uint8_t>(op));
+		}
+
+		// returns stream id for given texture, creating one if first seen. nullptr maps to NoTexture
+		uint16_t GetTextureId(const void* texture);
+
+		// returns stream id for given font, or NoTexture if not registered yet
+		uint16_t FindFontId(const void* font) const;
+
+		// registers a font definition for given font and returns its stream id
+		uint16_t AddFont(const void* font, const FontDefinition& definition);
+	};
+}
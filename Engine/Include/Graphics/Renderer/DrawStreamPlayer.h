@@ -0,0 +1,60 @@
+#pragma once
+#include <Graphics/Renderer/IRenderer.h>
+#include <Graphics/Renderer/DrawStream.h>
+#include <Graphics/Resource/ITexture.h>
+#include <memory>
+#include <vector>
+
+namespace graphics::renderer
+{
+	// replays a recorded draw stream into any renderer.
+	// design consideration:
+	//	-	there are no window, input or scheduler involved. it pushes calls as fast as the target renderer takes them,
+	//		which makes it a repeatable workload for benchmarking batching/sorting changes frame by frame
+	//	-	recorded textures are replaced by stand-ins. by default each texture id gets its own 1x1 white software
+	//		texture. this keeps the bind pattern (and therefore batch flushes) identical to the captured frame.
+	//		use SetTexture to replace them with real textures, e.g. for visual comparison
+	//	-	renderables and fonts are proxies built from the stream, they don't need the original objects
+	class DrawStreamPlayer
+	{
+	private:
+		// stands in for any renderable recorded with given texture. uv is updated per draw call
+		class ReplayRenderable;
+
+		// stands in for a font atlas using the font definition in the stream
+		class ReplayFontAtlas;
+
+		const graphics::renderer::DrawStream& m_stream;
+
+		// default stand-in textures, indexed by texture id
+		std::vector<std::unique_ptr<graphics::resource::ITexture>> m_defaultTextures;
+		std::vector<std::unique_ptr<ReplayRenderable>> m_renderables;
+		std::vector<std::unique_ptr<ReplayFontAtlas>> m_fonts;
+
+		// renderable used when nothing was bound at capture
+		std::unique_ptr<ReplayRenderable> m_noTexture;
+
+		ReplayRenderable& GetRenderable(uint16_t textureId);
+
+	public:
+		DrawStreamPlayer(const graphics::renderer::DrawStream& stream);
+		~DrawStreamPlayer();
+
+		DrawStreamPlayer(const DrawStreamPlayer&) = delete;
+		DrawStreamPlayer& operator=(const DrawStreamPlayer&) = delete;
+
+		size_t GetFrameCount() const
+		{
+			return m_stream.GetFrameCount();
+		}
+
+		// replaces stand-in texture for given texture id. player does not own the texture
+		void SetTexture(uint16_t textureId, graphics::resource::ITexture* texture);
+
+		// replays one frame including its Begin/End. returns number of draw calls issued
+		size_t PlayFrame(graphics::renderer::IRenderer& renderer, size_t index);
+
+		// replays all frames in order. returns number of draw calls issued
+		size_t Play(graphics::renderer::IRenderer& renderer);
+	};
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include <Graphics/Renderer/IRendererImpl.h>
+#include <Graphics/Renderer/DrawStream.h>
+#include <memory>
+
+namespace graphics::renderer
+{
+	// renderer implementation that records every call into a draw stream.
+	// design consideration:
+	//	-	it wraps another renderer and forwards every call to it, so the application keeps rendering while we capture.
+	//		inner renderer is optional. without it, calls are only recorded (headless capture)
+	//	-	recording can be toggled at any time but only starts/stops on a Begin boundary so frames are never partial
+	//	-	to identify textures, we bind the renderable (if not yet bound) and read the bind cache. every backend binds
+	//		through the same cache so this works whatever the inner renderer is
+	//	-	fonts are snapshot the first time they are drawn. font metrics are assumed not to change while recording
+	class DrawStreamRecorderImpl : public graphics::renderer::IRendererImpl
+	{
+	private:
+		graphics::renderer::DrawStream& m_stream;
+		std::unique_ptr<graphics::renderer::IRenderer> m_inner;
+
+		bool m_recordingRequested = true;
+		bool m_recording = false;
+
+		// clip state persists across frames in the backends. we track it so every frame starts with it and can be replayed on its own
+		math::geometry::RectF m_clipRegion = {};
+		bool m_clippingEnabled = false;
+
+		// returns stream id of the texture currently bound for given renderable
+		uint16_t GetTextureId(const graphics::renderable::IRenderable& renderable);
+
+		// returns stream id of given font, snapshotting its metrics if first seen
+		uint16_t GetFontId(const graphics::renderable::IFontAtlas& font);
+
+		// writes a span of instances into the stream, one renderable draw per instance
+		void RecordInstances(
+			const graphics::renderable::IRenderable& renderable,
+			const graphics::renderer::SpriteInstance* instances,
+			const size_t count,
+			const spatial::PositionF offset,
+			const graphics::ColorF color
+		);
+
+	public:
+		DrawStreamRecorderImpl(graphics::renderer::DrawStream& stream, std::unique_ptr<graphics::renderer::IRenderer> inner = nullptr);
+		virtual ~DrawStreamRecorderImpl() = default;
+
+		DrawStreamRecorderImpl(const DrawStreamRecorderImpl&) = delete;
+		DrawStreamRecorderImpl& operator=(const DrawStreamRecorderImpl&) = delete;
+
+		static constexpr const char* TypeName = "DrawStreamRecorder";
+		virtual std::string GetTypeName() const override;
+
+		// takes effect on next Begin
+		void SetRecording(const bool enable)
+		{
+			m_recordingRequested = enable;
+		}
+
+		bool IsRecording() const
+		{
+			return m_recording;
+		}
+
+		graphics::renderer::IRenderer* GetInner()
+		{
+			return m_inner.get();
+		}
+
+		// Releases all sprite rendering resources
+		virtual void ShutDown() override final;
+
+		virtual bool Initialize() override final;
+		virtual void Begin() override final;
+		virtual void End() override final;
+
+		// counters of inner renderer. recording itself is not counted
+		virtual graphics::renderer::RenderStatistics GetStatistics() const override final;
+
+		// clipping region for rendering
+		virtual void SetClipRegion(const math::geometry::RectF& region) override final;
+		virtual void EnableClipping(const bool enable) override final;
+
+		// Draws a colored quad at the specified position, size, and rotation
+		virtual void Draw(
+			const spatial::PositionF pos,                                 // Top-left screen position
+			const spatial::SizeF size,                               // Sprite dimensions
+			const graphics::ColorF color,                                   // RGBA color tint
+			const float rotation                                                    // Rotation in radians
+		) override final;
+
+		// Draws a string using a font atlas at the specified position and color
+		virtual void DrawText(
+			const graphics::renderable::IFontAtlas& font, // Font atlas
+			std::string_view text,                    // Text to render
+			const spatial::PositionF pos,                                 // Top-left screen position
+			const graphics::ColorF color                                   // RGBA color tint
+		) override final;
+
+		// Draws a single character using a font atlas with color and rotation
+		virtual void DrawChar(
+			const graphics::renderable::IFontAtlas& font, // Font atlas
+			const unsigned char character,            // Character to render
+			const spatial::PositionF pos,                                 // Top-left screen position
+			const graphics::ColorF color,                                   // RGBA color tint
+			const float rotation                      // Rotation in radians
+		) override final;
+
+		// Draws a renderable quad with color tint and rotation
+		virtual void DrawRenderable(
+			const graphics::renderable::IRenderable& renderable,                    // renderable object
+			const spatial::PositionF pos,                                 // Top-left screen position
+			const spatial::SizeF size,                               // Sprite dimensions
+			const graphics::ColorF color,                                   // RGBA color tint
+			const float rotation                                                    // Rotation in radians
+		) override final;
+
+		// Draws quads that share the texture of renderable
+		virtual void DrawInstances(
+			const graphics::renderable::IRenderable& renderable,                    // renderable that binds the texture
+			const graphics::renderer::SpriteInstance* instances,                    // quads to draw
+			const size_t count,                                                     // number of quads
+			const spatial::PositionF offset,                                        // added to every quad position
+			const graphics::ColorF color                                            // RGBA color tint
+		) override final;
+
+		// Draws a span the caller keeps between frames. inner renderer keeps its buffers, stream records it as a span
+		virtual void DrawRetained(
+			const graphics::renderable::IRenderable& renderable,                    // renderable that binds the texture
+			const graphics::renderer::SpriteInstance* instances,                    // quads to draw
+			const size_t count,                                                     // number of quads
+			const spatial::PositionF offset,                                        // added to every quad position
+			const graphics::ColorF color,                                           // RGBA color tint
+			const uint64_t id,                                                      // span identity
+			const uint64_t version                                                  // changes when instances change
+		) override final;
+
+		// Frees what inner renderer keeps for a span. nothing is recorded, the stream has no retained state
+		virtual void ReleaseRetained(const uint64_t id) override final;
+	};
+}
@@ -5,8 +5,13 @@
 #include <Spatial/Size.h>
 #include <Graphics/Core/Color.h>
 #include <Graphics/Renderable/IRenderable.h>
+#include <Graphics/Renderer/SpriteInstance.h>
+#include <Graphics/Renderer/RenderStatistics.h>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <cstddef>
+#include <cstdint>
 
 namespace graphics::renderer
 {
@@ -30,6 +35,12 @@ namespace graphics::renderer
         // Ends the current sprite rendering batch
         virtual void End() = 0;
 
+        // counters of the last frame (Begin to End). renderers that do not count return zeros
+        virtual RenderStatistics GetStatistics() const
+        {
+            return {};
+        }
+
 		// clipping region for rendering
 		virtual void SetClipRegion(const math::geometry::RectF& region) = 0;
 		virtual void EnableClipping(const bool enable) = 0;
@@ -45,7 +56,7 @@ namespace graphics::renderer
         // Draws a string using a font atlas at the specified position and color
         virtual void DrawText(
             const graphics::renderable::IFontAtlas& font, // Font atlas
-            const std::string& text,                    // Text to render
+            std::string_view text,                    // Text to render
             const spatial::PositionF pos,                                 // Top-left screen position
             const graphics::ColorF color                                   // RGBA color tint
         ) = 0;
@@ -67,5 +78,65 @@ namespace graphics::renderer
             const graphics::ColorF color,                                   // RGBA color tint
             const float rotation                                                    // Rotation in radians
         ) = 0;
+
+        // Draws quads that share the texture of renderable. renderable is bound once, its own UV rect is ignored.
+        // default draws them one by one through DrawRenderable. batch renderers override it to skip per quad calls
+        virtual void DrawInstances(
+            const graphics::renderable::IRenderable& renderable,                    // renderable that binds the texture
+            const SpriteInstance* instances,                                        // quads to draw
+            const size_t count,                                                     // number of quads
+            const spatial::PositionF offset,                                        // added to every quad position
+            const graphics::ColorF color                                            // RGBA color tint
+        )
+        {
+            // forwards binding to renderable but reports the instance UV
+            class InstanceRenderable : public graphics::renderable::IRenderable
+            {
+            public:
+                const graphics::renderable::IRenderable& source;
+                math::geometry::RectF uv;
+
+                InstanceRenderable(const graphics::renderable::IRenderable& renderable) :
+                    source(renderable),
+                    uv{}
+                {
+                }
+
+                virtual void Bind() const override { source.Bind(); }
+                virtual bool CanBind() const override { return source.CanBind(); }
+                virtual math::geometry::RectF GetUVRect() const override { return uv; }
+                virtual const void* GetBindKey() const override { return source.GetBindKey(); }
+            };
+
+            InstanceRenderable proxy(renderable);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const SpriteInstance& instance = instances[i];
+                proxy.uv = instance.uv;
+                DrawRenderable(proxy, { offset.x + instance.x, offset.y + instance.y }, { instance.width, instance.height }, color, 0.0f);
+            }
+        }
+
+        // Draws an instance span the caller keeps between frames (see engine::command::RenderList). id names the span
+        // for as long as the renderer lives, version changes whenever its instances do. renderers that keep instance
+        // data on the GPU upload the span again only when version, offset, color, clip state or viewport changed.
+        // default draws it like any other span
+        virtual void DrawRetained(
+            const graphics::renderable::IRenderable& renderable,                    // renderable that binds the texture
+            const SpriteInstance* instances,                                        // quads to draw
+            const size_t count,                                                     // number of quads
+            const spatial::PositionF offset,                                        // added to every quad position
+            const graphics::ColorF color,                                           // RGBA color tint
+            const uint64_t /*id*/,                                                  // span identity, unique per process
+            const uint64_t /*version*/                                              // changes when instances change
+        )
+        {
+            DrawInstances(renderable, instances, count, offset, color);
+        }
+
+        // span id will not be drawn again, renderers that keep data for it can free it now. default keeps nothing
+        virtual void ReleaseRetained(const uint64_t)
+        {
+        }
     };
 }
@@ -0,0 +1,78 @@
+#pragma once
+#include <Math/Rect.h>
+#include <cstdint>
+#include <cstddef>
+
+namespace graphics::renderer
+{
+    // why a batch was handed to the backend
+    enum class FlushCause
+    {
+        Texture,    // next draw needs another texture
+        End,        // end of frame
+        Retained,   // a retained span is drawn next, pending draws go first to keep the order
+    };
+
+    // counters of one frame, i.e. from Begin to End. renderers reset them on Begin, read them after End.
+    // design consideration:
+    //  -   counters are plain members updated inline by the renderer, no atomics and no virtual calls per draw.
+    //      they cost a handful of increments per flush, so they are always on, release builds included
+    //  -   binds are counted where the renderer asks the bind cache (CanBind). a skipped bind is a draw that could
+    //      stay in the current batch, a taken bind is a batch break. so the ratio tells how well draws are ordered
+    //      and how well sprites share atlases
+    //  -   batches have no size limit (SpriteBatchBuilder grows), so there is no "batch full" flush. growing the DX11
+    //      instance buffer is what a full batch costs instead, it is counted as bufferGrowths
+    //  -   retained spans (DrawRetained) that were drawn from data already on the GPU count as retainedDraws, the
+    //      ones that had to be packed and uploaded again as retainedUploads. unchanged static content shows up as
+    //      draws only, with no bytes uploaded
+    struct RenderStatistics
+    {
+        uint64_t instances = 0;         // quads handed to the backend
+        uint64_t drawCalls = 0;         // backend draws (DX11 draw calls, software rasterize passes)
+        uint64_t textureFlushes = 0;    // batches flushed because texture changed
+        uint64_t endFlushes = 0;        // batches flushed by End
+        uint64_t retainedFlushes = 0;   // batches flushed before a retained span
+        uint64_t bindsTaken = 0;        // texture binds that went through the bind cache
+        uint64_t bindsSkipped = 0;      // texture binds skipped, texture already bound
+        uint64_t clipChanges = 0;       // SetClipRegion / EnableClipping calls that changed clip region or enable flag
+        uint64_t bytesUploaded = 0;     // bytes written to GPU buffers
+        uint64_t bufferGrowths = 0;     // instance buffer had to be recreated bigger
+        uint64_t retainedDraws = 0;     // retained spans drawn from their kept instance buffer
+        uint64_t retainedUploads = 0;   // retained spans uploaded because they changed or were not kept yet
+
+        void RecordFlush(const FlushCause cause, const size_t count, const size_t bytes)
+        {
+            instances += count;
+            bytesUploaded += bytes;
+            ++drawCalls;
+            switch (cause)
+            {
+            case FlushCause::Texture: ++textureFlushes; break;
+            case FlushCause::End: ++endFlushes; break;
+            case FlushCause::Retained: ++retainedFlushes; break;
+            }
+        }
+
+        void RecordBind(const bool taken)
+        {
+            ++(taken ? bindsTaken : bindsSkipped);
+        }
+
+        // called with the state before the call. setting the same region or flag again is not a change
+        void RecordClipRegion(const math::geometry::RectF& current, const math::geometry::RectF& region)
+        {
+            if (current.left != region.left || current.top != region.top || current.right != region.right || current.bottom != region.bottom)
+            {
+                ++clipChanges;
+            }
+        }
+
+        void RecordClipping(const bool current, const bool enable)
+        {
+            if (current != enable)
+            {
+                ++clipChanges;
+            }
+        }
+    };
+}
@@ -30,6 +30,8 @@ namespace graphics::renderer
         // Ends the current sprite rendering batch
         virtual void End() override final;
 
+        virtual RenderStatistics GetStatistics() const override final;
+
         // clipping region for rendering
 		virtual void SetClipRegion(const math::geometry::RectF& region) override final;
 		virtual void EnableClipping(const bool enable) override final;
@@ -45,7 +47,7 @@ namespace graphics::renderer
         // Draws a string using a font atlas at the specified position and color
         virtual void DrawText(
             const graphics::renderable::IFontAtlas& font, // Font atlas
-            const std::string& text,                    // Text to render
+            std::string_view text,                    // Text to render
             const spatial::PositionF pos,                                 // Top-left screen position
             const graphics::ColorF color                                   // RGBA color tint
         )  override final;
@@ -67,6 +69,29 @@ namespace graphics::renderer
             const graphics::ColorF color,                                   // RGBA color tint
             const float rotation                                                    // Rotation in radians
         )  override final;
+
+        // Draws quads that share the texture of renderable
+        virtual void DrawInstances(
+            const graphics::renderable::IRenderable& renderable,                    // renderable that binds the texture
+            const SpriteInstance* instances,                                        // quads to draw
+            const size_t count,                                                     // number of quads
+            const spatial::PositionF offset,                                        // added to every quad position
+            const graphics::ColorF color                                            // RGBA color tint
+        )  override final;
+
+        // Draws a span the caller keeps between frames
+        virtual void DrawRetained(
+            const graphics::renderable::IRenderable& renderable,                    // renderable that binds the texture
+            const SpriteInstance* instances,                                        // quads to draw
+            const size_t count,                                                     // number of quads
+            const spatial::PositionF offset,                                        // added to every quad position
+            const graphics::ColorF color,                                           // RGBA color tint
+            const uint64_t id,                                                      // span identity
+            const uint64_t version                                                  // changes when instances change
+        )  override final;
+
+        // Frees what is kept for a span that will not be drawn again
+        virtual void ReleaseRetained(const uint64_t id) override final;
     };
 
 
@@ -0,0 +1,147 @@
+#pragma once
+#include <Graphics/Renderer/IRendererImpl.h>
+#include <Graphics/Resource/SoftwareTextureImpl.h>
+#include <Graphics/Renderer/SpriteBatchBuilder.h>
+#include <Math/Rect.h>
+
+// forward class declarations
+namespace graphics
+{
+	namespace resource
+	{
+		class ITexture;
+	}
+}
+
+namespace graphics::software::renderer
+{
+	// headless renderer that rasterizes quads on the CPU into an in-memory RGBA render target.
+	// design consideration:
+	//	-	it does not need a window, a canvas or a GPU. this allows the render path to be measured and
+	//		regression tested on machines without DirectX, e.g. linux build/perf farm
+	//	-	it follows the same conventions as the DX11 renderers so output can be compared pixel for pixel:
+	//		-	quads are scaled, rotated around their center, then translated (same as the vertex shader)
+	//		-	textures are sampled bilinear with wrap addressing (same as the DX11 sampler state)
+	//		-	blending is src alpha / inv src alpha on RGB and destination alpha is preserved (same as the DX11 blend state)
+	//		-	clipping discards pixels whose center lies outside the clip region (same as the pixel shader)
+	//	-	it uses the same global bind cache as the other implementations. textures must be SoftwareTextureImpl
+	//		since we need to read pixels from system memory
+	//	-	draws are collected with the same sprite batch builder as the DX11 batch renderer and rasterized when
+	//		texture changes or on End. render target is only up to date after End
+	//	-	per pixel blending uses SSE2 when available, falls back to scalar otherwise
+	class SoftwareRendererImpl : public graphics::renderer::IRendererImpl
+	{
+	private:
+		// this is where we draw. think of it as the canvas' back buffer
+		graphics::software::resource::SoftwareTextureImpl m_renderTarget;
+		unsigned int m_width;
+		unsigned int m_height;
+
+		// draw requests waiting to be rasterized with currently bound texture
+		graphics::renderer::SpriteBatchBuilder m_batch;
+
+		// counters of current frame. nothing is uploaded, so bytesUploaded stays 0
+		graphics::renderer::RenderStatistics m_statistics;
+
+		// rasterize pending draw requests
+		void Flush(const graphics::renderer::FlushCause cause);
+
+		// we only resolve the bound texture from bind cache when it changes
+		graphics::resource::ITexture* m_lastBoundTexture = nullptr;
+		const graphics::software::resource::SoftwareTextureImpl* m_boundTexture = nullptr;
+
+		// returns the currently bound texture if it is a software texture
+		const graphics::software::resource::SoftwareTextureImpl* GetBoundTexture();
+
+		// rasterize a single quad into render target. if texture is null, the quad is filled with color. if clip is null, there's no clipping
+		void RasterizeQuad(
+			const spatial::PositionF pos,
+			const spatial::SizeF size,
+			const graphics::ColorF color,
+			const float rotation,
+			const graphics::software::resource::SoftwareTextureImpl* texture,
+			const math::geometry::RectF& uvRect,
+			const math::geometry::RectF* clip
+		);
+
+	public:
+		SoftwareRendererImpl(unsigned int width = 1400, unsigned int height = 900);
+		virtual ~SoftwareRendererImpl() = default;
+
+		SoftwareRendererImpl(const SoftwareRendererImpl&) = delete;
+		SoftwareRendererImpl& operator=(const SoftwareRendererImpl&) = delete;
+
+		// this class means it is implemented in software
+		static constexpr const char* TypeName = "Software";
+		virtual std::string GetTypeName() const override;
+
+		// Releases all sprite rendering resources
+		virtual void ShutDown() override final;
+
+		virtual bool Initialize() override final;
+		virtual void Begin() override final;
+		virtual void End() override final;
+
+		virtual graphics::renderer::RenderStatistics GetStatistics() const override final
+		{
+			return m_statistics;
+		}
+
+		// clipping region for rendering
+		virtual void SetClipRegion(const math::geometry::RectF& region) override final;
+		virtual void EnableClipping(const bool enable) override final;
+
+		// Draws a colored quad at the specified position, size, and rotation
+		virtual void Draw(
+			const spatial::PositionF pos,                                 // Top-left screen position
+			const spatial::SizeF size,                               // Sprite dimensions
+			const graphics::ColorF color,                                   // RGBA color tint
+			const float rotation                                                    // Rotation in radians
+		) override final;
+
+		// Draws a string using a font atlas at the specified position and color
+		virtual void DrawText(
+			const graphics::renderable::IFontAtlas& font, // Font atlas
+			std::string_view text,                    // Text to render
+			const spatial::PositionF pos,                                 // Top-left screen position
+			const graphics::ColorF color                                   // RGBA color tint
+		) override final;
+
+		// Draws a single character using a font atlas with color and rotation
+		virtual void DrawChar(
+			const graphics::renderable::IFontAtlas& font, // Font atlas
+			const unsigned char character,            // Character to render
+			const spatial::PositionF pos,                                 // Top-left screen position
+			const graphics::ColorF color,                                   // RGBA color tint
+			const float rotation                      // Rotation in radians
+		) override final;
+
+		// Draws a renderable quad with color tint and rotation
+		virtual void DrawRenderable(
+			const graphics::renderable::IRenderable& renderable,                    // renderable object
+			const spatial::PositionF pos,                                 // Top-left screen position
+			const spatial::SizeF size,                               // Sprite dimensions
+			const graphics::ColorF color,                                   // RGBA color tint
+			const float rotation                                                    // Rotation in radians
+		) override final;
+
+		// Draws quads that share the texture of renderable
+		virtual void DrawInstances(
+			const graphics::renderable::IRenderable& renderable,                    // renderable that binds the texture
+			const graphics::renderer::SpriteInstance* instances,                    // quads to draw
+			const size_t count,                                                     // number of quads
+			const spatial::PositionF offset,                                        // added to every quad position
+			const graphics::ColorF color                                            // RGBA color tint
+		) override final;
+
+		// software renderer specific. there is no canvas so clearing and resizing the render target is done here
+		void Resize(unsigned int width, unsigned int height);
+		void Clear(const graphics::ColorF& color);
+
+		// gives access to rendered pixels e.g. for saving to file or comparing against reference images
+		graphics::software::resource::SoftwareTextureImpl& GetRenderTarget()
+		{
+			return m_renderTarget;
+		}
+	};
+}
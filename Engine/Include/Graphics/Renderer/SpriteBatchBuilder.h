@@ -0,0 +1,149 @@
+#pragma once
+#include <Math/Rect.h>
+#include <Spatial/Position.h>
+#include <Spatial/Size.h>
+#include <Graphics/Core/Color.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace graphics::renderer
+{
+	// accumulates sprite instances for batch renderers, independent of any graphics API.
+	// design consideration:
+	//	-	instances are stored as structure of arrays (one array per attribute). backends read the columns they need
+	//		and pack them in whatever layout their API wants (e.g. DX11 instance buffer, or CPU rasterizer reads them as is)
+	//	-	there is no batch size limit. columns grow as needed and keep their capacity after Reset, so after first
+	//		few frames there is no allocation
+	//	-	builder does not know about textures. renderer decides when a batch must be handed off (e.g. texture changes)
+	//		and takes the pending range [first, first + count). only that range is uploaded/drawn
+	//	-	clip state is per instance (clip region index + flag), so changing clip region does not force a hand off
+	//	-	positions are top-left screen coordinates, same as IRenderer. conversion to API space is backend's job
+	class SpriteBatchBuilder
+	{
+	public:
+		enum Flags : uint8_t
+		{
+			None = 0,
+			Textured = 1 << 0,
+			Clipped = 1 << 1,
+		};
+
+		// range of instances to hand off to backend
+		struct Span
+		{
+			size_t first;
+			size_t count;
+		};
+
+	private:
+		size_t m_count = 0;
+		size_t m_capacity = 0;
+		size_t m_submitted = 0;
+
+		// columns
+		std::vector<float> m_x;
+		std::vector<float> m_y;
+		std::vector<float> m_width;
+		std::vector<float> m_height;
+		std::vector<float> m_rotation;
+		std::vector<float> m_u;
+		std::vector<float> m_v;
+		std::vector<float> m_uScale;
+		std::vector<float> m_vScale;
+		std::vector<float> m_red;
+		std::vector<float> m_green;
+		std::vector<float> m_blue;
+		std::vector<float> m_alpha;
+		std::vector<uint8_t> m_flags;
+		std::vector<uint16_t> m_clipIndex;
+
+		// clip regions used in this frame. instances refer to them by index
+		std::vector<math::geometry::RectF> m_clipRegions;
+		bool m_clippingEnabled = false;
+		bool m_clipRegionChanged = true;
+		math::geometry::RectF m_clipRegion = {};
+
+		void Resize(size_t capacity);
+
+	public:
+		SpriteBatchBuilder(size_t initialCapacity = 1024);
+		~SpriteBatchBuilder() = default;
+
+		// forgets all instances but keeps memory. clip state is kept
+		void Reset();
+
+		// clip state applied to instances added after this
+		void SetClipRegion(const math::geometry::RectF& region);
+		void EnableClipping(const bool enable);
+
+		void Add(
+			const spatial::PositionF pos,
+			const spatial::SizeF size,
+			const math::geometry::RectF& uv,
+			const graphics::ColorF color,
+			const float rotation,
+			const bool textured
+		);
+
+		// clip state instances added now would get
+		bool IsClippingEnabled() const
+		{
+			return m_clippingEnabled;
+		}
+
+		const math::geometry::RectF& GetCurrentClipRegion() const
+		{
+			return m_clipRegion;
+		}
+
+		// pending instances are those not yet handed off to backend
+		Span GetPending() const
+		{
+			return { m_submitted, m_count - m_submitted };
+		}
+
+		bool HasPending() const
+		{
+			return m_count > m_submitted;
+		}
+
+		// call after backend consumed pending instances
+		void MarkSubmitted()
+		{
+			m_submitted = m_count;
+		}
+
+		size_t GetCount() const
+		{
+			return m_count;
+		}
+
+		size_t GetCapacity() const
+		{
+			return m_capacity;
+		}
+
+		// column access. valid for [0, GetCount())
+		const float* GetX() const { return m_x.data(); }
+		const float* GetY() const { return m_y.data(); }
+		const float* GetWidth() const { return m_width.data(); }
+		const float* GetHeight() const { return m_height.data(); }
+		const float* GetRotation() const { return m_rotation.data(); }
+		const float* GetU() const { return m_u.data(); }
+		const float* GetV() const { return m_v.data(); }
+		const float* GetUScale() const { return m_uScale.data(); }
+		const float* GetVScale() const { return m_vScale.data(); }
+		const float* GetRed() const { return m_red.data(); }
+		const float* GetGreen() const { return m_green.data(); }
+		const float* GetBlue() const { return m_blue.data(); }
+		const float* GetAlpha() const { return m_alpha.data(); }
+		const uint8_t* GetFlags() const { return m_flags.data(); }
+		const uint16_t* GetClipIndex() const { return m_clipIndex.data(); }
+
+		const math::geometry::RectF& GetClipRegion(uint16_t index) const
+		{
+			return m_clipRegions[index];
+		}
+	};
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include <Math/Rect.h>
+
+namespace graphics::renderer
+{
+    // one quad of an instance span (see IRenderer::DrawInstances). position is relative to the span offset
+    // and uv is normalized, so a span can be built once and drawn anywhere
+    struct SpriteInstance
+    {
+        float x, y;
+        float width, height;
+        math::geometry::RectF uv;
+    };
+}
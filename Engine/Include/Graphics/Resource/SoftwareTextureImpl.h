@@ -0,0 +1,67 @@
+#pragma once
+#include <Graphics/Resource/ITextureImpl.h>
+#include <vector>
+#include <cstdint>
+
+namespace graphics::software::resource
+{
+	// texture that lives entirely in system memory. it is the texture counterpart of SoftwareRendererImpl.
+	// pixels are stored as 32 bit RGBA with bytes laid out R, G, B, A in memory, same as DXGI_FORMAT_R8G8B8A8_UNORM,
+	// so font atlas and raw data initialization behaves exactly like DX11TextureImpl.
+	// it is also used as the render target (framebuffer) of SoftwareRendererImpl.
+	class SoftwareTextureImpl : public graphics::resource::ITextureImpl
+	{
+	private:
+		std::vector<uint32_t> m_pixels;
+		unsigned int m_width = 0;
+		unsigned int m_height = 0;
+
+	public:
+		SoftwareTextureImpl() = default;
+		virtual ~SoftwareTextureImpl() = default;
+
+		static constexpr const char* TypeName = "Software";
+		std::string GetTypeName() const override final;
+
+		// initialize methods
+		virtual bool Initialize(
+			unsigned int width, unsigned int height,
+			const void* srcData,
+			unsigned int bytesPerRow
+		) override final;
+
+		virtual bool Initialize(
+			unsigned int width, unsigned int height
+		) override final;
+
+		// only bitmap files are supported since there is no platform independent PNG decoder in the engine
+		virtual bool Initialize(const wchar_t* fileNamePath) override final;
+
+		virtual bool CanBind() override final;
+		virtual void Bind() override final;
+
+		// drawing methods. software renderer always draws into its own render target so begin/end are no-op
+		virtual void BeginDraw() override final;
+		virtual void Clear(float red, float green, float blue, float alpha) override final;
+		virtual void EndDraw() override final;
+
+		virtual const unsigned int GetWidth() const override final;
+		virtual const unsigned int GetHeight() const override final;
+
+		virtual void Reset() override final;
+
+		// saves as bitmap
+		virtual bool SaveToFile(const wchar_t* filename) override final;
+
+		// direct access to pixels for the rasterizer. row major, no padding between rows
+		const uint32_t* GetPixels() const
+		{
+			return m_pixels.data();
+		}
+
+		uint32_t* GetPixels()
+		{
+			return m_pixels.data();
+		}
+	};
+}
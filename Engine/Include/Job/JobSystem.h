@@ -0,0 +1,143 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace job
+{
+	class JobSystem;
+
+	// refers to a job created by a JobSystem. stays valid to query after the job finished and its slot was reused
+	struct JobHandle
+	{
+		struct Job* job = nullptr;
+		uint32_t generation = 0;
+
+		bool IsValid() const
+		{
+			return job != nullptr;
+		}
+	};
+
+	struct Job
+	{
+		std::function<void()> work;
+		std::function<void()> continuation;		// runs on main thread after job and all its children finished
+		Job* parent = nullptr;
+		std::atomic<uint32_t> unfinished{ 0 };	// 1 for itself plus 1 per unfinished child
+		std::atomic<uint32_t> generation{ 1 };	// bumped when the slot is recycled
+		Job* nextFree = nullptr;
+	};
+
+	// work stealing job system.
+	// design consideration:
+	//	-	one deque per thread. main thread (the one that called Start) is deque 0, workers are 1..n. a thread
+	//		pushes and pops its own deque at the back (last in first out, warm caches), idle threads steal from the
+	//		front of other deques (oldest, usually biggest pieces of work)
+	//	-	deques are guarded by a mutex each. contention only happens on a steal, which is rare when every worker
+	//		has work. a lock free deque would save a few ns per job, not worth the risk for jobs of the size we run
+	//		(pathfinding, file parsing, animation batches)
+	//	-	parent/child: a child keeps its parent unfinished. a parent is done when its own work and every child is.
+	//		children must be created before parent finishes, i.e. before parent is submitted or from inside its work
+	//	-	continuations run on main thread when RunContinuations is called. engine calls it once per lap after the
+	//		scheduler, so results of background work are applied at one known point in the frame, never mid-update
+	//	-	Wait does not block the calling thread. it runs other jobs until the awaited one is done
+	//	-	job slots come from a pool and are recycled. handles carry a generation, so a handle to a recycled slot
+	//		simply reads as done
+	//	-	with no workers (Start(0) or never started) Submit runs the job right away on the calling thread
+	class JobSystem
+	{
+	private:
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<Job*> jobs;
+		};
+
+		std::vector<std::unique_ptr<WorkQueue>> m_queues;
+		std::vector<std::thread> m_workers;
+		std::atomic<bool> m_running{ false };
+
+		// sleeping workers wait for this to go above zero
+		std::atomic<size_t> m_pending{ 0 };
+		std::mutex m_wakeMutex;
+		std::condition_variable m_wakeCondition;
+
+		// job pool. jobs are never freed while system lives, so handles can always be read
+		std::mutex m_poolMutex;
+		std::deque<Job> m_pool;
+		Job* m_freeList = nullptr;
+
+		// continuations of finished jobs waiting for main thread
+		std::mutex m_continuationMutex;
+		std::vector<std::function<void()>> m_continuations;
+		std::vector<std::function<void()>> m_runningContinuations;
+
+		size_t QueueIndex() const;
+		Job* Allocate();
+		void Release(Job* job);
+		Job* Pop(size_t index);
+		Job* Steal(size_t index);
+		Job* Next(size_t index);
+		void Execute(Job* job);
+		void Finish(Job* job);
+		void WorkerLoop(size_t index);
+
+	public:
+		JobSystem() = default;
+		~JobSystem();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		// starts workers. calling thread becomes main thread. workerCount -1 means one per core minus main thread
+		void Start(int workerCount = -1);
+
+		// finishes queued jobs, then joins workers
+		void Stop();
+
+		size_t GetWorkerCount() const
+		{
+			return m_workers.size();
+		}
+
+		// index of the calling thread: 0 for main thread, 1..GetWorkerCount() for workers. it never changes for a
+		// thread, so jobs can pick per thread state by it without a lock (size that state GetWorkerCount() + 1).
+		// threads outside this system get 0 too and must not use it while main thread does
+		size_t GetCurrentWorker() const
+		{
+			return QueueIndex();
+		}
+
+		// creates a job without running it. parent, if given, stays unfinished until this job is done
+		JobHandle Create(std::function<void()> work, JobHandle parent = JobHandle());
+
+		// continuation for a created job that is not submitted yet. runs on main thread in RunContinuations
+		void OnComplete(JobHandle handle, std::function<void()> continuation);
+
+		void Submit(JobHandle handle);
+
+		// Create and Submit
+		JobHandle Run(std::function<void()> work, JobHandle parent = JobHandle());
+
+		// splits [0, count) into batches of batchSize and runs work(begin, end) for each as children of one job.
+		// returned job is done when every batch is
+		JobHandle ParallelFor(size_t count, size_t batchSize, std::function<void(size_t, size_t)> work);
+
+		bool IsDone(JobHandle handle) const;
+
+		// runs other jobs until job is done
+		void Wait(JobHandle handle);
+
+		// runs continuations of jobs finished since last call, in the order they finished. main thread only.
+		// returns how many ran
+		size_t RunContinuations();
+	};
+}
@@ -17,7 +17,7 @@ namespace math
 		Vector() : x(0), y(0) {}
 		Vector(T _x, T _y) : x(_x), y(_y) {}
 		explicit Vector(T scalar) : x(scalar), y(scalar) {}
-		~Vector() {}
+		~Vector() = default; // defaulted so Vector stays trivially destructible
 
 		// Operator overloads
 		Vector& operator =  (const Vector& rhs) = default;
@@ -1,8 +1,22 @@
 #pragma once
-#include <deque>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
 
 namespace performance
 {
+	// distribution of frame times in the monitor's window, same unit as elapsed times fed to the monitor
+	struct FrameTimeStatistics
+	{
+		float p50 = 0.0f;
+		float p90 = 0.0f;
+		float p99 = 0.0f;
+		float max = 0.0f;
+		size_t overBudget = 0;		// frames longer than frame budget
+		size_t frames = 0;			// frames in window
+	};
+
 	// design consideration
 	//	- this will be used exclusively by the engine to monitor frame rate. 
 	//	- engine will provide facade methods to query frame rate info and will be responsible to feed elapsed time and define unit resolution
@@ -12,28 +26,76 @@ namespace performance
 	//	- engine will provide elapsed time every frame via OnFrameCompleted method. so this method must be called every frame in application loop
 	//	- the class will accumulate elapsed times until the total elapsed time exceeds the measure range
 	//	- the measure range is a unit of time that defines how long the average frame rate is calculated. it can be set via SetMeasureRange method
-	//	- once the accumulated elapsed time exceeds the measure range, the oldest elapsed times are removed until the total elapsed time is within the measure range
-	//	- to achieve this, a deque is used to store elapsed times for easy removal from the front (oldest)
+	//	- once the accumulated elapsed time exceeds the measure range, the oldest elapsed times are removed until the total elapsed time is within the measure range.
+	//	  the newest frame is never removed, so a frame longer than the measure range still shows in max, percentiles and over budget count
+	//	- elapsed times are kept in a ring buffer of fixed capacity, allocated once. nothing is allocated per frame
 	//  - this enables efficient frame rate monitoring and management. no iteration over all frames is needed to calculate average frame rate
 	// 	- the class provides methods to get average frame rate over the measure range and last frame rate
+	// on frame time percentiles
+	//	- averages hide stutters. frames in the window are also counted in a log-linear (hdr style) histogram: 64 linear buckets, then
+	//	  32 buckets per power of two. any value is off by at most ~3% of itself, whatever its magnitude
+	//	- histogram is updated when a frame enters or leaves the window, so percentiles cost one walk over the buckets when queried and
+	//	  nothing per frame. max is exact, it is taken from the ring. percentiles are clamped to it, a bucket's value may lie above the
+	//	  slowest frame that fell in it
+	//	- histogram resolution (smallest distinguishable frame time) is in the monitor's unit, default suits seconds
+	//	- over budget count is kept the same way, against a budget set with SetFrameBudget. zero budget turns it off
 	// limitations
-	// 	- if measure range is smaller than the elapsed time of a single frame, average frame rate will be zero until enough frames accumulate
-	//	  to exceed the measure range. so if frame rate is fixed low (e.g. 1 FPS) and measure range is lower than that (e.g. 0.5 second), average frame rate will be zero
+	// 	- if a single frame is longer than the measure range, the window holds only that frame until the next one arrives. average frame rate
+	//	  is then the rate of that one frame, e.g. 1 at a fixed 1 FPS with a measure range of 0.5 seconds, and the window is longer than the range
+	//	- window holds at most capacity frames. at frame rates above capacity / measure range the window is shorter than measure range
 	class FrameRateMonitor
 	{
 	private:
+		static constexpr uint32_t LinearBuckets = 64;
+		static constexpr uint32_t SubBuckets = 32;
+		static constexpr uint32_t Octaves = 26;
+		static constexpr uint32_t BucketCount = LinearBuckets + (Octaves - 1) * SubBuckets;
+
 		float m_measureRange;
-		std::deque<float> m_elapsedTimes;
 		float m_elapsedTimeAccumulator;
 
+		// ring of elapsed times in window
+		std::vector<float> m_elapsedTimes;
+		size_t m_head;		// oldest
+		size_t m_count;
+
+		float m_resolution;
+		std::array<uint32_t, BucketCount> m_histogram;
+
+		float m_frameBudget;
+		size_t m_overBudget;
+
+		uint32_t BucketOf(float elapsedTime) const;
+		float BucketValue(uint32_t bucket) const;
+		void Remove();
+
+		// exact, walks the ring
+		float GetMaxFrameTime() const;
+
+		// percentile clamped to max, so it never reports a frame slower than the slowest one in window
+		float GetFrameTimePercentile(float percent, float max) const;
+
 	public:
-		FrameRateMonitor(float measureRange = 1.0f);
+		FrameRateMonitor(float measureRange = 1.0f, size_t capacity = 4096, float resolution = 0.00001f);
 
 		void SetMeasureRange(float range);
 		float GetAverageFrameRate() const;
 		float GetLastFrameRate() const;
 
+		// frames longer than budget are counted as over budget
+		void SetFrameBudget(float budget);
+
+		float GetFrameBudget() const
+		{
+			return m_frameBudget;
+		}
+
+		// frame time below which percent (0..100) of frames in window fall. never above the window's max
+		float GetFrameTimePercentile(float percent) const;
+
+		FrameTimeStatistics GetFrameTimeStatistics() const;
+
 		// using "On" prefix to follow event handler naming convention since this method is used as event handler - it is called when a frame is completed
 		void OnFrameCompleted(float elapsedTime);
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <Core/Singleton.h>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+// scoped cpu profiling markers. compiled in for debug builds, or when ENABLE_PROFILER is defined.
+// DISABLE_PROFILER compiles them out everywhere
+#if !defined(DISABLE_PROFILER) && (!defined(NDEBUG) || defined(ENABLE_PROFILER))
+#define PROFILER_ENABLED 1
+#else
+#define PROFILER_ENABLED 0
+#endif
+
+namespace performance
+{
+	// hierarchical cpu profiler with chrome trace export.
+	// design consideration:
+	//	-	markers are scopes (PROFILE_SCOPE, PROFILE_FUNCTION). one complete event (name, start, duration, depth) is
+	//		written when a scope ends. nesting comes out of start and duration, trace viewers rebuild the hierarchy
+	//	-	each thread records into its own buffer, so recording takes no lock. a buffer has one writer, the count
+	//		it publishes with release is what readers see
+	//	-	recording only happens during a capture (BeginCapture / EndCapture). outside a capture a marker costs one
+	//		relaxed load. buffers are fixed size and never wrap, events past capacity are counted as dropped
+	//	-	EndCapture waits for writes already past their check to land, after that buffers are stable and can be
+	//		exported from any thread
+	//	-	names are not copied. pass string literals (or strings that outlive the export)
+	//	-	export is chrome trace event json, loads in chrome://tracing, about:tracing and perfetto
+	class Profiler : public core::Singleton<Profiler>
+	{
+	private:
+		friend class core::Singleton<Profiler>;
+
+		using Clock = std::chrono::steady_clock;
+
+		struct Record
+		{
+			const char* name;
+			int64_t start;		// ns since capture began
+			int64_t duration;	// ns
+			uint32_t depth;
+		};
+
+		struct ThreadBuffer
+		{
+			std::vector<Record> records;
+			std::atomic<size_t> count{ 0 };
+			std::atomic<bool> writing{ false };
+			uint32_t depth = 0;
+			uint32_t id = 0;
+			std::string name;
+			std::atomic<size_t> dropped{ 0 };
+		};
+
+		std::mutex m_mutex;										// guards buffer list only
+		std::vector<std::unique_ptr<ThreadBuffer>> m_buffers;
+		std::atomic<bool> m_capturing{ false };
+		Clock::time_point m_captureStart;
+		size_t m_capacity = 1 << 16;
+
+		Profiler() = default;
+
+		ThreadBuffer& GetThreadBuffer();
+
+	public:
+		// a marker. records its lifetime if a capture is running when it is created
+		class Scope
+		{
+		private:
+			const char* m_name;
+			ThreadBuffer* m_buffer = nullptr;
+			Clock::time_point m_start;
+
+		public:
+			explicit Scope(const char* name)
+				: m_name(name)
+			{
+				Profiler& profiler = Profiler::Instance();
+				if (profiler.m_capturing.load(std::memory_order_relaxed))
+				{
+					m_buffer = &profiler.GetThreadBuffer();
+					++m_buffer->depth;
+					m_start = Clock::now();
+				}
+			}
+
+			~Scope()
+			{
+				if (m_buffer)
+				{
+					Profiler::Instance().Write(*m_buffer, m_name, m_start, Clock::now());
+				}
+			}
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		};
+
+		// events each thread can record per capture. applies to buffers created after the call
+		void SetCapacity(size_t capacity)
+		{
+			m_capacity = capacity > 0 ? capacity : 1;
+		}
+
+		// names calling thread in exported traces
+		void SetThreadName(const std::string& name);
+
+		// clears buffers and starts recording
+		void BeginCapture();
+
+		// stops recording. returns once no thread is still writing
+		void EndCapture();
+
+		bool IsCapturing() const
+		{
+			return m_capturing.load(std::memory_order_relaxed);
+		}
+
+		// events recorded by all threads in last capture
+		size_t GetEventCount();
+
+		// events lost to full buffers in last capture
+		size_t GetDroppedCount();
+
+		// chrome trace event json of last capture. call after EndCapture
+		std::string ExportChromeTrace();
+
+		bool SaveChromeTrace(const std::string& file);
+
+	private:
+		void Write(ThreadBuffer& buffer, const char* name, Clock::time_point start, Clock::time_point end);
+	};
+}
+
+#if PROFILER_ENABLED
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) performance::Profiler::Scope PROFILE_CONCAT(__profileScope, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#else
+#define PROFILE_SCOPE(name) do {} while (0)
+#define PROFILE_FUNCTION() do {} while (0)
+#endif
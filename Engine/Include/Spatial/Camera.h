@@ -103,6 +103,12 @@ namespace spatial
 			return m_viewport;
 		}
 
+		// part of the world currently seen through the viewport, in world space. use it to cull world objects
+		math::geometry::Rect<T> GetVisibleRect() const
+		{
+			return { m_position.x, m_position.y, m_position.x + m_viewport.GetWidth(), m_position.y + m_viewport.GetHeight() };
+		}
+
 		// Converts a world position to screen-space
 		spatial::Position<T> WorldToScreen(spatial::Position<T> worldPos) const
 		{
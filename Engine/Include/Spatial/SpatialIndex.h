@@ -0,0 +1,326 @@
+#pragma once
+#include <Math/Rect.h>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace spatial
+{
+	// dynamic 2d spatial index for culling. objects are world space rects with a value attached (e.g. what to draw).
+	// design consideration:
+	//	-	loose uniform grid. an object is stored in the one cell that contains its center, so insert, move and
+	//		remove are O(1) and an object is never stored twice
+	//	-	a query grows the rect by the largest half size of stored objects, so objects whose center is in a
+	//		neighbouring cell but that reach into the rect are still found. objects larger than a cell are kept in a
+	//		separate list that every query checks, so a few huge objects do not make every query touch more cells
+	//	-	objects outside world bounds are stored in the nearest border cell. they are still found, just slower
+	//	-	objects are addressed by handle. handles carry a generation, so a handle of a removed object does not
+	//		alias a new object that reuses its slot
+	//	-	pick cell size around the size of typical objects, or a fraction of the viewport
+	template<typename T>
+	class SpatialIndex
+	{
+	public:
+		struct Handle
+		{
+			uint32_t index = 0xffffffff;
+			uint32_t generation = 0;
+
+			bool IsValid() const
+			{
+				return index != 0xffffffff;
+			}
+
+			bool operator==(const Handle& other) const
+			{
+				return index == other.index && generation == other.generation;
+			}
+
+			bool operator!=(const Handle& other) const
+			{
+				return !(*this == other);
+			}
+		};
+
+	private:
+		static constexpr uint32_t OversizeCell = 0xffffffff;
+
+		struct Slot
+		{
+			T value;
+			math::geometry::RectF bounds;
+			uint32_t cell;
+			uint32_t cellPos;		// position in cell (or oversize) list. allows O(1) removal
+			uint32_t generation;
+			bool alive;
+		};
+
+		std::vector<Slot> m_slots;
+		std::vector<uint32_t> m_freeSlots;
+
+		std::vector<std::vector<uint32_t>> m_cells;
+		std::vector<uint32_t> m_oversize;
+
+		math::geometry::RectF m_worldBounds;
+		float m_cellSize;
+		float m_invCellSize;
+		int m_columns;
+		int m_rows;
+
+		// loose margin. only grows, shrinking it would need a scan of all objects
+		float m_maxHalfWidth = 0.0f;
+		float m_maxHalfHeight = 0.0f;
+
+		size_t m_count = 0;
+
+		int ToColumn(float x) const
+		{
+			return std::clamp(static_cast<int>(std::floor((x - m_worldBounds.left) * m_invCellSize)), 0, m_columns - 1);
+		}
+
+		int ToRow(float y) const
+		{
+			return std::clamp(static_cast<int>(std::floor((y - m_worldBounds.top) * m_invCellSize)), 0, m_rows - 1);
+		}
+
+		uint32_t FindCell(const math::geometry::RectF& bounds) const
+		{
+			float halfWidth = bounds.GetWidth() * 0.5f;
+			float halfHeight = bounds.GetHeight() * 0.5f;
+			if (halfWidth > m_cellSize || halfHeight > m_cellSize)
+			{
+				return OversizeCell;
+			}
+
+			int col = ToColumn(bounds.left + halfWidth);
+			int row = ToRow(bounds.top + halfHeight);
+			return static_cast<uint32_t>(row * m_columns + col);
+		}
+
+		std::vector<uint32_t>& GetList(uint32_t cell)
+		{
+			return cell == OversizeCell ? m_oversize : m_cells[cell];
+		}
+
+		void Link(uint32_t index, uint32_t cell)
+		{
+			Slot& slot = m_slots[index];
+			std::vector<uint32_t>& list = GetList(cell);
+			slot.cell = cell;
+			slot.cellPos = static_cast<uint32_t>(list.size());
+			list.push_back(index);
+
+			if (cell != OversizeCell)
+			{
+				m_maxHalfWidth = std::max(m_maxHalfWidth, slot.bounds.GetWidth() * 0.5f);
+				m_maxHalfHeight = std::max(m_maxHalfHeight, slot.bounds.GetHeight() * 0.5f);
+			}
+		}
+
+		void Unlink(uint32_t index)
+		{
+			Slot& slot = m_slots[index];
+			std::vector<uint32_t>& list = GetList(slot.cell);
+
+			// swap with last and fix position of the moved one
+			uint32_t last = list.back();
+			list[slot.cellPos] = last;
+			m_slots[last].cellPos = slot.cellPos;
+			list.pop_back();
+		}
+
+		const Slot& GetSlot(Handle handle) const
+		{
+			if (!IsValid(handle))
+			{
+				throw std::out_of_range("SpatialIndex - invalid handle");
+			}
+			return m_slots[handle.index];
+		}
+
+		template<typename Visitor>
+		void VisitList(const std::vector<uint32_t>& list, const math::geometry::RectF& area, Visitor& visitor) const
+		{
+			for (uint32_t index : list)
+			{
+				const Slot& slot = m_slots[index];
+				if (slot.bounds.Overlaps(area))
+				{
+					visitor(Handle{ index, slot.generation }, slot.value);
+				}
+			}
+		}
+
+	public:
+		SpatialIndex(const math::geometry::RectF& worldBounds, float cellSize) :
+			m_worldBounds(worldBounds),
+			m_cellSize(cellSize > 0.0f ? cellSize : 1.0f)
+		{
+			m_invCellSize = 1.0f / m_cellSize;
+			m_columns = std::max(1, static_cast<int>(std::ceil(worldBounds.GetWidth() * m_invCellSize)));
+			m_rows = std::max(1, static_cast<int>(std::ceil(worldBounds.GetHeight() * m_invCellSize)));
+			m_cells.resize(static_cast<size_t>(m_columns) * m_rows);
+		}
+
+		~SpatialIndex() = default;
+
+		Handle Insert(const math::geometry::RectF& bounds, T value)
+		{
+			uint32_t index;
+			if (!m_freeSlots.empty())
+			{
+				index = m_freeSlots.back();
+				m_freeSlots.pop_back();
+				Slot& slot = m_slots[index];
+				slot.value = std::move(value);
+				slot.bounds = bounds;
+				slot.alive = true;
+			}
+			else
+			{
+				index = static_cast<uint32_t>(m_slots.size());
+				m_slots.push_back({ std::move(value), bounds, 0, 0, 0, true });
+			}
+
+			Link(index, FindCell(bounds));
+			++m_count;
+			return Handle{ index, m_slots[index].generation };
+		}
+
+		// updates bounds of an object. only touches cell lists if its center crossed into another cell
+		void Move(Handle handle, const math::geometry::RectF& bounds)
+		{
+			GetSlot(handle);
+
+			Slot& slot = m_slots[handle.index];
+			slot.bounds = bounds;
+
+			uint32_t cell = FindCell(bounds);
+			if (cell != slot.cell)
+			{
+				Unlink(handle.index);
+				Link(handle.index, cell);
+			}
+			else if (cell != OversizeCell)
+			{
+				m_maxHalfWidth = std::max(m_maxHalfWidth, bounds.GetWidth() * 0.5f);
+				m_maxHalfHeight = std::max(m_maxHalfHeight, bounds.GetHeight() * 0.5f);
+			}
+		}
+
+		void Remove(Handle handle)
+		{
+			if (!IsValid(handle))
+			{
+				return;
+			}
+
+			Unlink(handle.index);
+			Slot& slot = m_slots[handle.index];
+			slot.alive = false;
+			++slot.generation;
+			m_freeSlots.push_back(handle.index);
+			--m_count;
+		}
+
+		void Clear()
+		{
+			for (std::vector<uint32_t>& cell : m_cells)
+			{
+				cell.clear();
+			}
+			m_oversize.clear();
+			m_freeSlots.clear();
+
+			// keep generations so old handles stay invalid
+			for (uint32_t i = 0; i < static_cast<uint32_t>(m_slots.size()); ++i)
+			{
+				if (m_slots[i].alive)
+				{
+					m_slots[i].alive = false;
+					++m_slots[i].generation;
+				}
+				m_freeSlots.push_back(i);
+			}
+
+			m_maxHalfWidth = 0.0f;
+			m_maxHalfHeight = 0.0f;
+			m_count = 0;
+		}
+
+		bool IsValid(Handle handle) const
+		{
+			return handle.index < m_slots.size() && m_slots[handle.index].alive && m_slots[handle.index].generation == handle.generation;
+		}
+
+		const T& Get(Handle handle) const
+		{
+			return GetSlot(handle).value;
+		}
+
+		T& Get(Handle handle)
+		{
+			GetSlot(handle);
+			return m_slots[handle.index].value;
+		}
+
+		const math::geometry::RectF& GetBounds(Handle handle) const
+		{
+			return GetSlot(handle).bounds;
+		}
+
+		// calls visitor(Handle, const T&) for every object whose bounds overlap area. order is unspecified
+		template<typename Visitor>
+		void Query(const math::geometry::RectF& area, Visitor visitor) const
+		{
+			if (m_count == 0)
+			{
+				return;
+			}
+
+			VisitList(m_oversize, area, visitor);
+
+			int left = ToColumn(area.left - m_maxHalfWidth);
+			int right = ToColumn(area.right + m_maxHalfWidth);
+			int top = ToRow(area.top - m_maxHalfHeight);
+			int bottom = ToRow(area.bottom + m_maxHalfHeight);
+
+			for (int row = top; row <= bottom; ++row)
+			{
+				for (int col = left; col <= right; ++col)
+				{
+					VisitList(m_cells[row * m_columns + col], area, visitor);
+				}
+			}
+		}
+
+		// appends handles of objects overlapping area
+		void Query(const math::geometry::RectF& area, std::vector<Handle>& result) const
+		{
+			Query(area, [&result](Handle handle, const T&) { result.push_back(handle); });
+		}
+
+		size_t GetSize() const
+		{
+			return m_count;
+		}
+
+		bool IsEmpty() const
+		{
+			return m_count == 0;
+		}
+
+		float GetCellSize() const
+		{
+			return m_cellSize;
+		}
+
+		const math::geometry::RectF& GetWorldBounds() const
+		{
+			return m_worldBounds;
+		}
+	};
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <chrono>
+#include <atomic>
+#include <cstdint>
+
+namespace timer
+{
+	// source of "now" for timing code.
+	// design consideration:
+	//	-	stopwatch, pulse and engine read time through this instead of calling std::chrono directly, so the clock
+	//		can be swapped without touching them
+	//	-	all clocks hand out steady_clock time points. only differences between two readings of the same clock
+	//		mean anything, the epoch is whatever the clock picks
+	//	-	virtual clock only moves when told to. a simulation driven by it runs as fast as the cpu allows and gives
+	//		the same deltas on every run, which is what benchmarks and replays need
+	class IClock
+	{
+	public:
+		using TimePoint = std::chrono::steady_clock::time_point;
+		using Duration = std::chrono::steady_clock::duration;
+
+		virtual ~IClock() = default;
+
+		virtual TimePoint Now() const = 0;
+
+		// true if time does not pass on its own. waiting for a virtual clock in real time is pointless
+		virtual bool IsVirtual() const
+		{
+			return false;
+		}
+	};
+
+	// std::chrono::steady_clock. default for everything
+	class SteadyClock : public IClock
+	{
+	public:
+		virtual TimePoint Now() const override
+		{
+			return std::chrono::steady_clock::now();
+		}
+
+		// shared instance used when no clock is given
+		static const SteadyClock& Default()
+		{
+			static const SteadyClock clock;
+			return clock;
+		}
+	};
+
+	// cpu time stamp counter scaled to nanoseconds. cheaper to read than steady_clock on windows (no syscall path),
+	// needs an invariant tsc. calibrated against steady_clock on construction, which takes calibration time.
+	// falls back to steady_clock where there is no tsc
+	class TscClock : public IClock
+	{
+	private:
+		TimePoint m_base;
+		uint64_t m_baseTicks = 0;
+		double m_nanosecondsPerTick = 0.0;
+
+		static uint64_t ReadTicks();
+
+	public:
+		explicit TscClock(std::chrono::milliseconds calibration = std::chrono::milliseconds(20));
+
+		virtual TimePoint Now() const override;
+
+		// ticks per second found by calibration. 0 if falling back to steady_clock
+		double GetFrequency() const
+		{
+			return m_nanosecondsPerTick > 0.0 ? 1e9 / m_nanosecondsPerTick : 0.0;
+		}
+	};
+
+	// manually advanced clock. starts at its epoch, moves only by Advance or Set.
+	// reading is thread safe, advancing is meant for one thread
+	class VirtualClock : public IClock
+	{
+	private:
+		std::atomic<Duration::rep> m_elapsed{ 0 };
+
+	public:
+		virtual TimePoint Now() const override
+		{
+			return TimePoint(Duration(m_elapsed.load(std::memory_order_acquire)));
+		}
+
+		virtual bool IsVirtual() const override
+		{
+			return true;
+		}
+
+		template<typename Rep, typename Period>
+		void Advance(std::chrono::duration<Rep, Period> delta)
+		{
+			m_elapsed.fetch_add(std::chrono::duration_cast<Duration>(delta).count(), std::memory_order_acq_rel);
+		}
+
+		void Advance(float seconds)
+		{
+			Advance(std::chrono::duration<float>(seconds));
+		}
+
+		// time since epoch
+		void Set(Duration elapsed)
+		{
+			m_elapsed.store(elapsed.count(), std::memory_order_release);
+		}
+
+		Duration GetElapsed() const
+		{
+			return Duration(m_elapsed.load(std::memory_order_acquire));
+		}
+	};
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <Core/Event.h>
+#include <cstdint>
+#include <cstddef>
+
+namespace timer
+{
+	// steps a simulation at a fixed rate out of variable frame deltas.
+	// design consideration:
+	//	-	frame delta goes into an accumulator, StepEvent fires once per whole step in it. simulation code sees the
+	//		same delta every time, so its cost and behaviour no longer depend on frame time
+	//	-	catch up is capped. after a spike at most maxStepsPerUpdate steps run, whole steps beyond that are dropped
+	//		(counted as dropped) and the phase within a step is kept. a long hitch then costs a bounded burst of steps
+	//		instead of a spiral where catching up makes the next frame slower
+	//	-	alpha is how far time is into the next step (accumulator / step, 0..1). renderer blends previous and
+	//		current simulation state by it, so motion stays smooth when rendering faster than simulating
+	//	-	alpha is 1 until first update. state drawn by something that never steps is drawn as is
+	class FixedTimestep
+	{
+	public:
+		struct Statistics
+		{
+			uint64_t steps = 0;				// steps run
+			uint64_t caughtUpSteps = 0;		// steps run beyond the first in one update (frame was longer than a step)
+			uint64_t droppedSteps = 0;		// whole steps thrown away because of the catch up cap
+			size_t lastSteps = 0;			// steps run by last update
+			size_t maxSteps = 0;			// most steps run by one update
+		};
+
+		// fires every step with the step length
+		event::Event<float> StepEvent;
+
+	private:
+		float m_step;
+		size_t m_maxStepsPerUpdate;
+		float m_accumulator = 0.0f;
+		float m_alpha = 1.0f;
+
+		Statistics m_statistics;
+
+	public:
+		explicit FixedTimestep(float rate = 60.0f, size_t maxStepsPerUpdate = 5);
+		~FixedTimestep() = default;
+
+		// advances time by delta and runs the steps that fit. returns how many ran
+		size_t Update(float delta);
+
+		// drops accumulated time, e.g. after loading when the frame delta means nothing
+		void Reset();
+
+		void SetRate(float rate);
+
+		void SetMaxStepsPerUpdate(size_t maxStepsPerUpdate)
+		{
+			m_maxStepsPerUpdate = maxStepsPerUpdate > 0 ? maxStepsPerUpdate : 1;
+		}
+
+		float GetRate() const
+		{
+			return 1.0f / m_step;
+		}
+
+		float GetStep() const
+		{
+			return m_step;
+		}
+
+		size_t GetMaxStepsPerUpdate() const
+		{
+			return m_maxStepsPerUpdate;
+		}
+
+		// interpolation factor between previous and current simulation state
+		float GetAlpha() const
+		{
+			return m_alpha;
+		}
+
+		// time left until next step is due. used by frame pacing
+		float GetTimeUntilNextStep() const
+		{
+			return m_step > m_accumulator ? m_step - m_accumulator : 0.0f;
+		}
+
+		const Statistics& GetStatistics() const
+		{
+			return m_statistics;
+		}
+
+		void ResetStatistics()
+		{
+			m_statistics = Statistics();
+		}
+	};
+}
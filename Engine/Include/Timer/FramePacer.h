@@ -0,0 +1,98 @@
+#pragma once
+#include <chrono>
+
+namespace timer
+{
+	// waits for the next frame deadline without burning a core.
+	// design consideration:
+	//	-	hybrid wait: coarse OS sleep for most of the wait, then spin for a short tail. OS sleep alone wakes up late
+	//		by up to a scheduler tick, spinning alone keeps the main thread at 100%
+	//	-	spin tail is not a constant. pacer measures how late sleeps wake up and keeps the tail a bit above the
+	//		worst recent overshoot, so on hosts with coarse timers it spins longer instead of missing deadlines
+	//	-	deadline is set right after a frame with the time left until the next thing is due (see
+	//		FrameRateController::GetTimeUntilNextFrame and Scheduler::GetTimeUntilNextTrigger), and waited on just
+	//		before the next frame. time spent in between (e.g. processing window messages) counts towards the wait
+	//	-	jitter is how late Wait returned relative to the deadline. it is what a frame loses to pacing
+	//	-	Spin mode keeps old behaviour (no wait at all) for profiling
+	class FramePacer
+	{
+	public:
+		enum class Mode
+		{
+			Spin,	// never wait
+			Hybrid	// sleep then spin
+		};
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		Mode m_mode;
+		Clock::time_point m_deadline;
+		bool m_hasDeadline = false;
+
+		// spin tail in seconds. starts at a value that covers a default windows timer tick after timeBeginPeriod(1)
+		float m_spinMargin = 0.002f;
+
+		float m_lastJitter = 0.0f;
+		float m_maxJitter = 0.0f;
+		double m_jitterSum = 0.0;
+		size_t m_jitterCount = 0;
+
+		float m_sleptTime = 0.0f;
+
+	public:
+		static constexpr float MinSpinMargin = 0.0005f;
+		static constexpr float MaxSpinMargin = 0.004f;
+
+		explicit FramePacer(Mode mode = Mode::Hybrid);
+		~FramePacer();
+
+		FramePacer(const FramePacer&) = delete;
+		FramePacer& operator=(const FramePacer&) = delete;
+
+		void SetMode(Mode mode)
+		{
+			m_mode = mode;
+		}
+
+		Mode GetMode() const
+		{
+			return m_mode;
+		}
+
+		// sets next deadline to now + seconds. negative or zero means next frame is already due
+		void Schedule(float seconds);
+
+		// blocks until deadline set by Schedule. returns immediately if there is none or it has passed
+		void Wait();
+
+		// how late last Wait returned, in seconds
+		float GetLastJitter() const
+		{
+			return m_lastJitter;
+		}
+
+		float GetAverageJitter() const
+		{
+			return m_jitterCount > 0 ? static_cast<float>(m_jitterSum / m_jitterCount) : 0.0f;
+		}
+
+		float GetMaxJitter() const
+		{
+			return m_maxJitter;
+		}
+
+		float GetSpinMargin() const
+		{
+			return m_spinMargin;
+		}
+
+		// total time given back to the OS since last ResetStatistics, in seconds
+		float GetSleptTime() const
+		{
+			return m_sleptTime;
+		}
+
+		void ResetStatistics();
+	};
+}
@@ -34,6 +34,22 @@ namespace timer
 			}
 		}
 
+		void SetTargetFrameRate(float targetFPS)
+		{
+			m_targetInterval = 1.0f / targetFPS;
+		}
+
+		float GetTargetInterval() const
+		{
+			return m_targetInterval;
+		}
+
+		// time left until next frame is due. used by frame pacing to sleep instead of polling
+		float GetTimeUntilNextFrame() const
+		{
+			return m_targetInterval > m_elapsedTimeAccumulator ? m_targetInterval - m_elapsedTimeAccumulator : 0.0f;
+		}
+
 		// subscribe as free function
 		void operator+=(event::Handler<void, void, float> handler)
 		{
@@ -1,7 +1,9 @@
 #pragma once
 #include <stdexcept>
 #include <iostream>
+#include <limits>
 #include <Core/Event.h>
+#include <Timer/Clock.h>
 
 namespace timer
 {
@@ -35,6 +37,11 @@ namespace timer
     //      -   but it becomes very inconvenient to have to subscribe to the event
     //          just to reset. so this option is provided. if listeners decided to 
     //          not use this and instead do it via event, it can still do so.
+    //  -   on clock
+    //      -   pulse is fed deltas by whoever drives it, so it has no clock of its own
+    //          by default. a pulse that is not part of a loop can be given a clock and
+    //          polled with Update(), it then measures its own delta in seconds.
+    //          with a VirtualClock that makes it fully deterministic
     //------------------------------------------------------------------------------
     class Pulse
     {
@@ -56,6 +63,8 @@ namespace timer
         bool m_running;
         size_t m_maxTriggerPerUpdate;
         bool m_resetOnOverflow;
+        const IClock* m_clock = nullptr;
+        IClock::TimePoint m_lastUpdateTime;
 
     public:
         Pulse(float interval, Mode mode = Mode::Persistent, bool resetOnOverflow = false, size_t maxTriggerPerUpdate = 5);
@@ -79,6 +88,16 @@ namespace timer
             return m_resetOnOverflow;
         }
 
+        // time left until next trigger, in same unit as interval. infinity if pulse is not running
+        float GetTimeUntilNextTrigger() const
+        {
+            if (!m_running)
+            {
+                return std::numeric_limits<float>::infinity();
+            }
+            return m_interval > m_elapsedTimeAccumulator ? m_interval - m_elapsedTimeAccumulator : 0.0f;
+        }
+
         // Advances the timer by deltaSeconds.
         // delta - this value is relative. the provider for this value defines its unit.
         // Accumulates time and fires:
@@ -86,6 +105,18 @@ namespace timer
         // - OnInterval once for OneShot  
         // - OnMaxIntervalPerUpdateReached if triggers exceed cap 
         void Update(float delta);
+
+        // advances the timer by seconds passed on its clock since last Update() or SetClock.
+        // does nothing if there is no clock
+        void Update();
+
+        // clock for Update(). must outlive the pulse, nullptr removes it
+        void SetClock(const IClock* clock);
+
+        const IClock* GetClock() const
+        {
+            return m_clock;
+        }
     };
 }
 
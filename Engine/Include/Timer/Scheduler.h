@@ -1,6 +1,10 @@
 #pragma once
 #include <vector>
-#include <Timer/Pulse.h>
+#include <limits>
+#include <cstdint>
+#include <functional>
+#include <Core/Event.h>
+#include <Job/JobSystem.h>
 // -----------------------------------------------------------------------------------------------------------
 // design consideration:
 // 	-	originally designed as frame rate controller but end up being more general purpose scheduler
@@ -16,6 +20,27 @@
 // 			it will still cost unnecessary overhead
 // 		-	Pulse has option to reset on overflow. so if a schedule wants to clear accumulated
 // 			elapsed time on overflow, it can enable it
+// 	-	on timing wheel instead of pulses
+// 		-	scheduler used to keep one Pulse per distinct interval and update every one of them each frame.
+// 			with thousands of gameplay timers (cooldowns, ai ticks, respawns) that is a cost per timer per frame
+// 			even though almost none of them fire
+// 		-	schedules now live in a hierarchical timing wheel. time is cut into ticks of fixed resolution.
+// 			level 0 has one slot per tick for the next 256 ticks, each level above has slots 256 times as
+// 			wide. a schedule goes into the finest level its due tick fits in, and moves down a level when the
+// 			wheel reaches its slot (cascade)
+// 		-	insert and cancel are O(1) (intrusive list per slot, node pool with free list). update only
+// 			touches slots the clock passed, so per frame cost follows the number of expiring schedules
+// 		-	exact due time is kept next to the tick, so intervals that are not multiples of the resolution
+// 			(1/60) don't drift. resolution only decides how many schedules share a slot
+// 		-	each schedule has its own phase, starting when it is added. schedules with the same interval no
+// 			longer share a pulse
+// 		-	maxTriggerPerUpdate and resetOnOverflow behave as they did on Pulse: a late schedule fires at most
+// 			maxTriggerPerUpdate times per update, the rest carries over unless resetOnOverflow drops it
+// 	-	on job schedules
+// 		-	AddJob runs a schedule's work on the job system instead of inline. its completion callback runs on
+// 			main thread when the job system runs continuations, engine does that right after updating scheduler
+// 		-	a job schedule that comes due while its last run is still going is skipped, slow background work
+// 			never piles up behind itself
 // 
 // -----------------------------------------------------------------------------------------------------------
 
@@ -99,74 +124,205 @@ namespace timer
 	// deduction guide for Lambda/std::function
 	Schedule(float, std::function<void(float)>)->Schedule<std::function<void(float)>>;
 
+	// identifies a schedule added to a Scheduler. stale handles (schedule already cancelled) are ignored
+	struct ScheduleHandle
+	{
+		uint32_t index = 0;
+		uint32_t generation = 0;	// 0 is never issued, so a default handle is invalid
+
+		bool IsValid() const
+		{
+			return generation != 0;
+		}
+	};
+
 	class Scheduler
 	{
 	private:
-		std::vector<std::unique_ptr<timer::Pulse>> m_pulses;
+		using Ops = event::detail::CallableOps<float>;
+
+		static constexpr uint32_t SlotBits = 8;
+		static constexpr uint32_t SlotsPerLevel = 1u << SlotBits;
+		static constexpr uint32_t SlotMask = SlotsPerLevel - 1;
+		static constexpr uint32_t Levels = 4;						// 2^32 ticks, ~49 days at 1 ms
+		static constexpr uint32_t ListCount = Levels * SlotsPerLevel + 2;
+		static constexpr uint32_t ExpiringList = ListCount - 2;		// schedules taken off a slot during update
+		static constexpr uint32_t LateList = ListCount - 1;			// hit maxTriggerPerUpdate, wait for next update
+		static constexpr uint32_t NoList = ~0u;
+		static constexpr uint32_t NoNode = ~0u;
 
-		timer::Pulse& GetOrCreatePulse(float interval, bool resetOnOverflow, size_t maxTriggerPerUpdate)
+		struct Node
 		{
-			for (auto& pulse : m_pulses)
+			const Ops* ops;
+			alignas(void*) unsigned char storage[event::detail::InlineCallableSize];
+
+			double due;					// exact due time
+			float interval;
+			size_t maxTriggerPerUpdate;
+			bool resetOnOverflow;
+
+			uint32_t generation;
+			uint32_t list;				// slot list this node is linked in, NoList if free or firing
+			uint32_t prev;
+			uint32_t next;
+			bool cancelled;				// cancelled while its handler was running
+		};
+
+		std::vector<Node> m_nodes;
+		uint32_t m_freeList = NoNode;
+		uint32_t m_heads[ListCount];
+		size_t m_count = 0;
+		uint32_t m_nextGeneration = 1;
+
+		job::JobSystem* m_jobSystem = nullptr;
+
+		double m_resolution;
+		double m_time = 0.0;
+		uint64_t m_tick = 0;			// wheel position. ticks before it are done, its own slot may still hold later schedules
+
+		uint64_t ToTick(double time) const;
+		void Link(uint32_t index, uint32_t list);
+		void Unlink(uint32_t index);
+		void Insert(uint32_t index);
+		void Cascade();
+		void Expire(uint32_t list);
+		void Release(uint32_t index);
+		double EarliestDue(uint32_t list) const;
+
+		template <typename F>
+		ScheduleHandle Add(F callable, float interval, bool resetOnOverflow, size_t maxTriggerPerUpdate)
+		{
+			uint32_t index;
+			if (m_freeList != NoNode)
+			{
+				index = m_freeList;
+				m_freeList = m_nodes[index].next;
+			}
+			else
+			{
+				index = static_cast<uint32_t>(m_nodes.size());
+				m_nodes.emplace_back();
+			}
+
+			Node& node = m_nodes[index];
+			if constexpr (std::is_trivially_copyable<F>::value && sizeof(F) <= event::detail::InlineCallableSize && alignof(F) <= alignof(void*))
+			{
+				node.ops = &event::detail::InlineCallable<F, float>::Ops;
+				new (node.storage) F(callable);
+			}
+			else
+			{
+				node.ops = &event::detail::BoxedCallable<F, float>::Ops;
+				new (node.storage) F*(new F(std::move(callable)));
+			}
+
+			node.due = m_time + interval;
+			node.interval = interval;
+			node.maxTriggerPerUpdate = maxTriggerPerUpdate;
+			node.resetOnOverflow = resetOnOverflow;
+			node.generation = m_nextGeneration++;
+			if (m_nextGeneration == 0)
 			{
-				if (pulse->GetInterval() == interval && pulse->GetMaxTriggerPerUpdate() == maxTriggerPerUpdate)
+				m_nextGeneration = 1;
+			}
+			node.list = NoList;
+			node.cancelled = false;
+
+			Insert(index);
+			++m_count;
+			return ScheduleHandle{ index, node.generation };
+		}
+
+		// cancels first schedule with the same callable and interval. O(schedules), handles cancel in O(1)
+		template <typename F>
+		void RemoveEqual(const F& callable, float interval)
+		{
+			const Ops* ops = &event::detail::InlineCallable<F, float>::Ops;
+			for (uint32_t i = 0; i < m_nodes.size(); ++i)
+			{
+				const Node& node = m_nodes[i];
+				if (node.generation != 0 && !node.cancelled && node.ops == ops && node.interval == interval && ops->equals(node.storage, &callable))
 				{
-					return *pulse;
+					Cancel(ScheduleHandle{ i, node.generation });
+					return;
 				}
 			}
-			// if not found, create a new one
-			m_pulses.push_back(std::make_unique<timer::Pulse>(interval, timer::Pulse::Mode::Persistent, resetOnOverflow, maxTriggerPerUpdate));
-			return *m_pulses.back();
 		}
 
 	public:
-		Scheduler() = default;
-		virtual ~Scheduler() = default;
+		// resolution is the tick length of the wheel, in same unit as update delta
+		explicit Scheduler(float resolution = 0.001f);
+		virtual ~Scheduler();
 
-		void Update(float time)
+		Scheduler(const Scheduler&) = delete;
+		Scheduler& operator=(const Scheduler&) = delete;
+
+		// advances time by delta and fires every schedule that came due
+		void Update(float time);
+
+		// time left until the earliest schedule fires. infinity if there is nothing scheduled
+		float GetTimeUntilNextTrigger() const;
+
+		// O(1). safe to call from a schedule handler, including for the schedule being fired
+		void Cancel(ScheduleHandle handle);
+
+		void Clear();
+
+		size_t Size() const
 		{
-			for (auto& pulse : m_pulses)
-			{
-				pulse->Update(time);
-			}
-		}		
+			return m_count;
+		}
+
+		float GetResolution() const
+		{
+			return static_cast<float>(m_resolution);
+		}
+
+		// job system AddJob schedules run on. without one they run inline
+		void SetJobSystem(job::JobSystem* jobSystem)
+		{
+			m_jobSystem = jobSystem;
+		}
+
+		// runs work(interval) as a job every interval. onComplete, if given, runs on main thread after each run
+		ScheduleHandle AddJob(float interval, std::function<void(float)> work, std::function<void()> onComplete = nullptr, bool resetOnOverflow = false, size_t maxTriggerPerUpdate = 1);
 
-		void operator += (const Schedule<void>& sched) 
+		ScheduleHandle operator += (const Schedule<void>& sched) 
 		{
-			Pulse& pulse = GetOrCreatePulse(sched.m_interval, sched.m_resetOnOverflow, sched.m_maxTriggerPerUpdate);
-			pulse.IntervalEvent += event::Handler(sched.m_pFunc);		
+			return Add(event::detail::FreeCallable<float>{ sched.m_pFunc }, sched.m_interval, sched.m_resetOnOverflow, sched.m_maxTriggerPerUpdate);
 		}
 
 		template <typename C>
-		void operator += (const Schedule<C>& sched) 
+		ScheduleHandle operator += (const Schedule<C>& sched) 
 		{
-			Pulse& pulse = GetOrCreatePulse(sched.m_interval, sched.m_resetOnOverflow, sched.m_maxTriggerPerUpdate);
-			pulse.IntervalEvent += event::Handler(sched.m_pInst, sched.m_pFunc);
+			return Add(event::detail::MemberCallable<C, float>{ sched.m_pFunc, sched.m_pInst }, sched.m_interval, sched.m_resetOnOverflow, sched.m_maxTriggerPerUpdate);
 		}
 
-		void operator += (const Schedule<std::function<void(float)>>& sched) 
+		ScheduleHandle operator += (const Schedule<std::function<void(float)>>& sched) 
 		{
-			Pulse& pulse = GetOrCreatePulse(sched.m_interval, sched.m_resetOnOverflow, sched.m_maxTriggerPerUpdate);
-			pulse.IntervalEvent += event::Handler(sched.m_func);
+			return Add(sched.m_func, sched.m_interval, sched.m_resetOnOverflow, sched.m_maxTriggerPerUpdate);
 		}
 
+		// lambdas can't be compared, so this never finds one. cancel lambdas with the handle += returned
 		void operator -= (const Schedule<std::function<void(float)>>& sched)
 		{
-			Pulse& pulse = GetOrCreatePulse(sched.m_interval, sched.m_resetOnOverflow, sched.m_maxTriggerPerUpdate);
-			pulse.IntervalEvent -= event::Handler(sched.m_func);
 		}
 
 		// symmetric -= for unsubscription
 		void operator -= (const Schedule<void>& sched) 
 		{
-			Pulse& pulse = GetOrCreatePulse(sched.m_interval, sched.m_resetOnOverflow, sched.m_maxTriggerPerUpdate);
-			pulse.IntervalEvent -= event::Handler(sched.m_pFunc);
+			RemoveEqual(event::detail::FreeCallable<float>{ sched.m_pFunc }, sched.m_interval);
 		}
 
 		template <typename C>
 		void operator -= (const Schedule<C>& sched) 
 		{
-			Pulse& pulse = GetOrCreatePulse(sched.m_interval, sched.m_resetOnOverflow, sched.m_maxTriggerPerUpdate);
-			pulse.IntervalEvent -= event::Handler(sched.m_pInst, sched.m_pFunc);
+			RemoveEqual(event::detail::MemberCallable<C, float>{ sched.m_pFunc, sched.m_pInst }, sched.m_interval);
+		}
+
+		void operator -= (ScheduleHandle handle)
+		{
+			Cancel(handle);
 		}
 	};
 
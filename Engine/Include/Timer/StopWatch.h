@@ -1,12 +1,9 @@
 #pragma once
 #include <Core/Event.h>
+#include <Timer/Clock.h>
 #include <chrono>
-#include <thread>
-#include <Windows.h>
 #include <ratio>
 
-#pragma comment(lib, "winmm.lib")
-
 namespace timer
 {
     using milliseconds = std::milli;
@@ -16,10 +13,14 @@ namespace timer
     //------------------------------------------------------------------------------
     // Measures *active* time (excluding pauses) across multiple pause/resume cycles.
     // Also supports lap functionality for measuring intervals between checkpoints.
+    // Reads time from an IClock, steady_clock unless another one is given. The
+    // clock must outlive the StopWatch.
     //------------------------------------------------------------------------------
     class StopWatch
     {
     private:
+        const IClock* m_clock;
+
         // snapshot of time when last lap occur. everytime pause happens, this is set as the paused time and time occurred before the pause and last lap time is accumulated
         std::chrono::steady_clock::time_point m_lastLapTime;
 
@@ -57,9 +58,20 @@ namespace timer
         event::Event<> OnResume;
 
     public:
-        StopWatch() noexcept;
+        explicit StopWatch(const IClock& clock = SteadyClock::Default()) noexcept;
         ~StopWatch() = default;
 
+        // switches time source. restart the StopWatch after, readings of different clocks don't mix
+        void SetClock(const IClock& clock) noexcept
+        {
+            m_clock = &clock;
+        }
+
+        const IClock& GetClock() const noexcept
+        {
+            return *m_clock;
+        }
+
         const bool IsRunning() const;
         const bool IsPaused() const;
 
@@ -93,7 +105,7 @@ namespace timer
             // 4. last lap may have started when timer is paused and is still paused now
 
             // measure current time (now or last paused time if paused)
-            std::chrono::steady_clock::time_point now = m_paused ? m_pausedStartTime : std::chrono::steady_clock::now();
+            std::chrono::steady_clock::time_point now = m_paused ? m_pausedStartTime : m_clock->Now();
 
             // calculate difference between start and previous lap 
             std::chrono::duration<float> elapsedTime = now - m_lastLapTime;
@@ -132,7 +144,7 @@ namespace timer
 
             // let's get the current time now. if timer is paused, we get the snapshot of when paused occurred instead
             // this is to disregard the duration between now and when paused started
-            std::chrono::steady_clock::time_point now = m_paused ? m_pausedStartTime : std::chrono::steady_clock::now();
+            std::chrono::steady_clock::time_point now = m_paused ? m_pausedStartTime : m_clock->Now();
 
             // calculate difference between start and now
             std::chrono::duration<float> elapsedTime = now - m_startTime;
@@ -165,7 +177,7 @@ namespace timer
 
             // let's get the current time now. if timer is paused, we get the snapshot of when paused occurred instead
             // this is to disregard the duration between now and when paused started
-            std::chrono::steady_clock::time_point now = m_paused ? m_pausedStartTime : std::chrono::steady_clock::now();
+            std::chrono::steady_clock::time_point now = m_paused ? m_pausedStartTime : m_clock->Now();
 
             // calculate difference between start and now
             std::chrono::duration<float> elapsedTime = now - m_startTime;
@@ -14,14 +14,17 @@ namespace timer
 
     namespace stopwatch
     {
+        // runs on a virtual clock. "sleeping" advances it, so the test is instant and readings are exact
         static void Test()
         {
+            VirtualClock clock;
+
             // test start, stop, peek
             {
-                StopWatch sw;
+                StopWatch sw(clock);
                 unsigned long sleep = 125;
                 sw.Start();
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 float total = static_cast<float>(sleep);
                 std::cout << "time started... sleep for " << std::to_string(sleep) << " ms" << std::endl;
 
@@ -29,14 +32,14 @@ namespace timer
                 std::cout << "peeked...did we see " << std::to_string(total) << " ms? peek: " << std::to_string(peek) << " ms" << std::endl;
 
                 sleep = 25;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 total += sleep;
                 peek = sw.Peek<timer::milliseconds>();
                 std::cout << "sleep for " << std::to_string(sleep) << " ms.." << std::endl;
                 std::cout << "peeked again...did we see " << std::to_string(total) << " ms? peek: " << std::to_string(peek) << " ms" << std::endl;
 
                 sleep = 50;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 total += sleep;
                 float stop = sw.Stop<timer::milliseconds>();
                 std::cout << "sleep for " << std::to_string(sleep) << " ms... then stop. " << std::endl;
@@ -47,10 +50,10 @@ namespace timer
             {
                 std::cout << std::endl;
 
-                StopWatch sw;
+                StopWatch sw(clock);
                 unsigned long sleep = 125;
                 sw.Start();
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 float totalExpectedElapsed = static_cast<float>(sleep);
                 std::cout << "time started... sleep for " << std::to_string(sleep) << " ms" << std::endl;
 
@@ -58,19 +61,19 @@ namespace timer
                 std::cout << "lapped...did we see " << std::to_string(sleep) << " ms? peek: " << std::to_string(lap) << " ms" << std::endl;
 
                 sleep = 75;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 totalExpectedElapsed += sleep;
                 lap = sw.Lap<timer::milliseconds>();
                 std::cout << "lapped...did we see " << std::to_string(sleep) << " ms? peek: " << std::to_string(lap) << " ms" << std::endl;
 
                 sleep = 123;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 totalExpectedElapsed += sleep;
                 lap = sw.Lap<timer::milliseconds>();
                 std::cout << "lapped...did we see " << std::to_string(sleep) << " ms? peek: " << std::to_string(lap) << " ms" << std::endl;
 
                 sleep = 249;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 totalExpectedElapsed += sleep;
                 lap = sw.Lap<timer::milliseconds>();
                 std::cout << "lapped...did we see " << std::to_string(sleep) << " ms? peek: " << std::to_string(lap) << " ms" << std::endl;
@@ -82,17 +85,17 @@ namespace timer
             {
                 std::cout << std::endl;
 
-                StopWatch sw;
+                StopWatch sw(clock);
                 unsigned long sleep = 125;
                 sw.Start();
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 float totalExpectedElapsed = static_cast<float>(sleep);
                 float totalLapElapsed = static_cast<float>(sleep);
                 std::cout << "time started... sleep for " << std::to_string(sleep) << " ms" << std::endl;
 
                 sw.Pause();
                 sleep = 50;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 sw.Resume();
                 std::cout << "paused and sleep for " << std::to_string(sleep) << " ms then resume" << std::endl;
 
@@ -101,14 +104,14 @@ namespace timer
                 totalLapElapsed = 0;
 
                 sleep = 45;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 totalExpectedElapsed += sleep;
                 totalLapElapsed += sleep;
                 std::cout << "sleep for " << std::to_string(sleep) << " ms then paused" << std::endl;
 
                 sw.Pause();
                 sleep = 30;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 std::cout << "paused and sleep for " << std::to_string(sleep) << " ms." << std::endl;
 
 
@@ -119,7 +122,7 @@ namespace timer
             {
                 std::cout << std::endl;
 
-                StopWatch sw;
+                StopWatch sw(clock);
                 unsigned long sleep;
                 float totalLapElapsed = 0;
                 float totalElapsed = 0;
@@ -127,14 +130,14 @@ namespace timer
                 sw.Start();
 
                 sleep = 125;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 if (!sw.IsPaused()) totalLapElapsed += sleep;
                 if (!sw.IsPaused()) totalElapsed += sleep;
 
                 sw.Pause();
 
                 sleep = 60;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 if (!sw.IsPaused()) totalLapElapsed += sleep;
                 if (!sw.IsPaused()) totalElapsed += sleep;
 
@@ -143,7 +146,7 @@ namespace timer
                 totalLapElapsed = 0;
 
                 sleep = 75;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 if (!sw.IsPaused()) totalLapElapsed += sleep;
                 if (!sw.IsPaused()) totalElapsed += sleep;
 
@@ -152,14 +155,14 @@ namespace timer
                 totalLapElapsed = 0;
 
                 sleep = 40;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 if (!sw.IsPaused()) totalLapElapsed += sleep;
                 if (!sw.IsPaused()) totalElapsed += sleep;
 
                 sw.Resume();
 
                 sleep = 115;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 if (!sw.IsPaused()) totalLapElapsed += sleep;
                 if (!sw.IsPaused()) totalElapsed += sleep;
 
@@ -168,35 +171,35 @@ namespace timer
                 totalLapElapsed = 0;
 
                 sleep = 70;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 if (!sw.IsPaused()) totalLapElapsed += sleep;
                 if (!sw.IsPaused()) totalElapsed += sleep;
 
                 sw.Pause();
 
                 sleep = 25;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 if (!sw.IsPaused()) totalLapElapsed += sleep;
                 if (!sw.IsPaused()) totalElapsed += sleep;
 
                 sw.Resume();
 
                 sleep = 110;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 if (!sw.IsPaused()) totalLapElapsed += sleep;
                 if (!sw.IsPaused()) totalElapsed += sleep;
 
                 sw.Pause();
 
                 sleep = 50;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 if (!sw.IsPaused()) totalLapElapsed += sleep;
                 if (!sw.IsPaused()) totalElapsed += sleep;
 
                 sw.Resume();
 
                 sleep = 20;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 if (!sw.IsPaused()) totalLapElapsed += sleep;
                 if (!sw.IsPaused()) totalElapsed += sleep;
 
@@ -205,7 +208,7 @@ namespace timer
                 totalLapElapsed = 0;
 
                 sleep = 150;
-                SleepMS(sleep);
+                clock.Advance(std::chrono::milliseconds(sleep));
                 if (!sw.IsPaused()) totalLapElapsed += sleep;
                 if (!sw.IsPaused()) totalElapsed += sleep;
 
@@ -0,0 +1,148 @@
+#include <Command/CommandQueue.h>
+
+engine::command::CommandBuffer::~CommandBuffer()
+{
+	Clear();
+}
+
+void engine::command::CommandBuffer::Execute(Type type) const
+{
+	for (ICommand* command : m_commands[static_cast<size_t>(type)])
+	{
+		command->Execute();
+	}
+}
+
+void engine::command::CommandBuffer::Clear(Type type)
+{
+	std::vector<ICommand*>& commands = m_commands[static_cast<size_t>(type)];
+	for (ICommand* command : commands)
+	{
+		command->~ICommand();
+	}
+
+	m_count -= commands.size();
+	commands.clear();
+	++m_versions[static_cast<size_t>(type)];
+
+	// commands of this type were the only users of its arena
+	m_arenas[static_cast<size_t>(type)].Reset();
+}
+
+void engine::command::CommandBuffer::Swap(Type type, CommandBuffer& other)
+{
+	const size_t index = static_cast<size_t>(type);
+	const size_t size = m_commands[index].size();
+	const size_t otherSize = other.m_commands[index].size();
+
+	m_commands[index].swap(other.m_commands[index]);
+	m_arenas[index].Swap(other.m_arenas[index]);
+
+	m_count = m_count - size + otherSize;
+	other.m_count = other.m_count - otherSize + size;
+
+	++m_versions[index];
+	++other.m_versions[index];
+}
+
+void engine::command::CommandBuffer::Clear()
+{
+	for (size_t type = 0; type < TypeCount; ++type)
+	{
+		Clear(static_cast<Type>(type));
+	}
+}
+
+void engine::command::CommandQueue::Swap(Type type, CommandQueue& other)
+{
+	const size_t index = static_cast<size_t>(type);
+	m_entries[index].swap(other.m_entries[index]);
+	m_owned[index].swap(other.m_owned[index]);
+	m_arenas[index].Swap(other.m_arenas[index]);
+	++m_versions[index];
+	++other.m_versions[index];
+
+	// workers keep recording by index, make sure their buffers exist on both sides
+	size_t workers = m_workerBuffers.size() > other.m_workerBuffers.size() ? m_workerBuffers.size() : other.m_workerBuffers.size();
+	SetWorkerCount(workers);
+	other.SetWorkerCount(workers);
+	for (size_t worker = 0; worker < workers; ++worker)
+	{
+		m_workerBuffers[worker]->Swap(type, *other.m_workerBuffers[worker]);
+	}
+}
+
+void engine::command::CommandQueue::Dispatch(Type type, bool clear)
+{
+	PROFILE_SCOPE("CommandQueue::Dispatch");
+
+	for (const Entry& entry : m_entries[static_cast<size_t>(type)])
+	{
+		entry.execute(entry.command);
+	}
+
+	for (auto& buffer : m_workerBuffers)
+	{
+		buffer->Execute(type);
+	}
+
+	if (clear)
+	{
+		Clear(type);
+	}
+}
+
+void engine::command::CommandQueue::Clear(Type type)
+{
+	const size_t index = static_cast<size_t>(type);
+	m_entries[index].clear();
+	m_owned[index].clear();
+	++m_versions[index];
+
+	// commands of this type were the only users of its arena
+	m_arenas[index].Reset();
+
+	for (auto& buffer : m_workerBuffers)
+	{
+		buffer->Clear(type);
+	}
+}
+
+void engine::command::CommandQueue::Clear()
+{
+	for (size_t type = 0; type < TypeCount; ++type)
+	{
+		Clear(static_cast<Type>(type));
+	}
+}
+
+bool engine::command::CommandQueue::IsEmpty() const
+{
+	for (const std::vector<Entry>& entries : m_entries)
+	{
+		if (!entries.empty())
+		{
+			return false;
+		}
+	}
+
+	for (const auto& buffer : m_workerBuffers)
+	{
+		if (!buffer->IsEmpty())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+uint64_t engine::command::CommandQueue::GetVersion(Type type) const
+{
+	// every part only moves forward, so the sum does too
+	uint64_t version = m_versions[static_cast<size_t>(type)];
+	for (const auto& buffer : m_workerBuffers)
+	{
+		version += buffer->GetVersion(type);
+	}
+	return version;
+}
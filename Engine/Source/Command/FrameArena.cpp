@@ -0,0 +1,38 @@
+#include <Command/FrameArena.h>
+#include <algorithm>
+
+void* engine::command::FrameArena::Allocate(size_t size, size_t alignment)
+{
+	while (true)
+	{
+		if (m_block < m_blocks.size())
+		{
+			Block& block = m_blocks[m_block];
+			size_t offset = (m_offset + alignment - 1) & ~(alignment - 1);
+			if (offset + size <= block.size)
+			{
+				m_offset = offset + size;
+				return block.memory.get() + offset;
+			}
+
+			// does not fit, continue in next block
+			++m_block;
+			m_offset = 0;
+			continue;
+		}
+
+		// allocations bigger than a block get a block of their own size
+		size_t blockSize = std::max(BlockSize, size + alignment);
+		m_blocks.push_back({ std::make_unique<std::byte[]>(blockSize), blockSize });
+	}
+}
+
+size_t engine::command::FrameArena::GetCapacity() const
+{
+	size_t capacity = 0;
+	for (const Block& block : m_blocks)
+	{
+		capacity += block.size;
+	}
+	return capacity;
+}
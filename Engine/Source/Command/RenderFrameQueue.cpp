@@ -0,0 +1,101 @@
+#include <Command/RenderFrameQueue.h>
+#include <Performance/Profiler.h>
+#include <chrono>
+
+engine::command::RenderFrameQueue::RenderFrameQueue(size_t count) :
+	m_count(count < 2 ? 2 : (count > MaxCount ? MaxCount : count))
+{
+}
+
+engine::command::RenderFrameQueue::Frame* engine::command::RenderFrameQueue::BeginSubmit()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (m_inFlight == m_count && !m_stopped)
+	{
+		PROFILE_SCOPE("RenderFrameQueue::Stall");
+
+		// render thread is behind. hold simulation back instead of dropping or overwriting a frame
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		m_frameFree.wait(lock, [this]() { return m_inFlight < m_count || m_stopped; });
+		float stall = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+		++m_statistics.stalls;
+		m_statistics.stallTime += stall;
+		if (stall > m_statistics.maxStallTime)
+		{
+			m_statistics.maxStallTime = stall;
+		}
+	}
+
+	if (m_stopped)
+	{
+		return nullptr;
+	}
+
+	m_filling = true;
+	return &m_frames[m_submitIndex];
+}
+
+void engine::command::RenderFrameQueue::EndSubmit(float delta, float alpha)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_filling)
+		{
+			return;
+		}
+
+		Frame& frame = m_frames[m_submitIndex];
+		frame.delta = delta;
+		frame.alpha = alpha;
+		frame.number = ++m_number;
+
+		m_submitIndex = (m_submitIndex + 1) % m_count;
+		++m_inFlight;
+		++m_statistics.submitted;
+		m_filling = false;
+	}
+	m_frameReady.notify_one();
+}
+
+engine::command::RenderFrameQueue::Frame* engine::command::RenderFrameQueue::Acquire()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_frameReady.wait(lock, [this]() { return m_inFlight > 0 || m_stopped; });
+
+	if (m_stopped)
+	{
+		return nullptr;
+	}
+
+	m_rendering = true;
+	return &m_frames[m_renderIndex];
+}
+
+void engine::command::RenderFrameQueue::Release()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!m_rendering)
+		{
+			return;
+		}
+
+		m_renderIndex = (m_renderIndex + 1) % m_count;
+		--m_inFlight;
+		++m_statistics.rendered;
+		m_rendering = false;
+	}
+	m_frameFree.notify_one();
+}
+
+void engine::command::RenderFrameQueue::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopped = true;
+	}
+	m_frameFree.notify_all();
+	m_frameReady.notify_all();
+}
@@ -0,0 +1,503 @@
+#include <Command/RenderList.h>
+#include <Performance/Profiler.h>
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+	// run ids are never reused, not even across lists. a renderer keying buffers by id can not mistake a new run
+	// for one that went away
+	uint64_t NextRunId()
+	{
+		static std::atomic<uint64_t> next{ 0 };
+		return ++next;
+	}
+
+	bool IsSameColor(const graphics::ColorF& a, const graphics::ColorF& b)
+	{
+		return a.red == b.red && a.green == b.green && a.blue == b.blue && a.alpha == b.alpha;
+	}
+}
+
+engine::command::RenderList::Item* engine::command::RenderList::Find(const Handle handle)
+{
+	if (handle.index >= m_items.size())
+	{
+		return nullptr;
+	}
+
+	Item& item = m_items[handle.index];
+	return item.alive && item.generation == handle.generation ? &item : nullptr;
+}
+
+const engine::command::RenderList::Item* engine::command::RenderList::Find(const Handle handle) const
+{
+	if (handle.index >= m_items.size())
+	{
+		return nullptr;
+	}
+
+	const Item& item = m_items[handle.index];
+	return item.alive && item.generation == handle.generation ? &item : nullptr;
+}
+
+uint32_t engine::command::RenderList::GetRun(const graphics::renderable::IRenderable& renderable, const graphics::ColorF color, const uint8_t layer)
+{
+	// runs are few (one per layer, texture and color), a scan is cheaper than hashing a color
+	const void* bindKey = renderable.GetBindKey();
+	for (uint32_t i = 0; i < m_runs.size(); ++i)
+	{
+		const Run& run = m_runs[i];
+		if (run.alive && run.layer == layer && run.bindKey == bindKey && IsSameColor(run.color, color))
+		{
+			return i;
+		}
+	}
+
+	uint32_t index;
+	if (!m_freeRuns.empty())
+	{
+		index = m_freeRuns.back();
+		m_freeRuns.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(m_runs.size());
+		m_runs.emplace_back();
+	}
+
+	// a reused slot keeps its vectors' memory, the id is new so renderers do not draw the old run's data
+	Run& run = m_runs[index];
+	run.id = NextRunId();
+	run.version = 0;
+	run.renderable = &renderable;
+	run.bindKey = bindKey;
+	run.color = color;
+	run.layer = layer;
+	run.alive = true;
+
+	m_order.push_back(index);
+	m_orderDirty = true;
+
+	return index;
+}
+
+void engine::command::RenderList::Attach(uint32_t index)
+{
+	Item& item = m_items[index];
+	item.run = GetRun(*item.renderable, item.color, item.layer);
+	m_runs[item.run].items.push_back(index);
+	MarkDirty(item.run);
+}
+
+void engine::command::RenderList::Detach(uint32_t index)
+{
+	Item& item = m_items[index];
+	std::vector<uint32_t>& items = m_runs[item.run].items;
+	items.erase(std::find(items.begin(), items.end(), index));
+	if (items.empty())
+	{
+		FreeRun(item.run);
+		return;
+	}
+	MarkDirty(item.run);
+}
+
+void engine::command::RenderList::FreeRun(uint32_t index)
+{
+	Run& run = m_runs[index];
+	m_released.push_back(run.id);
+
+	run.alive = false;
+	run.dirty = false;
+	run.renderable = nullptr;
+	run.instances.clear();
+
+	// order stays sorted without the run
+	m_order.erase(std::find(m_order.begin(), m_order.end(), index));
+	m_freeRuns.push_back(index);
+}
+
+void engine::command::RenderList::MarkDirty(uint32_t run)
+{
+	m_runs[run].dirty = true;
+	m_dirty = true;
+}
+
+engine::command::RenderList::Handle engine::command::RenderList::Add(
+	const graphics::renderable::IRenderable& renderable,
+	const spatial::PositionF pos,
+	const graphics::ColorF color,
+	const uint8_t layer
+)
+{
+	uint32_t index;
+	if (!m_freeItems.empty())
+	{
+		index = m_freeItems.back();
+		m_freeItems.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(m_items.size());
+		m_items.emplace_back();
+	}
+
+	Item& item = m_items[index];
+	item.renderable = &renderable;
+	item.pos = pos;
+	item.color = color;
+	item.layer = layer;
+	item.visible = true;
+	item.alive = true;
+	++m_count;
+
+	return { index, item.generation };
+}
+
+engine::command::RenderList::Handle engine::command::RenderList::AddSprite(
+	const graphics::renderable::IRenderable& renderable,
+	const spatial::PositionF pos,
+	const spatial::SizeF size,
+	const graphics::ColorF color,
+	const uint8_t layer
+)
+{
+	Handle handle = Add(renderable, pos, color, layer);
+	LayoutSprite(renderable, size, m_items[handle.index].instances);
+	Attach(handle.index);
+	return handle;
+}
+
+engine::command::RenderList::Handle engine::command::RenderList::AddText(
+	const graphics::renderable::IFontAtlas& font,
+	const std::string& text,
+	const spatial::PositionF pos,
+	const graphics::ColorF color,
+	const uint8_t layer
+)
+{
+	Handle handle = Add(font, pos, color, layer);
+	LayoutText(font, text, m_items[handle.index].instances);
+	Attach(handle.index);
+	return handle;
+}
+
+bool engine::command::RenderList::SetPosition(const Handle handle, const spatial::PositionF pos)
+{
+	Item* item = Find(handle);
+	if (!item)
+	{
+		return false;
+	}
+
+	if (item->pos.x != pos.x || item->pos.y != pos.y)
+	{
+		item->pos = pos;
+		if (item->visible)
+		{
+			MarkDirty(item->run);
+		}
+	}
+	return true;
+}
+
+bool engine::command::RenderList::SetColor(const Handle handle, const graphics::ColorF color)
+{
+	Item* item = Find(handle);
+	if (!item)
+	{
+		return false;
+	}
+
+	// color is per run, item moves to the run of its new color
+	if (!IsSameColor(item->color, color))
+	{
+		Detach(handle.index);
+		item->color = color;
+		Attach(handle.index);
+	}
+	return true;
+}
+
+bool engine::command::RenderList::SetLayer(const Handle handle, const uint8_t layer)
+{
+	Item* item = Find(handle);
+	if (!item)
+	{
+		return false;
+	}
+
+	if (item->layer != layer)
+	{
+		Detach(handle.index);
+		item->layer = layer;
+		Attach(handle.index);
+	}
+	return true;
+}
+
+bool engine::command::RenderList::SetVisible(const Handle handle, const bool visible)
+{
+	Item* item = Find(handle);
+	if (!item)
+	{
+		return false;
+	}
+
+	// hidden items stay in their run, they are skipped when it is built
+	if (item->visible != visible)
+	{
+		item->visible = visible;
+		MarkDirty(item->run);
+	}
+	return true;
+}
+
+void engine::command::RenderList::SetInstances(Item& item, uint32_t index, const graphics::renderable::IRenderable& renderable)
+{
+	if (item.renderable->GetBindKey() != renderable.GetBindKey())
+	{
+		Detach(index);
+		item.renderable = &renderable;
+		Attach(index);
+		return;
+	}
+
+	item.renderable = &renderable;
+	MarkDirty(item.run);
+}
+
+bool engine::command::RenderList::SetSprite(const Handle handle, const graphics::renderable::IRenderable& renderable, const spatial::SizeF size)
+{
+	Item* item = Find(handle);
+	if (!item)
+	{
+		return false;
+	}
+
+	LayoutSprite(renderable, size, item->instances);
+	SetInstances(*item, handle.index, renderable);
+	return true;
+}
+
+bool engine::command::RenderList::SetText(const Handle handle, const graphics::renderable::IFontAtlas& font, const std::string& text)
+{
+	Item* item = Find(handle);
+	if (!item)
+	{
+		return false;
+	}
+
+	LayoutText(font, text, item->instances);
+	SetInstances(*item, handle.index, font);
+	return true;
+}
+
+bool engine::command::RenderList::Remove(const Handle handle)
+{
+	Item* item = Find(handle);
+	if (!item)
+	{
+		return false;
+	}
+
+	Detach(handle.index);
+
+	// keep instance memory for the next item in this slot
+	item->instances.clear();
+	item->renderable = nullptr;
+	item->alive = false;
+	++item->generation;
+	m_freeItems.push_back(handle.index);
+	--m_count;
+	return true;
+}
+
+void engine::command::RenderList::LayoutSprite(const graphics::renderable::IRenderable& renderable, const spatial::SizeF size, std::vector<graphics::renderer::SpriteInstance>& instances)
+{
+	instances.clear();
+	instances.push_back({ 0.0f, 0.0f, size.width, size.height, renderable.GetUVRect() });
+}
+
+void engine::command::RenderList::LayoutText(const graphics::renderable::IFontAtlas& font, const std::string& text, std::vector<graphics::renderer::SpriteInstance>& instances)
+{
+	instances.clear();
+
+	// not through the font's layout cache. with render thread, renderers use that cache while the list is changed
+	// on main thread. same layout as the cache: glyphs side by side, characters without a glyph are skipped
+	const spatial::SizeF atlas = font.GetSize();
+
+	float x = 0.0f;
+	for (unsigned char c : text)
+	{
+		if (c < 32 || c > 127)
+		{
+			continue;
+		}
+
+		math::geometry::RectF uv{};
+		if (!font.GetNormalizedTexCoord(c, uv.left, uv.top, uv.right, uv.bottom))
+		{
+			continue;
+		}
+
+		const float width = atlas.width * (uv.right - uv.left);
+		instances.push_back({ x, 0.0f, width, atlas.height * (uv.bottom - uv.top), uv });
+		x += width;
+	}
+}
+
+void engine::command::RenderList::Build()
+{
+	if (m_orderDirty)
+	{
+		// stable, so runs of a layer keep creation order
+		std::stable_sort(m_order.begin(), m_order.end(), [this](uint32_t a, uint32_t b)
+			{
+				return m_runs[a].layer < m_runs[b].layer;
+			});
+		m_orderDirty = false;
+	}
+
+	if (!m_dirty)
+	{
+		return;
+	}
+
+	PROFILE_SCOPE("RenderList::Build");
+
+	for (Run& run : m_runs)
+	{
+		if (!run.dirty)
+		{
+			continue;
+		}
+
+		run.instances.clear();
+		run.renderable = nullptr;
+		for (uint32_t index : run.items)
+		{
+			const Item& item = m_items[index];
+			if (!item.visible)
+			{
+				continue;
+			}
+
+			// any item of the run binds the same texture
+			run.renderable = item.renderable;
+			for (const graphics::renderer::SpriteInstance& instance : item.instances)
+			{
+				graphics::renderer::SpriteInstance placed = instance;
+				placed.x += item.pos.x;
+				placed.y += item.pos.y;
+				run.instances.push_back(placed);
+			}
+		}
+
+		++run.version;
+		run.dirty = false;
+	}
+
+	m_dirty = false;
+}
+
+void engine::command::RenderList::Draw(graphics::renderer::IRenderer& renderer)
+{
+	PROFILE_SCOPE("RenderList::Draw");
+
+	for (uint64_t id : m_released)
+	{
+		renderer.ReleaseRetained(id);
+	}
+	m_released.clear();
+
+	Build();
+
+	for (uint32_t index : m_order)
+	{
+		const Run& run = m_runs[index];
+		if (run.instances.empty() || !run.renderable)
+		{
+			continue;
+		}
+
+		renderer.DrawRetained(*run.renderable, run.instances.data(), run.instances.size(), {}, run.color, run.id, run.version);
+	}
+}
+
+void engine::command::RenderList::CopyTo(RenderList& target)
+{
+	PROFILE_SCOPE("RenderList::CopyTo");
+
+	Build();
+
+	target.m_items.clear();
+	target.m_freeItems.clear();
+	target.m_freeRuns.clear();
+	target.m_count = 0;
+	target.m_dirty = false;
+	target.m_orderDirty = false;
+
+	// target releases them when it is drawn. it may not have been drawn since the last copy, so they add up
+	target.m_released.insert(target.m_released.end(), m_released.begin(), m_released.end());
+	m_released.clear();
+
+	// target's runs are kept in draw order, so a run usually sits where it sat in the previous copy
+	target.m_runs.resize(m_order.size());
+	target.m_order.resize(m_order.size());
+	for (uint32_t i = 0; i < m_order.size(); ++i)
+	{
+		const Run& source = m_runs[m_order[i]];
+		Run& run = target.m_runs[i];
+		target.m_order[i] = i;
+
+		if (run.id == source.id && run.version == source.version)
+		{
+			continue;
+		}
+
+		run.id = source.id;
+		run.version = source.version;
+		run.renderable = source.renderable;
+		run.bindKey = source.bindKey;
+		run.color = source.color;
+		run.layer = source.layer;
+		run.alive = true;
+		run.dirty = false;
+		run.items.clear();
+		run.instances.assign(source.instances.begin(), source.instances.end());
+	}
+}
+
+void engine::command::RenderList::Clear()
+{
+	// slots are kept and their generation moves on, so handles from before Clear stay invalid
+	m_freeItems.clear();
+	for (uint32_t i = 0; i < m_items.size(); ++i)
+	{
+		Item& item = m_items[i];
+		if (item.alive)
+		{
+			item.instances.clear();
+			item.renderable = nullptr;
+			item.alive = false;
+			++item.generation;
+		}
+		m_freeItems.push_back(i);
+	}
+	m_count = 0;
+
+	for (const Run& run : m_runs)
+	{
+		if (run.alive)
+		{
+			m_released.push_back(run.id);
+		}
+	}
+	m_runs.clear();
+	m_freeRuns.clear();
+	m_order.clear();
+	m_orderDirty = false;
+	m_dirty = false;
+}
@@ -0,0 +1,250 @@
+#include <Command/RenderQueue.h>
+#include <Utilities/Logger.h>
+#include <Performance/Profiler.h>
+#include <cstring>
+
+uint64_t engine::command::RenderQueue::MakeKey(uint8_t layer, uint32_t bindId, float depth)
+{
+	// flip float bits so unsigned compare gives same order as float compare.
+	// positive: set sign bit. negative: invert all bits
+	uint32_t bits;
+	std::memcpy(&bits, &depth, sizeof(bits));
+	bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+
+	return (static_cast<uint64_t>(layer) << 56) | (static_cast<uint64_t>(bindId & MaxBindId) << 32) | bits;
+}
+
+uint32_t engine::command::RenderQueue::GetBindId(const ::graphics::renderable::IRenderable& renderable)
+{
+	// consecutive draws from the same texture are the common case, skip the lookup for them
+	const void* bindKey = renderable.GetBindKey();
+	if (bindKey == m_lastBindKey && m_lastBindId != 0)
+	{
+		return m_lastBindId;
+	}
+
+	auto it = m_bindIds.find(bindKey);
+	if (it == m_bindIds.end())
+	{
+		// ran out of ids. draws will still be correct but textures past this point are grouped together
+		uint32_t id = static_cast<uint32_t>(m_bindIds.size() + 1);
+		if (id > MaxBindId)
+		{
+			LOGERROR("RenderQueue ran out of bind ids. Texture grouping is disabled for new textures.");
+			id = MaxBindId;
+		}
+		it = m_bindIds.emplace(bindKey, id).first;
+	}
+
+	m_lastBindKey = bindKey;
+	m_lastBindId = it->second;
+	return m_lastBindId;
+}
+
+void engine::command::RenderQueue::Push(const Packet& packet)
+{
+	m_packets.push_back(packet);
+	m_dirty = true;
+}
+
+void engine::command::RenderQueue::SubmitQuad(
+	const spatial::PositionF pos,
+	const spatial::SizeF size,
+	const ::graphics::ColorF color,
+	const float rotation,
+	const uint8_t layer,
+	const float depth
+)
+{
+	Push({ MakeKey(layer, 0, depth), nullptr, pos.x, pos.y, size.width, size.height, color, rotation, 0, 0, PacketType::Quad });
+}
+
+void engine::command::RenderQueue::SubmitRenderable(
+	const ::graphics::renderable::IRenderable& renderable,
+	const spatial::PositionF pos,
+	const spatial::SizeF size,
+	const ::graphics::ColorF color,
+	const float rotation,
+	const uint8_t layer,
+	const float depth
+)
+{
+	Push({ MakeKey(layer, GetBindId(renderable), depth), &renderable, pos.x, pos.y, size.width, size.height, color, rotation, 0, 0, PacketType::Renderable });
+}
+
+void engine::command::RenderQueue::SubmitText(
+	const ::graphics::renderable::IFontAtlas& font,
+	const std::string& text,
+	const spatial::PositionF pos,
+	const ::graphics::ColorF color,
+	const uint8_t layer,
+	const float depth
+)
+{
+	uint32_t offset = static_cast<uint32_t>(m_text.size());
+	m_text.insert(m_text.end(), text.begin(), text.end());
+
+	Push({ MakeKey(layer, GetBindId(font), depth), &font, pos.x, pos.y, 0, 0, color, 0, offset, static_cast<uint32_t>(text.size()), PacketType::Text });
+}
+
+void engine::command::RenderQueue::SubmitChar(
+	const ::graphics::renderable::IFontAtlas& font,
+	const unsigned char character,
+	const spatial::PositionF pos,
+	const ::graphics::ColorF color,
+	const float rotation,
+	const uint8_t layer,
+	const float depth
+)
+{
+	Push({ MakeKey(layer, GetBindId(font), depth), &font, pos.x, pos.y, 0, 0, color, rotation, character, 0, PacketType::Char });
+}
+
+size_t engine::command::RenderQueue::SubmitVisible(const WorldIndex& world, const spatial::CameraF& camera)
+{
+	size_t count = 0;
+	world.Query(camera.GetVisibleRect(), [this, &world, &camera, &count](WorldIndex::Handle handle, const WorldRenderable& object)
+		{
+			const math::geometry::RectF& bounds = world.GetBounds(handle);
+			SubmitRenderable(
+				*object.renderable,
+				camera.WorldToScreen({ bounds.left, bounds.top }),
+				{ bounds.GetWidth(), bounds.GetHeight() },
+				object.color,
+				object.rotation,
+				object.layer,
+				object.depth
+			);
+			++count;
+		});
+	return count;
+}
+
+void engine::command::RenderQueue::Sort()
+{
+	const size_t count = m_packets.size();
+	m_sorted.resize(count);
+	m_scratch.resize(count);
+
+	// histogram for all 8 byte positions in one pass
+	size_t histogram[8][256] = {};
+	for (size_t i = 0; i < count; ++i)
+	{
+		uint64_t key = m_packets[i].key;
+		m_sorted[i] = { key, static_cast<uint32_t>(i) };
+		for (int pass = 0; pass < 8; ++pass)
+		{
+			++histogram[pass][(key >> (pass * 8)) & 0xff];
+		}
+	}
+
+	SortEntry* src = m_sorted.data();
+	SortEntry* dst = m_scratch.data();
+
+	for (int pass = 0; pass < 8; ++pass)
+	{
+		size_t* counts = histogram[pass];
+
+		// all keys have the same byte here, nothing to do
+		if (count == 0 || counts[(src[0].key >> (pass * 8)) & 0xff] == count)
+		{
+			continue;
+		}
+
+		// prefix sum into bucket offsets
+		size_t offset = 0;
+		for (size_t b = 0; b < 256; ++b)
+		{
+			size_t c = counts[b];
+			counts[b] = offset;
+			offset += c;
+		}
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			dst[counts[(src[i].key >> (pass * 8)) & 0xff]++] = src[i];
+		}
+
+		std::swap(src, dst);
+	}
+
+	// result must end up in m_sorted
+	if (src != m_sorted.data())
+	{
+		m_sorted.swap(m_scratch);
+	}
+
+	m_dirty = false;
+}
+
+void engine::command::RenderQueue::Dispatch(::graphics::renderer::IRenderer& renderer)
+{
+	PROFILE_SCOPE("RenderQueue::Dispatch");
+
+	if (m_dirty)
+	{
+		Sort();
+	}
+
+	for (const SortEntry& entry : m_sorted)
+	{
+		const Packet& packet = m_packets[entry.index];
+		switch (packet.type)
+		{
+		case PacketType::Quad:
+			renderer.Draw({ packet.x, packet.y }, { packet.width, packet.height }, packet.color, packet.rotation);
+			break;
+
+		case PacketType::Renderable:
+			renderer.DrawRenderable(*packet.renderable, { packet.x, packet.y }, { packet.width, packet.height }, packet.color, packet.rotation);
+			break;
+
+		case PacketType::Text:
+			renderer.DrawText(
+				static_cast<const ::graphics::renderable::IFontAtlas&>(*packet.renderable),
+				std::string_view(m_text.data() + packet.textOffset, packet.textLength),
+				{ packet.x, packet.y },
+				packet.color
+			);
+			break;
+
+		case PacketType::Char:
+			renderer.DrawChar(
+				static_cast<const ::graphics::renderable::IFontAtlas&>(*packet.renderable),
+				static_cast<unsigned char>(packet.textOffset),
+				{ packet.x, packet.y },
+				packet.color,
+				packet.rotation
+			);
+			break;
+		}
+	}
+}
+
+void engine::command::RenderQueue::Clear()
+{
+	m_packets.clear();
+	m_text.clear();
+	m_sorted.clear();
+	m_dirty = false;
+}
+
+void engine::command::RenderQueue::CopyTo(RenderQueue& target) const
+{
+	PROFILE_SCOPE("RenderQueue::CopyTo");
+
+	target.m_packets.assign(m_packets.begin(), m_packets.end());
+	target.m_text.assign(m_text.begin(), m_text.end());
+
+	// sort result is only worth copying when it is current. otherwise target sorts on its own thread
+	if (m_dirty)
+	{
+		target.m_sorted.clear();
+		target.m_dirty = !m_packets.empty();
+	}
+	else
+	{
+		target.m_sorted.assign(m_sorted.begin(), m_sorted.end());
+		target.m_dirty = false;
+	}
+}
@@ -1,6 +1,7 @@
 #include <Engine/Engine.h>
 #include <Engine/Factory/CanvasFactory.h>
 #include <Engine/Factory/RendererFactory.h>
+#include <Graphics/Renderer/Renderer.h>
 #include <Cache/Registry.h>
 #include <Cache/Dictionary.h>
 #include <Utilities/Logger.h>
@@ -14,7 +15,8 @@ engine::Engine::Engine(
 	std::string API,
 	std::string RenderMode
 ):
-	m_renderController(600.0f)
+	m_world({ 0.0f, 0.0f, 8192.0f, 8192.0f }, 256.0f),
+	m_renderController(60.0f)
 {
 	// let's setup environment config first before we do anything else
 	cache::Registry<cache::Dictionary<>>::Instance().Register("EnvironmentConfig", std::make_unique<cache::Dictionary<>>());
@@ -41,10 +43,14 @@ engine::Engine::Engine(
 
 	// this event will fire up on every windows message loop (main loop)
 	Win32::Window::OnIdle += event::Handler(this, &Engine::Idle);
+
+	// scheduled jobs run on engine's worker threads
+	m_scheduler.SetJobSystem(&m_jobSystem);
 }
 
 engine::Engine::~Engine()
 {
+	StopRenderThread();
 }
 
 void engine::Engine::Run()
@@ -53,6 +59,68 @@ void engine::Engine::Run()
 	Win32::Window::Run();
 }
 
+void engine::Engine::SetClock(const timer::IClock& clock)
+{
+	// sleeping does not move a virtual clock. pacing mode is put back once a real clock takes over again
+	const bool wasVirtual = m_stopwatch.GetClock().IsVirtual();
+	m_stopwatch.SetClock(clock);
+	if (clock.IsVirtual() && !wasVirtual)
+	{
+		m_pacingMode = m_framePacer.GetMode();
+		m_framePacer.SetMode(timer::FramePacer::Mode::Spin);
+	}
+	else if (!clock.IsVirtual() && wasVirtual)
+	{
+		m_framePacer.SetMode(m_pacingMode);
+	}
+
+	// readings of the previous clock mean nothing to the new one
+	if (m_stopwatch.IsRunning())
+	{
+		m_stopwatch.Start();
+	}
+}
+
+void engine::Engine::CaptureProfile(size_t lapCount)
+{
+#if PROFILER_ENABLED
+	if (m_profileFile.empty())
+	{
+		LOGERROR("Profile capture is not enabled. Set ProfileCapture in environment config before window is created.");
+		return;
+	}
+	if (lapCount == 0 || m_profileLapsLeft > 0)
+	{
+		return;
+	}
+
+	m_profileLapsLeft = lapCount;
+	performance::Profiler::Instance().BeginCapture();
+#else
+	LOGERROR("Profiler is compiled out. Build with ENABLE_PROFILER to capture profiles.");
+#endif
+}
+
+void engine::Engine::CaptureDrawStream(size_t frameCount)
+{
+	// render thread may be drawing into the stream
+	std::lock_guard<std::mutex> lock(m_renderContextMutex);
+
+	if (!m_drawStreamRecorder)
+	{
+		LOGERROR("Draw stream capture is not enabled. Set DrawStreamCapture in environment config before window is created.");
+		return;
+	}
+	if (frameCount == 0 || m_drawStreamFramesLeft > 0)
+	{
+		return;
+	}
+
+	m_drawStream->Clear();
+	m_drawStreamFramesLeft = frameCount;
+	m_drawStreamRecorder->SetRecording(true);
+}
+
 void engine::Engine::Initialize()
 {
 	// get environment config from cache
@@ -114,10 +182,137 @@ void engine::Engine::WindowCreate(void* hWnd)
 	}
 	LOG("[ENGINE] Using sprite renderer mode: " << environmentConfig.Get("RenderMode"));
 
+	// render frames per second. "RenderRate" in environment config, default 60. the pacer sleeps until the next
+	// render frame or scheduled pulse, so this is what keeps the main loop from drawing more frames than are shown
+	std::string renderRate;
+	float rate = environmentConfig.TryGetValue("RenderRate", renderRate) ? std::stof(renderRate) : 60.0f;
+	if (rate <= 0.0f)
+	{
+		LOGERROR("[ENGINE] Invalid render rate " << renderRate << ", using 60.");
+		rate = 60.0f;
+	}
+	m_renderController.SetTargetFrameRate(rate);
+	LOG("[ENGINE] Render rate: " << rate << " Hz");
+
+	// frame pacing. "Spin" disables waiting between frames (old behaviour, useful when profiling)
+	std::string framePacing;
+	if (environmentConfig.TryGetValue("FramePacing", framePacing) && framePacing == "Spin")
+	{
+		m_framePacer.SetMode(timer::FramePacer::Mode::Spin);
+	}
+
+	// main loop clock
+	std::string clock;
+	if (environmentConfig.TryGetValue("Clock", clock))
+	{
+		if (clock == "Tsc")
+		{
+			m_clock = std::make_unique<timer::TscClock>();
+			SetClock(*m_clock);
+		}
+		else if (clock == "Virtual")
+		{
+			std::string step;
+			if (environmentConfig.TryGetValue("VirtualTimeStep", step))
+			{
+				m_virtualTimeStep = std::stof(step);
+			}
+
+			auto virtualClock = std::make_unique<timer::VirtualClock>();
+			m_virtualClock = virtualClock.get();
+			m_clock = std::move(virtualClock);
+			SetClock(*m_clock);
+		}
+		else if (clock != "Steady")
+		{
+			LOGERROR("[ENGINE] Unknown clock " << clock << ", using Steady.");
+		}
+	}
+	LOG("[ENGINE] Clock: " << (m_virtualClock ? "Virtual" : (m_clock ? "Tsc" : "Steady")));
+	LOG("[ENGINE] Frame pacing: " << (m_framePacer.GetMode() == timer::FramePacer::Mode::Spin ? "Spin" : "Hybrid"));
+
+	// frames longer than "FrameBudget" seconds (default 1/60) are counted as over budget
+	std::string frameBudget;
+	float budget = environmentConfig.TryGetValue("FrameBudget", frameBudget) ? std::stof(frameBudget) : 1.0f / 60.0f;
+	m_mainLoopMonitor.SetFrameBudget(budget);
+	m_renderMonitorMonitor.SetFrameBudget(budget);
+
+	// profile capture output. capture itself is started by CaptureProfile
+	if (environmentConfig.TryGetValue("ProfileCapture", m_profileFile))
+	{
+		performance::Profiler::Instance().SetThreadName("main");
+		LOG("[ENGINE] Profile capture enabled. Output file: " << m_profileFile);
+	}
+
+	// worker threads. started here so the main thread is the window thread
+	std::string workerThreads;
+	m_jobSystem.Start(environmentConfig.TryGetValue("WorkerThreads", workerThreads) ? std::stoi(workerThreads) : -1);
+	LOG("[ENGINE] Worker threads: " << m_jobSystem.GetWorkerCount());
+
+	// one command buffer per thread that runs jobs, main thread included, since Wait runs jobs on it.
+	// jobs record into CommandQueue().GetWorkerBuffer(Jobs().GetCurrentWorker())
+	m_commandQueue.SetWorkerCount(m_jobSystem.GetWorkerCount() + 1);
+
+	// fixed timestep simulation. scheduled updates run at "SimulationRate" Hz, rendering stays at its own rate
+	std::string simulationRate;
+	if (environmentConfig.TryGetValue("SimulationRate", simulationRate))
+	{
+		m_simulation.SetRate(std::stof(simulationRate));
+
+		std::string maxSteps;
+		if (environmentConfig.TryGetValue("MaxSimulationSteps", maxSteps))
+		{
+			m_simulation.SetMaxStepsPerUpdate(std::stoul(maxSteps));
+		}
+
+		m_simulation.StepEvent += event::Handler(this, &Engine::Step);
+		m_fixedTimestep = true;
+		LOG("[ENGINE] Fixed timestep: " << m_simulation.GetRate() << " Hz, max " << m_simulation.GetMaxStepsPerUpdate() << " steps per lap");
+	}
+
+	// wrap renderer with a recorder if draw stream capture is requested. recorder stays idle until CaptureDrawStream is called
+	if (environmentConfig.TryGetValue("DrawStreamCapture", m_drawStreamFile))
+	{
+		m_drawStream = std::make_unique<graphics::renderer::DrawStream>();
+		auto recorder = std::make_unique<graphics::renderer::DrawStreamRecorderImpl>(*m_drawStream, std::move(m_renderer));
+		recorder->SetRecording(false);
+		m_drawStreamRecorder = recorder.get();
+		m_renderer = std::make_unique<graphics::renderer::Renderer>(std::move(recorder));
+		LOG("[ENGINE] Draw stream capture enabled. Output file: " << m_drawStreamFile);
+	}
+
+	// render thread. "Double" lets simulation run one frame ahead of rendering, "Triple" two. started after StartEvent
+	std::string renderThread;
+	if (environmentConfig.TryGetValue("RenderThread", renderThread))
+	{
+		if (renderThread == "Double" || renderThread == "Triple")
+		{
+			m_renderFrames = std::make_unique<command::RenderFrameQueue>(renderThread == "Triple" ? 3 : 2);
+		}
+		else if (renderThread != "Off")
+		{
+			LOGERROR("[ENGINE] Unknown render thread mode " << renderThread << ", rendering on main thread.");
+		}
+	}
+	LOG("[ENGINE] Render thread: " << (m_renderFrames ? renderThread : "Off"));
+
+	// input is posted to event bus too. mouse moves within a lap collapse to the last position
+	m_eventBus.Channel<input::MouseMoveEvent>().SetCoalesceAll();
+	input::Input::Instance().SetEventBus(&m_eventBus);
+
 	// emit event that we are ready to start
 	StartEvent();
 	LOG("[ENGINE] Start event happened...");
 
+	// render thread owns the device context from here on. start event handlers could still use it freely
+	if (m_renderFrames)
+	{
+		m_canvas->SetViewPort();
+		m_viewPort = m_canvas->GetViewPort();
+		m_renderThread = std::thread(&Engine::RenderThread, this);
+		LOG("[ENGINE] Render thread started...");
+	}
+
 	// setup stopwatch to manage timing
 	m_stopwatch.OnLap += event::Handler(this, &Engine::Lap);
 	m_stopwatch.Start();
@@ -131,11 +326,27 @@ void engine::Engine::WindowCreate(void* hWnd)
 
 void engine::Engine::Lap(float delta)
 {
+	PROFILE_SCOPE("Engine::Lap");
+
 	m_mainLoopMonitor.OnFrameCompleted(delta);
 
 	input::Input::Instance().Update();
 
-	m_scheduler.Update(delta);
+	// deliver deferred events posted since last lap, input included
+	m_eventBus.Dispatch();
+
+	if (m_fixedTimestep)
+	{
+		// scheduler is stepped by simulation. leftover time becomes the interpolation alpha for rendering
+		m_simulation.Update(delta);
+	}
+	else
+	{
+		m_scheduler.Update(delta);
+	}
+
+	// apply results of background jobs that finished since last lap
+	m_jobSystem.RunContinuations();
 
 	// accumulator += delta
 	// if accumulator > target - render, accumulator = 0;
@@ -156,16 +367,75 @@ void engine::Engine::Lap(float delta)
 
 }
 
+void engine::Engine::Step(float step)
+{
+	m_scheduler.Update(step);
+}
+
 void engine::Engine::DebugShowStatistics(float delta)
 {
+	std::lock_guard<std::mutex> lock(m_renderStateMutex);
+
 	LOG("[ENGINE] MAIN LOOP FPS: " << std::setprecision(15) << m_mainLoopMonitor.GetAverageFrameRate());
 	LOG("[ENGINE] RENDER FPS: " << std::setprecision(15) << m_renderMonitorMonitor.GetAverageFrameRate());
+	performance::FrameTimeStatistics frameTimes = m_renderMonitorMonitor.GetFrameTimeStatistics();
+	LOG("[ENGINE] RENDER FRAME TIME (ms): p50 " << frameTimes.p50 * 1000.0f << ", p90 " << frameTimes.p90 * 1000.0f << ", p99 " << frameTimes.p99 * 1000.0f
+		<< ", max " << frameTimes.max * 1000.0f << ", over budget " << frameTimes.overBudget << "/" << frameTimes.frames);
+	LOG("[ENGINE] RENDER: " << m_renderStatistics.instances << " instances, " << m_renderStatistics.drawCalls << " draw calls (texture "
+		<< m_renderStatistics.textureFlushes << ", end " << m_renderStatistics.endFlushes << "), binds " << m_renderStatistics.bindsTaken << " taken "
+		<< m_renderStatistics.bindsSkipped << " skipped, clip changes " << m_renderStatistics.clipChanges << ", uploaded " << m_renderStatistics.bytesUploaded << " bytes");
+	LOG("[ENGINE] RETAINED: " << m_renderStatistics.retainedDraws << " kept, " << m_renderStatistics.retainedUploads << " uploaded, "
+		<< m_renderStatistics.retainedFlushes << " flushes");
+	LOG("[ENGINE] PACING JITTER (ms): " << m_framePacer.GetAverageJitter() * 1000.0f << " avg, " << m_framePacer.GetMaxJitter() * 1000.0f << " max");
+	if (m_fixedTimestep)
+	{
+		const timer::FixedTimestep::Statistics& simulation = m_simulation.GetStatistics();
+		LOG("[ENGINE] SIMULATION STEPS: " << simulation.steps << ", caught up " << simulation.caughtUpSteps << ", dropped " << simulation.droppedSteps << ", max per lap " << simulation.maxSteps);
+	}
+	if (m_renderFrames)
+	{
+		command::RenderFrameQueue::Statistics frames = m_renderFrames->GetStatistics();
+		LOG("[ENGINE] RENDER THREAD: " << frames.submitted << " submitted, " << frames.rendered << " rendered, " << frames.stalls << " stalls ("
+			<< frames.stallTime * 1000.0f << " ms total, " << frames.maxStallTime * 1000.0f << " ms max)");
+	}
 }
 
 void engine::Engine::OnRender(float delta)
 {
-	// monitor render loop's frame rate
-	m_renderMonitorMonitor.OnFrameCompleted(delta);
+	// with render thread this is the handoff fence, the frame is drawn over there
+	if (m_renderFrames)
+	{
+		SubmitFrame(delta);
+		return;
+	}
+
+	Render(delta, m_simulation.GetAlpha(), m_commandQueue, m_renderQueue, m_renderList);
+}
+
+void engine::Engine::Render(float delta, float alpha, command::CommandQueue& commands, command::RenderQueue& packets, command::RenderList& list)
+{
+	PROFILE_SCOPE("Engine::Render");
+
+	// main thread waits on this while it uses the device context
+	std::lock_guard<std::mutex> contextLock(m_renderContextMutex);
+
+	// monitor render loop's frame rate and pick up a resize requested by the window
+	bool resize = false;
+	spatial::Size<uint32_t> size;
+	{
+		std::lock_guard<std::mutex> lock(m_renderStateMutex);
+		m_renderMonitorMonitor.OnFrameCompleted(delta);
+		if (m_resizePending)
+		{
+			resize = true;
+			size = m_pendingSize;
+			m_resizePending = false;
+		}
+	}
+	if (resize)
+	{
+		m_canvas->Resize(size);
+	}
 
 	// start the canvas. we can draw from here
 	m_canvas->Begin();
@@ -179,26 +449,148 @@ void engine::Engine::OnRender(float delta)
 		// render block
 		m_renderer->Begin();
 		{
-			// dispatch render commands on queue 
-			m_commandQueue.Dispatch(engine::command::Type::Render, false);
+			// interpolated commands read it while they execute
+			m_renderAlpha = alpha;
+
+			// dispatch render commands on queue. they stay until whoever recorded them clears them, so commands
+			// recorded at simulation rate are drawn every frame in between, with the alpha of that frame
+			commands.Dispatch(engine::command::Type::Render, false);
+
+			// dispatch draw packets, sorted by layer and texture
+			packets.Dispatch(*m_renderer);
+
+			// retained items. unchanged runs are drawn from what the renderer kept of them
+			list.Draw(*m_renderer);
 		}
 		m_renderer->End();
+
+		// publish counters, and viewport for main thread when it can't query the canvas itself
+		graphics::renderer::RenderStatistics statistics = m_renderer->GetStatistics();
+		math::geometry::RectF viewPort = m_renderFrames ? m_canvas->GetViewPort() : math::geometry::RectF{};
+		{
+			std::lock_guard<std::mutex> lock(m_renderStateMutex);
+			m_renderStatistics = statistics;
+			if (m_renderFrames)
+			{
+				m_viewPort = viewPort;
+			}
+		}
+
+		// stop capturing once we have enough frames and save them
+		if (m_drawStreamRecorder && m_drawStreamRecorder->IsRecording() && --m_drawStreamFramesLeft == 0)
+		{
+			m_drawStreamRecorder->SetRecording(false);
+			if (m_drawStream->SaveToFile(m_drawStreamFile))
+			{
+				LOG("[ENGINE] Captured " << m_drawStream->GetFrameCount() << " frames into " << m_drawStreamFile);
+			}
+		}
 	}
 	// end the canvas. we don't draw anything past this.
 	m_canvas->End();
 }
 
+void engine::Engine::SubmitFrame(float delta)
+{
+	PROFILE_SCOPE("Engine::SubmitFrame");
+
+	// waits here while render thread is behind
+	command::RenderFrameQueue::Frame* frame = m_renderFrames->BeginSubmit();
+	if (!frame)
+	{
+		return;
+	}
+
+	// render commands move over whole when they changed, and the queue gets the frame's emptied buffers back.
+	// unchanged ones are already with render thread. packets are copied, they stay submitted until the
+	// application clears them
+	frame->newCommands = m_commandQueue.GetVersion(command::Type::Render) != m_submittedCommands;
+	if (frame->newCommands)
+	{
+		frame->commands.Swap(command::Type::Render, m_commandQueue);
+		m_submittedCommands = m_commandQueue.GetVersion(command::Type::Render);
+	}
+	m_renderQueue.CopyTo(frame->packets);
+	m_renderList.CopyTo(frame->list);
+
+	m_renderFrames->EndSubmit(delta, m_simulation.GetAlpha());
+}
+
+void engine::Engine::RenderThread()
+{
+	if (!m_profileFile.empty())
+	{
+		performance::Profiler::Instance().SetThreadName("render");
+	}
+
+	while (command::RenderFrameQueue::Frame* frame = m_renderFrames->Acquire())
+	{
+		// new render commands replace the set drawn so far. the old set is destroyed here and the frame goes back
+		// empty, so the handoff can swap it into the command queue again
+		if (frame->newCommands)
+		{
+			m_renderCommands.Swap(command::Type::Render, frame->commands);
+			frame->commands.Clear(command::Type::Render);
+		}
+
+		Render(frame->delta, frame->alpha, m_renderCommands, frame->packets, frame->list);
+		m_renderFrames->Release();
+	}
+}
+
+void engine::Engine::StopRenderThread()
+{
+	if (m_renderThread.joinable())
+	{
+		m_renderFrames->Stop();
+		m_renderThread.join();
+		LOG("[ENGINE] Render thread stopped...");
+	}
+}
+
 void engine::Engine::Idle()
 {
+	// give the core back until the next render frame or scheduled pulse is due, instead of lapping as fast as
+	// the message loop spins
+	m_framePacer.Wait();
+
+	// virtual time moves by a fixed step per lap, as fast as the loop runs
+	if (m_virtualClock)
+	{
+		m_virtualClock->Advance(m_virtualTimeStep);
+	}
+
 	// we use stopwatch to measure the elapsed time between this frame and the last frame. 
 	// the elapsed time is passed into the event emmited by stopwatch when lap is executed
 	m_stopwatch.Lap<timer::seconds>();
+
+	// stop profile capture after requested number of laps. lap scope has closed, so the last lap is complete
+	if (m_profileLapsLeft > 0 && --m_profileLapsLeft == 0)
+	{
+		performance::Profiler& profiler = performance::Profiler::Instance();
+		profiler.EndCapture();
+		if (profiler.SaveChromeTrace(m_profileFile))
+		{
+			LOG("[ENGINE] Captured " << profiler.GetEventCount() << " profile events (" << profiler.GetDroppedCount() << " dropped) into " << m_profileFile);
+		}
+	}
+
+	// controller and scheduler were just updated by lap, so their time left is current. with fixed timestep the
+	// scheduler only moves on simulation steps, so the next step is the earliest it can fire
+	float untilFrame = m_renderController.GetTimeUntilNextFrame();
+	float untilPulse = m_fixedTimestep ? m_simulation.GetTimeUntilNextStep() : m_scheduler.GetTimeUntilNextTrigger();
+	m_framePacer.Schedule(untilFrame < untilPulse ? untilFrame : untilPulse);
 }
 
 void engine::Engine::Exit()
 {
+	// before end event, handlers may release resources queued frames still draw with
+	StopRenderThread();
+
 	EndEvent();
 	LOG("[ENGINE] End event happened...");
+
+	m_jobSystem.Stop();
 }
 
 
@@ -209,7 +601,17 @@ void engine::Engine::WindowClose()
 void engine::Engine::WindowSize(size_t width, size_t height)
 {
 	LOG("[ENGINE] window resized to " << width << " height = " << height << "...");
-	m_canvas->Resize({ static_cast<unsigned int>(width), static_cast<unsigned int>(height) });
+	if (m_renderFrames)
+	{
+		// canvas belongs to render thread, it resizes before its next frame
+		std::lock_guard<std::mutex> lock(m_renderStateMutex);
+		m_pendingSize = { static_cast<unsigned int>(width), static_cast<unsigned int>(height) };
+		m_resizePending = true;
+	}
+	else
+	{
+		m_canvas->Resize({ static_cast<unsigned int>(width), static_cast<unsigned int>(height) });
+	}
 	ResizeEvent(width, height);
 }
 
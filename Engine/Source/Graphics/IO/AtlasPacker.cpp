@@ -0,0 +1,231 @@
+#include <Graphics/IO/AtlasPacker.h>
+#include <Utilities/Logger.h>
+#include <algorithm>
+#include <numeric>
+#include <limits>
+
+#pragma region // MaxRectsBin
+
+graphics::imageio::atlas::MaxRectsBin::MaxRectsBin(uint32_t width, uint32_t height) :
+	m_width(width),
+	m_height(height)
+{
+	m_free.push_back({ 0, 0, width, height });
+}
+
+bool graphics::imageio::atlas::MaxRectsBin::Insert(uint32_t width, uint32_t height, PackRect& placed)
+{
+	// best short side fit. ties are broken by long side
+	uint32_t bestShort = std::numeric_limits<uint32_t>::max();
+	uint32_t bestLong = std::numeric_limits<uint32_t>::max();
+	bool found = false;
+
+	for (const PackRect& freeRect : m_free)
+	{
+		if (freeRect.width < width || freeRect.height < height)
+		{
+			continue;
+		}
+
+		uint32_t leftoverX = freeRect.width - width;
+		uint32_t leftoverY = freeRect.height - height;
+		uint32_t shortSide = std::min(leftoverX, leftoverY);
+		uint32_t longSide = std::max(leftoverX, leftoverY);
+
+		if (shortSide < bestShort || (shortSide == bestShort && longSide < bestLong))
+		{
+			placed = { freeRect.x, freeRect.y, width, height };
+			bestShort = shortSide;
+			bestLong = longSide;
+			found = true;
+		}
+	}
+
+	if (!found)
+	{
+		return false;
+	}
+
+	// split every free rect that overlaps the new one. split parts are appended, so only walk the old ones
+	size_t count = m_free.size();
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (SplitFreeRect(m_free[i], placed))
+		{
+			// mark as empty, removed below
+			m_free[i].width = 0;
+		}
+	}
+
+	m_free.erase(std::remove_if(m_free.begin(), m_free.end(), [](const PackRect& r) { return r.width == 0 || r.height == 0; }), m_free.end());
+	PruneFreeRects();
+
+	m_usedArea += static_cast<uint64_t>(width) * height;
+	return true;
+}
+
+bool graphics::imageio::atlas::MaxRectsBin::SplitFreeRect(const PackRect& freeRect, const PackRect& used)
+{
+	if (used.x >= freeRect.x + freeRect.width || used.x + used.width <= freeRect.x ||
+		used.y >= freeRect.y + freeRect.height || used.y + used.height <= freeRect.y)
+	{
+		return false;
+	}
+
+	// copy, push_back below may reallocate
+	PackRect rect = freeRect;
+
+	// up to four maximal rects around the used one
+	if (used.x > rect.x)
+	{
+		m_free.push_back({ rect.x, rect.y, used.x - rect.x, rect.height });
+	}
+	if (used.x + used.width < rect.x + rect.width)
+	{
+		uint32_t x = used.x + used.width;
+		m_free.push_back({ x, rect.y, rect.x + rect.width - x, rect.height });
+	}
+	if (used.y > rect.y)
+	{
+		m_free.push_back({ rect.x, rect.y, rect.width, used.y - rect.y });
+	}
+	if (used.y + used.height < rect.y + rect.height)
+	{
+		uint32_t y = used.y + used.height;
+		m_free.push_back({ rect.x, y, rect.width, rect.y + rect.height - y });
+	}
+
+	return true;
+}
+
+void graphics::imageio::atlas::MaxRectsBin::PruneFreeRects()
+{
+	auto contains = [](const PackRect& a, const PackRect& b)
+	{
+		return b.x >= a.x && b.y >= a.y && b.x + b.width <= a.x + a.width && b.y + b.height <= a.y + a.height;
+	};
+
+	for (size_t i = 0; i < m_free.size(); ++i)
+	{
+		for (size_t j = i + 1; j < m_free.size();)
+		{
+			if (contains(m_free[j], m_free[i]))
+			{
+				m_free.erase(m_free.begin() + i);
+				--i;
+				break;
+			}
+			if (contains(m_free[i], m_free[j]))
+			{
+				m_free.erase(m_free.begin() + j);
+			}
+			else
+			{
+				++j;
+			}
+		}
+	}
+}
+
+float graphics::imageio::atlas::MaxRectsBin::GetOccupancy() const
+{
+	uint64_t area = static_cast<uint64_t>(m_width) * m_height;
+	return area > 0 ? static_cast<float>(static_cast<double>(m_usedArea) / area) : 0.0f;
+}
+
+#pragma endregion
+
+#pragma region // AtlasPacker
+
+graphics::imageio::atlas::AtlasPacker::AtlasPacker(uint32_t pageWidth, uint32_t pageHeight, uint32_t padding) :
+	m_pageWidth(pageWidth),
+	m_pageHeight(pageHeight),
+	m_padding(padding)
+{
+}
+
+size_t graphics::imageio::atlas::AtlasPacker::AddGroup(const std::vector<Size>& sizes)
+{
+	Group group;
+	group.sizes = sizes;
+	for (const Size& size : sizes)
+	{
+		group.area += static_cast<uint64_t>(size.width + m_padding * 2) * (size.height + m_padding * 2);
+	}
+
+	m_groups.push_back(std::move(group));
+	return m_groups.size() - 1;
+}
+
+bool graphics::imageio::atlas::AtlasPacker::PackGroup(MaxRectsBin& bin, Group& group) const
+{
+	// tallest first packs noticeably tighter than submission order
+	std::vector<size_t> order(group.sizes.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&group](size_t a, size_t b)
+		{
+			const Size& sa = group.sizes[a];
+			const Size& sb = group.sizes[b];
+			return std::max(sa.width, sa.height) > std::max(sb.width, sb.height);
+		});
+
+	group.placed.resize(group.sizes.size());
+	for (size_t i : order)
+	{
+		const Size& size = group.sizes[i];
+		PackRect rect;
+		if (!bin.Insert(size.width + m_padding * 2, size.height + m_padding * 2, rect))
+		{
+			return false;
+		}
+		group.placed[i] = { rect.x + m_padding, rect.y + m_padding, size.width, size.height };
+	}
+
+	return true;
+}
+
+bool graphics::imageio::atlas::AtlasPacker::Pack()
+{
+	m_pages.clear();
+
+	std::vector<size_t> order(m_groups.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b)
+		{
+			return m_groups[a].area > m_groups[b].area;
+		});
+
+	for (size_t index : order)
+	{
+		Group& group = m_groups[index];
+		bool packed = false;
+
+		// try on a copy so a group that does not fit leaves the page untouched
+		for (size_t page = 0; page < m_pages.size() && !packed; ++page)
+		{
+			MaxRectsBin bin = m_pages[page];
+			if (PackGroup(bin, group))
+			{
+				m_pages[page] = std::move(bin);
+				group.page = static_cast<uint32_t>(page);
+				packed = true;
+			}
+		}
+
+		if (!packed)
+		{
+			MaxRectsBin bin(m_pageWidth, m_pageHeight);
+			if (!PackGroup(bin, group))
+			{
+				LOGERROR("Atlas group " << index << " does not fit in a " << m_pageWidth << "x" << m_pageHeight << " page.");
+				return false;
+			}
+			m_pages.push_back(std::move(bin));
+			group.page = static_cast<uint32_t>(m_pages.size() - 1);
+		}
+	}
+
+	return true;
+}
+
+#pragma endregion
@@ -0,0 +1,167 @@
+#include <Graphics/IO/BitmapFileHelper.h>
+#include <Utilities/Logger.h>
+#include <filesystem>
+#include <fstream>
+#include <cstdlib>
+
+namespace
+{
+	// read little-endian values from a byte buffer. we don't use packed structs so this stays portable across compilers
+	uint16_t ReadU16(const uint8_t* p)
+	{
+		return static_cast<uint16_t>(p[0] | (p[1] << 8));
+	}
+
+	uint32_t ReadU32(const uint8_t* p)
+	{
+		return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+	}
+
+	void WriteU16(std::vector<uint8_t>& out, uint16_t v)
+	{
+		out.push_back(static_cast<uint8_t>(v & 0xff));
+		out.push_back(static_cast<uint8_t>((v >> 8) & 0xff));
+	}
+
+	void WriteU32(std::vector<uint8_t>& out, uint32_t v)
+	{
+		out.push_back(static_cast<uint8_t>(v & 0xff));
+		out.push_back(static_cast<uint8_t>((v >> 8) & 0xff));
+		out.push_back(static_cast<uint8_t>((v >> 16) & 0xff));
+		out.push_back(static_cast<uint8_t>((v >> 24) & 0xff));
+	}
+
+	constexpr size_t FileHeaderSize = 14;
+	constexpr size_t InfoHeaderSize = 40;
+	constexpr uint32_t CompressionRGB = 0;
+	constexpr uint32_t CompressionBitFields = 3;
+}
+
+bool graphics::imageio::bmp::LoadFromFile(
+	const wchar_t* filename,
+	unsigned int& width,
+	unsigned int& height,
+	std::vector<uint32_t>& pixels
+)
+{
+	std::ifstream file(std::filesystem::path(filename), std::ios::binary);
+	if (!file)
+	{
+		LOGERROR("Failed to open bitmap file.");
+		return false;
+	}
+
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	if (data.size() < FileHeaderSize + InfoHeaderSize || data[0] != 'B' || data[1] != 'M')
+	{
+		LOGERROR("Invalid bitmap file header.");
+		return false;
+	}
+
+	const uint8_t* info = data.data() + FileHeaderSize;
+	uint32_t offset = ReadU32(data.data() + 10);
+	int32_t bmpWidth = static_cast<int32_t>(ReadU32(info + 4));
+	int32_t bmpHeight = static_cast<int32_t>(ReadU32(info + 8));
+	uint16_t bpp = ReadU16(info + 14);
+	uint32_t compression = ReadU32(info + 16);
+
+	if (bmpWidth <= 0 || bmpHeight == 0 || (bpp != 24 && bpp != 32) || (compression != CompressionRGB && compression != CompressionBitFields))
+	{
+		LOGERROR("Unsupported bitmap format. Only uncompressed 24 and 32 bit bitmaps are supported. Bits per pixel: " << bpp);
+		return false;
+	}
+
+	// negative height means rows are stored top-down
+	bool topDown = bmpHeight < 0;
+	width = static_cast<unsigned int>(bmpWidth);
+	height = static_cast<unsigned int>(std::abs(bmpHeight));
+
+	// each row is padded to 4 bytes boundary
+	size_t bytesPerPixel = bpp / 8;
+	size_t stride = (width * bytesPerPixel + 3) & ~static_cast<size_t>(3);
+	if (offset + stride * height > data.size())
+	{
+		LOGERROR("Bitmap file is truncated.");
+		return false;
+	}
+
+	pixels.resize(static_cast<size_t>(width) * height);
+	for (unsigned int row = 0; row < height; ++row)
+	{
+		unsigned int srcRow = topDown ? row : height - 1 - row;
+		const uint8_t* src = data.data() + offset + srcRow * stride;
+		uint32_t* dst = pixels.data() + static_cast<size_t>(row) * width;
+
+		for (unsigned int col = 0; col < width; ++col)
+		{
+			// bitmap stores B, G, R, (A). we store R, G, B, A
+			uint32_t b = src[0];
+			uint32_t g = src[1];
+			uint32_t r = src[2];
+			uint32_t a = bpp == 32 ? src[3] : 0xff;
+			dst[col] = r | (g << 8) | (b << 16) | (a << 24);
+			src += bytesPerPixel;
+		}
+	}
+
+	return true;
+}
+
+bool graphics::imageio::bmp::SaveToFile(
+	const wchar_t* filename,
+	unsigned int width,
+	unsigned int height,
+	const uint32_t* pixels
+)
+{
+	if (!filename || !pixels || width == 0 || height == 0)
+	{
+		LOGERROR("Invalid arguments in saving bitmap file.");
+		return false;
+	}
+
+	uint32_t imageSize = width * height * 4;
+
+	std::vector<uint8_t> out;
+	out.reserve(FileHeaderSize + InfoHeaderSize + imageSize);
+
+	// file header
+	out.push_back('B');
+	out.push_back('M');
+	WriteU32(out, static_cast<uint32_t>(FileHeaderSize + InfoHeaderSize) + imageSize);
+	WriteU32(out, 0);
+	WriteU32(out, static_cast<uint32_t>(FileHeaderSize + InfoHeaderSize));
+
+	// info header. negative height so we can write rows top-down as they are in memory
+	WriteU32(out, static_cast<uint32_t>(InfoHeaderSize));
+	WriteU32(out, width);
+	WriteU32(out, static_cast<uint32_t>(-static_cast<int32_t>(height)));
+	WriteU16(out, 1);
+	WriteU16(out, 32);
+	WriteU32(out, CompressionRGB);
+	WriteU32(out, imageSize);
+	WriteU32(out, 2835); // 72 DPI
+	WriteU32(out, 2835);
+	WriteU32(out, 0);
+	WriteU32(out, 0);
+
+	// pixel data. we store R, G, B, A. bitmap wants B, G, R, A
+	for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i)
+	{
+		uint32_t p = pixels[i];
+		out.push_back(static_cast<uint8_t>((p >> 16) & 0xff));
+		out.push_back(static_cast<uint8_t>((p >> 8) & 0xff));
+		out.push_back(static_cast<uint8_t>(p & 0xff));
+		out.push_back(static_cast<uint8_t>((p >> 24) & 0xff));
+	}
+
+	std::ofstream file(std::filesystem::path(filename), std::ios::binary);
+	if (!file)
+	{
+		LOGERROR("Failed to create bitmap file.");
+		return false;
+	}
+	file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+
+	return static_cast<bool>(file);
+}
@@ -0,0 +1,151 @@
+#include <Graphics/IO/CookedAtlasFile.h>
+#include <Utilities/Logger.h>
+#include <fstream>
+#include <type_traits>
+
+bool graphics::imageio::atlas::CookedAtlas::SaveToFile(const std::string& filename) const
+{
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		LOGERROR("Failed to create cooked atlas file: " << filename);
+		return false;
+	}
+
+	auto write = [&file](const void* data, size_t size)
+		{
+			file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+		};
+
+	auto writeU32 = [&write](uint32_t value)
+		{
+			write(&value, sizeof(value));
+		};
+
+	auto writeString = [&write, &writeU32](const std::string& value)
+		{
+			writeU32(static_cast<uint32_t>(value.size()));
+			write(value.data(), value.size());
+		};
+
+	static_assert(std::is_trivially_copyable<math::geometry::RectF>::value, "RectF must be trivially copyable");
+
+	writeU32(Magic);
+	writeU32(Version);
+
+	writeU32(static_cast<uint32_t>(pages.size()));
+	for (const Page& page : pages)
+	{
+		writeString(page.image);
+		writeU32(page.width);
+		writeU32(page.height);
+		writeU32(static_cast<uint32_t>(page.uvs.size()));
+		write(page.uvs.data(), sizeof(math::geometry::RectF) * page.uvs.size());
+	}
+
+	writeU32(static_cast<uint32_t>(entries.size()));
+	for (const Entry& entry : entries)
+	{
+		writeString(entry.name);
+		writeU32(entry.page);
+		writeU32(entry.first);
+		writeU32(entry.count);
+	}
+
+	return static_cast<bool>(file);
+}
+
+bool graphics::imageio::atlas::CookedAtlas::LoadFromFile(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		LOGERROR("Failed to open cooked atlas file: " << filename);
+		return false;
+	}
+
+	auto read = [&file](void* data, size_t size) -> bool
+		{
+			file.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+			return static_cast<bool>(file);
+		};
+
+	auto readU32 = [&read](uint32_t& value) -> bool
+		{
+			return read(&value, sizeof(value));
+		};
+
+	// guard against garbage lengths before allocating
+	constexpr uint32_t MaxStringLength = 4096;
+	auto readString = [&read, &readU32](std::string& value) -> bool
+		{
+			uint32_t length = 0;
+			if (!readU32(length) || length > MaxStringLength)
+			{
+				return false;
+			}
+			value.resize(length);
+			return read(&value[0], length);
+		};
+
+	pages.clear();
+	entries.clear();
+
+	uint32_t magic = 0, version = 0;
+	if (!readU32(magic) || !readU32(version) || magic != Magic || version != Version)
+	{
+		LOGERROR("Invalid cooked atlas file or unsupported version: " << filename);
+		return false;
+	}
+
+	uint32_t pageCount = 0;
+	bool ok = readU32(pageCount);
+	if (ok)
+	{
+		pages.resize(pageCount);
+	}
+	for (uint32_t i = 0; ok && i < pageCount; ++i)
+	{
+		Page& page = pages[i];
+		uint32_t uvCount = 0;
+		ok = readString(page.image) && readU32(page.width) && readU32(page.height) && readU32(uvCount);
+		if (ok)
+		{
+			page.uvs.resize(uvCount);
+			ok = read(page.uvs.data(), sizeof(math::geometry::RectF) * uvCount);
+		}
+	}
+
+	uint32_t entryCount = 0;
+	ok = ok && readU32(entryCount);
+	if (ok)
+	{
+		entries.resize(entryCount);
+	}
+	for (uint32_t i = 0; ok && i < entryCount; ++i)
+	{
+		Entry& entry = entries[i];
+		ok = readString(entry.name) && readU32(entry.page) && readU32(entry.first) && readU32(entry.count);
+	}
+
+	if (!ok)
+	{
+		LOGERROR("Cooked atlas file is truncated: " << filename);
+		pages.clear();
+		entries.clear();
+		return false;
+	}
+
+	for (const Entry& entry : entries)
+	{
+		if (entry.page >= pages.size() || static_cast<uint64_t>(entry.first) + entry.count > pages[entry.page].uvs.size())
+		{
+			LOGERROR("Cooked atlas file has invalid entry '" << entry.name << "': " << filename);
+			pages.clear();
+			entries.clear();
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -1,6 +1,7 @@
 #include <Win32/GDIUtility.h>
 #include <Graphics/Resource/ITexture.h>
 #include <Graphics/Renderable/FontAtlas.h>
+#include <algorithm>
 
 graphics::renderable::FontAtlas::FontAtlas(std::unique_ptr<graphics::resource::ITexture> tex)
 	: texture(std::move(tex))
@@ -10,12 +11,16 @@ graphics::renderable::FontAtlas::FontAtlas(std::unique_ptr<graphics::resource::I
 void graphics::renderable::FontAtlas::Reset()
 {
 	texture->Reset();
+	ClearLayouts();
 	// TODO: glyphs are not populated yet
 	glyphs.clear();
 }
 
 bool graphics::renderable::FontAtlas::Initialize(const std::string& fontName, const unsigned int fontSize)
 {
+	// layouts of previous font are no longer valid
+	ClearLayouts();
+
 	// generate font atlas bitmap data
 	unsigned int width, height;
 	unsigned int* srcData = nullptr;
@@ -138,6 +143,52 @@ const float graphics::renderable::FontAtlas::GetWidth(const std::string& text) c
 	return total;
 }
 
+const graphics::text::TextLayout* graphics::renderable::FontAtlas::GetTextLayout(std::string_view text) const
+{
+	auto it = m_layoutIndex.find(text);
+	if (it != m_layoutIndex.end())
+	{
+		// most recently used goes first. splice keeps the node, so the index and its key stay valid
+		m_layouts.splice(m_layouts.begin(), m_layouts, it->second);
+		return &it->second->layout;
+	}
+
+	if (m_layouts.size() >= MaxCachedLayouts)
+	{
+		m_layoutIndex.erase(m_layouts.back().text);
+		m_layouts.pop_back();
+	}
+
+	// same layout as drawing char by char: glyphs side by side from the top-left corner.
+	// characters without a glyph are skipped, same as GetWidth(text)
+	text::TextLayout layout;
+	layout.quads.reserve(text.size());
+
+	const float atlasWidth = static_cast<float>(texture->GetWidth());
+	const float atlasHeight = static_cast<float>(texture->GetHeight());
+
+	for (unsigned char c : text)
+	{
+		if (c < 32 || c > 127)
+		{
+			continue;
+		}
+
+		const std::array<float, 4>& coords = m_textNormalizedCoords[c - 32];
+		math::geometry::RectF uv{ coords[0], coords[1], coords[2], coords[3] };
+		float width = atlasWidth * (uv.right - uv.left);
+		float height = atlasHeight * (uv.bottom - uv.top);
+
+		layout.quads.push_back({ layout.width, 0.0f, width, height, uv });
+		layout.width += width;
+		layout.height = std::max(layout.height, height);
+	}
+
+	m_layouts.push_front({ std::string(text), std::move(layout) });
+	m_layoutIndex.emplace(m_layouts.front().text, m_layouts.begin());
+	return &m_layouts.front().layout;
+}
+
 float graphics::renderable::FontAtlas::GetWidth() const
 {
 	return static_cast<float>(texture->GetWidth());
@@ -24,6 +24,11 @@ math::geometry::RectF graphics::renderable::Sprite::GetUVRect() const
 	return m_rect;
 }
 
+const void* graphics::renderable::Sprite::GetBindKey() const
+{
+	return m_data->GetBindKey();
+}
+
 float graphics::renderable::Sprite::GetWidth() const
 {
 	return m_data->GetWidth()*(m_rect.right - m_rect.left);
@@ -36,6 +36,22 @@ HRESULT graphics::dx11::renderer::DX11RendererBase::CreateVertexBuffer(
 	return graphics::dx11::DX11Core::Instance().GetDevice()->CreateBuffer(&bd, &srd, pd3dVertexBuffer.GetAddressOf());
 }
 
+HRESULT graphics::dx11::renderer::DX11RendererBase::CreateDynamicVertexBuffer(
+	size_t vertexCount,
+	size_t vertexSize,
+	Microsoft::WRL::ComPtr<ID3D11Buffer>& pd3dVertexBuffer
+)
+{
+	D3D11_BUFFER_DESC bd = {};
+	bd.Usage = D3D11_USAGE_DYNAMIC;
+	bd.ByteWidth = static_cast<unsigned int>(vertexCount * vertexSize);
+	bd.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	bd.MiscFlags = 0;
+	bd.StructureByteStride = static_cast<UINT>(vertexSize);
+	return graphics::dx11::DX11Core::Instance().GetDevice()->CreateBuffer(&bd, nullptr, pd3dVertexBuffer.ReleaseAndGetAddressOf());
+}
+
 HRESULT graphics::dx11::renderer::DX11RendererBase::CompileShader(
 	const char* code, 
 	const char* sourceName, 
@@ -1,5 +1,6 @@
 #include <Graphics/Renderer/DX11RendererBatchImpl.h>
 #include <Utilities/Utilities.h>
+#include <Performance/Profiler.h>
 
 #pragma region // renderer::DX11RendererBatchImpl
 graphics::dx11::renderer::DX11RendererBatchImpl::DX11RendererBatchImpl()
@@ -11,27 +12,15 @@ cbuffer CBuf0: register(b0)
 	matrix projection;
 };
 
-cbuffer CBuf1: register(b1)
+struct VS_INPUT
 {
-	struct
-	{
-		float2 scale;
-		float2 translate;
-	}vertex[200];
-	struct
-	{
-		float2 scale;
-		float2 translate;
-	}texcoord[200];
-	float4 color[200];
-	struct
-	{
-		float rotate;
-		int useTexture;
-		int clippingEnabled;
-		float padding2;
-	}misc[200];
-	float4 view[200];
+	float2 pos: POSITION;
+	float2 tex: TEXCOORD;
+	float4 vertex: INSTANCE_VERTEX;
+	float4 texcoord: INSTANCE_TEXCOORD;
+	float4 color: INSTANCE_COLOR;
+	float4 misc: INSTANCE_MISC;
+	float4 view: INSTANCE_VIEW;
 };
 
 struct VS_OUTPUT
@@ -44,35 +33,35 @@ struct VS_OUTPUT
 	float4 view: VIEW;
 };
 
-VS_OUTPUT main(float2 pos: POSITION, float2 tex : TEXCOORD, uint id : SV_InstanceID)
+VS_OUTPUT main(VS_INPUT input)
 {
 	// scale first
-	pos *= vertex[id].scale;
+	float2 pos = input.pos * input.vertex.xy;
 
 	// rotate
-	float cos_rot = cos(misc[id].rotate);
-	float sin_rot = sin(misc[id].rotate);
+	float cos_rot = cos(input.misc.x);
+	float sin_rot = sin(input.misc.x);
 	float x = pos.x;
 	float y = pos.y;
 	pos.x = x * cos_rot - y * sin_rot;
 	pos.y = x * sin_rot + y * cos_rot;
 
 	// then translate
-	pos += vertex[id].translate;
+	pos += input.vertex.zw;
 
 	// and finally, set 2D projection
 	float4 ret = mul(float4(pos, 5.0f, 1.0f), projection);
 
-	tex *= texcoord[id].scale;
-	tex += texcoord[id].translate;
+	float2 tex = input.tex * input.texcoord.xy;
+	tex += input.texcoord.zw;
 
 	VS_OUTPUT vso;
 	vso.pos = ret;
-	vso.col = color[id];
+	vso.col = input.color;
 	vso.tex = tex;
-	vso.useTexture = misc[id].useTexture;
-	vso.clippingEnabled = misc[id].clippingEnabled;
-	vso.view = view[id];
+	vso.useTexture = (int)input.misc.y;
+	vso.clippingEnabled = (int)input.misc.z;
+	vso.view = input.view;
 
 	return vso;
 }
@@ -126,26 +115,14 @@ cbuffer CBuf0: register(b0)
 	matrix projection;
 };
 
-cbuffer CBuf1: register(b1)
+struct VS_INPUT
 {
-	struct
-	{
-		float2 scale;
-		float2 translate;
-	}vertex[200];
-	struct
-	{
-		float2 scale;
-		float2 translate;
-	}texcoord[200];
-	float4 color[200];
-	struct
-	{
-		float rotate;
-		int useTexture;
-		float padding1;
-		float padding2;
-	}misc[200];
+	float2 pos: POSITION;
+	float2 tex: TEXCOORD;
+	float4 vertex: INSTANCE_VERTEX;
+	float4 texcoord: INSTANCE_TEXCOORD;
+	float4 color: INSTANCE_COLOR;
+	float4 misc: INSTANCE_MISC;
 };
 
 struct VS_OUTPUT
@@ -156,33 +133,33 @@ struct VS_OUTPUT
 	int useTexture : USE_TEXTURE;
 };
 
-VS_OUTPUT main(float2 pos: POSITION, float2 tex : TEXCOORD, uint id : SV_InstanceID)
+VS_OUTPUT main(VS_INPUT input)
 {
 	// scale first
-	pos *= vertex[id].scale;
+	float2 pos = input.pos * input.vertex.xy;
 
 	// rotate
-	float cos_rot = cos(misc[id].rotate);
-	float sin_rot = sin(misc[id].rotate);
+	float cos_rot = cos(input.misc.x);
+	float sin_rot = sin(input.misc.x);
 	float x = pos.x;
 	float y = pos.y;
 	pos.x = x * cos_rot - y * sin_rot;
 	pos.y = x * sin_rot + y * cos_rot;
 
 	// then translate
-	pos += vertex[id].translate;
+	pos += input.vertex.zw;
 
 	// and finally, set 2D projection
 	float4 ret = mul(float4(pos, 5.0f, 1.0f), projection);
 
-	tex *= texcoord[id].scale;
-	tex += texcoord[id].translate;
+	float2 tex = input.tex * input.texcoord.xy;
+	tex += input.texcoord.zw;
 
 	VS_OUTPUT vso;
 	vso.pos = ret;
-	vso.col = color[id];
+	vso.col = input.color;
 	vso.tex = tex;
-	vso.useTexture = misc[id].useTexture;
+	vso.useTexture = (int)input.misc.y;
 	return vso;
 }
 		)";
@@ -227,6 +204,9 @@ std::string graphics::dx11::renderer::DX11RendererBatchImpl::GetTypeName() const
 
 void graphics::dx11::renderer::DX11RendererBatchImpl::ShutDown()
 {
+	m_pd3dInstanceBuffer.Reset();
+	m_instanceCapacity = 0;
+	m_retained.clear();
 	DX11RendererBase::ShutDown();
 }
 
@@ -258,6 +238,13 @@ bool graphics::dx11::renderer::DX11RendererBatchImpl::Initialize()
 	}
 #pragma endregion
 
+#pragma region // create instance buffer. it grows later if needed
+	if (!ReserveInstanceBuffer(m_batch.GetCapacity()))
+	{
+		return false;
+	}
+#pragma endregion
+
 #pragma region // define shader codes
 #if SPRITEBATCH_USESHADERWITHRECTVIEW
 	const char* VSCode = m_VSCodeWithView;
@@ -272,9 +259,14 @@ bool graphics::dx11::renderer::DX11RendererBatchImpl::Initialize()
 #pragma region // compile shaders and create shader and input layout resources
 	D3D11_INPUT_ELEMENT_DESC layout[] =
 	{
-		//	SEMANTIC	NAME	SEMANTIC INDEX  FORMAT			INPUT SLOT	ALIGNED BYTE OFFSET				INPUT SLOT CLASS 				INSTANCE CXATA STEP RATE
-		{	"POSITION",	0,		DXGI_FORMAT_R32G32_FLOAT,		0,			0,								D3D11_INPUT_PER_VERTEX_DATA,	0},
-		{	"TEXCOORD",	0,		DXGI_FORMAT_R32G32_FLOAT,		0,			D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA,	0},
+		//	SEMANTIC			NAME	SEMANTIC INDEX  FORMAT			INPUT SLOT	ALIGNED BYTE OFFSET				INPUT SLOT CLASS 				INSTANCE CXATA STEP RATE
+		{	"POSITION",			0,		DXGI_FORMAT_R32G32_FLOAT,		0,			0,								D3D11_INPUT_PER_VERTEX_DATA,	0},
+		{	"TEXCOORD",			0,		DXGI_FORMAT_R32G32_FLOAT,		0,			D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_VERTEX_DATA,	0},
+		{	"INSTANCE_VERTEX",	0,		DXGI_FORMAT_R32G32B32A32_FLOAT,	1,			0,								D3D11_INPUT_PER_INSTANCE_DATA,	1},
+		{	"INSTANCE_TEXCOORD",0,		DXGI_FORMAT_R32G32B32A32_FLOAT,	1,			D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_INSTANCE_DATA,	1},
+		{	"INSTANCE_COLOR",	0,		DXGI_FORMAT_R32G32B32A32_FLOAT,	1,			D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_INSTANCE_DATA,	1},
+		{	"INSTANCE_MISC",	0,		DXGI_FORMAT_R32G32B32A32_FLOAT,	1,			D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_INSTANCE_DATA,	1},
+		{	"INSTANCE_VIEW",	0,		DXGI_FORMAT_R32G32B32A32_FLOAT,	1,			D3D11_APPEND_ALIGNED_ELEMENT,	D3D11_INPUT_PER_INSTANCE_DATA,	1},
 	};
 
 	if (FAILED(this->CreateShadersAndInputLayout(
@@ -290,14 +282,6 @@ bool graphics::dx11::renderer::DX11RendererBatchImpl::Initialize()
 	}
 #pragma endregion
 
-#pragma region // create constant buffer for translate, scale, and color
-	if (FAILED(CreateConstantBuffer(&m_UpdateConstantBuffer, sizeof(ConstantBufferUpdate), m_pd3dConstantBufferUpdate)))
-	{
-		LOGERROR("Failed to create constant buffer for orthogonal projection.");
-		return false;
-	}
-#pragma endregion
-
 #pragma region // create constant buffer for orthogonal projection
 	MatrixTransform projection = { DirectX::XMMatrixIdentity() };
 	if (FAILED(CreateConstantBuffer(&projection, sizeof(MatrixTransform), m_pd3dConstantBufferProjection)))
@@ -326,6 +310,37 @@ bool graphics::dx11::renderer::DX11RendererBatchImpl::Initialize()
 	return true;
 }
 
+bool graphics::dx11::renderer::DX11RendererBatchImpl::ReserveInstanceBuffer(size_t count)
+{
+	if (count <= m_instanceCapacity && m_pd3dInstanceBuffer)
+	{
+		return true;
+	}
+
+	// grow in powers of 2 so we don't recreate the buffer every frame while batch size is still increasing
+	size_t capacity = m_instanceCapacity > 0 ? m_instanceCapacity : 1;
+	while (capacity < count)
+	{
+		capacity *= 2;
+	}
+
+	if (FAILED(CreateDynamicVertexBuffer(capacity, sizeof(InstanceData), m_pd3dInstanceBuffer)))
+	{
+		LOGERROR("Failed to create instance buffer for sprite batch. Instance count: " << capacity);
+		m_instanceCapacity = 0;
+		return false;
+	}
+	m_instanceCapacity = capacity;
+	++m_statistics.bufferGrowths;
+
+	// buffer is new so it needs to be bound again
+	unsigned int stride = sizeof(InstanceData);
+	unsigned int offset = 0;
+	DX11Core::Instance().GetContext()->IASetVertexBuffers(1, 1, m_pd3dInstanceBuffer.GetAddressOf(), &stride, &offset);
+
+	return true;
+}
+
 void graphics::dx11::renderer::DX11RendererBatchImpl::Begin()
 {
 	DX11Core& rCore = DX11Core::Instance();
@@ -337,9 +352,14 @@ void graphics::dx11::renderer::DX11RendererBatchImpl::Begin()
 #pragma endregion
 
 #pragma region // bind resources
-	unsigned int stride = sizeof(Vertex2D);
-	unsigned int offset = 0;
-	rCore.GetContext()->IASetVertexBuffers(0, 1, m_pd3dVertexBuffer.GetAddressOf(), &stride, &offset);
+	ID3D11Buffer* vertexBuffers[] =
+	{
+		m_pd3dVertexBuffer.Get(),	// slot 0: quad vertices
+		m_pd3dInstanceBuffer.Get(),	// slot 1: per instance data
+	};
+	unsigned int strides[] = { sizeof(Vertex2D), sizeof(InstanceData) };
+	unsigned int offsets[] = { 0, 0 };
+	rCore.GetContext()->IASetVertexBuffers(0, ARRAYSIZE(vertexBuffers), vertexBuffers, strides, offsets);
 	rCore.GetContext()->VSSetShader(m_pd3dVertexShader.Get(), nullptr, 0);
 	rCore.GetContext()->PSSetShader(m_pd3dPixelShader.Get(), nullptr, 0);
 	rCore.GetContext()->IASetInputLayout(m_pd3dInputLayout.Get());
@@ -349,16 +369,8 @@ void graphics::dx11::renderer::DX11RendererBatchImpl::Begin()
 	ID3D11Buffer* VSBuffers[] =
 	{
 		m_pd3dConstantBufferProjection.Get(), // Register b0
-		m_pd3dConstantBufferUpdate.Get(), // register b1
 	};
 	rCore.GetContext()->VSSetConstantBuffers(0, ARRAYSIZE(VSBuffers), VSBuffers);
-
-	// since we need useTexture flag in pixel shader, we need to set this constant buffer in pixel shader 
-	ID3D11Buffer* PSBuffers[] =
-	{
-		m_pd3dConstantBufferUpdate.Get(), // register b0
-	};
-	rCore.GetContext()->PSSetConstantBuffers(0, ARRAYSIZE(PSBuffers), PSBuffers);
 #pragma endregion
 
 #pragma region // set topology
@@ -370,29 +382,43 @@ void graphics::dx11::renderer::DX11RendererBatchImpl::Begin()
 	rCore.GetContext()->UpdateSubresource(m_pd3dConstantBufferProjection.Get(), 0, NULL, &projection, 0, 0);
 #pragma endregion
 
-#pragma region // initialize batch counter
-	m_nCurrSpriteCount = 0;
+#pragma region // start with empty batch and fresh counters
+	m_batch.Reset();
+	m_statistics = {};
+	++m_frame;
+	m_statistics.bytesUploaded = sizeof(MatrixTransform);
 #pragma endregion
 }
 
 void graphics::dx11::renderer::DX11RendererBatchImpl::End()
 {
 	// batch draw any remaining draw requests on queue
-	if (m_nCurrSpriteCount > 0)
+	DrawBatch(graphics::renderer::FlushCause::End);
+
+	// release buffers of retained spans nobody draws anymore
+	for (auto it = m_retained.begin(); it != m_retained.end();)
 	{
-		DrawBatch();
-		m_nCurrSpriteCount = 0;
+		if (m_frame - it->second.lastFrame > RetainedEvictFrames)
+		{
+			it = m_retained.erase(it);
+		}
+		else
+		{
+			++it;
+		}
 	}
 }
 
 void graphics::dx11::renderer::DX11RendererBatchImpl::SetClipRegion(const math::geometry::RectF& region)
 {
-	m_clipRegion = region;
+	m_statistics.RecordClipRegion(m_batch.GetCurrentClipRegion(), region);
+	m_batch.SetClipRegion(region);
 }
 
 void graphics::dx11::renderer::DX11RendererBatchImpl::EnableClipping(const bool enable)
 {
-	m_clippingEnabled = enable;
+	m_statistics.RecordClipping(m_batch.IsClippingEnabled(), enable);
+	m_batch.EnableClipping(enable);
 }
 
 void graphics::dx11::renderer::DX11RendererBatchImpl::Draw(
@@ -402,70 +428,24 @@ void graphics::dx11::renderer::DX11RendererBatchImpl::Draw(
 	const float rotation
 )
 {
-#pragma region // if there's enough on queue to draw in batch, let's do it
-	if (m_nCurrSpriteCount >= MAXSPRITEBATCH)
-	{
-		DrawBatch();
-		m_nCurrSpriteCount = 0;
-	}
-#pragma endregion
-
-#pragma region // update texture transform for this draw request
-	m_UpdateConstantBuffer.texture[m_nCurrSpriteCount].scale.x = 1; // texNormCoord.right - texNormCoord.left;
-	m_UpdateConstantBuffer.texture[m_nCurrSpriteCount].scale.y = 1; // texNormCoord.bottom - texNormCoord.top;
-	m_UpdateConstantBuffer.texture[m_nCurrSpriteCount].translate.x = 0; // texNormCoord.left;
-	m_UpdateConstantBuffer.texture[m_nCurrSpriteCount].translate.y = 0; // texNormCoord.top;
-#pragma endregion
-
-#pragma region // calculate vertex scale tranform based on the size of the font. note that font size is normalized so actual size is based on font texture size
-	m_UpdateConstantBuffer.vertex[m_nCurrSpriteCount].scale.x = size.width;
-	m_UpdateConstantBuffer.vertex[m_nCurrSpriteCount].scale.y = size.height;
-#pragma endregion
-
-#pragma region // update vertex translate transform. this will be the position. 
-	m_UpdateConstantBuffer.vertex[m_nCurrSpriteCount].translate.x = (-m_D3DViewPort.Width + size.width) / 2 + pos.x;
-	m_UpdateConstantBuffer.vertex[m_nCurrSpriteCount].translate.y = (m_D3DViewPort.Height - size.height) / 2 + -pos.y;
-#pragma endregion
-
-#pragma region // update rotation
-	m_UpdateConstantBuffer.Misc[m_nCurrSpriteCount].rotate = rotation;
-#pragma endregion
-
-#pragma region // set texture use flag
-	m_UpdateConstantBuffer.Misc[m_nCurrSpriteCount].useTexture = 0;
-#pragma endregion
-
-#pragma region // update color
-	m_UpdateConstantBuffer.color[m_nCurrSpriteCount].r = color.red;
-	m_UpdateConstantBuffer.color[m_nCurrSpriteCount].g = color.green;
-	m_UpdateConstantBuffer.color[m_nCurrSpriteCount].b = color.blue;
-	m_UpdateConstantBuffer.color[m_nCurrSpriteCount].a = color.alpha;
-#pragma endregion
-
-#pragma region // set view clip
-#if SPRITEBATCH_USESHADERWITHRECTVIEW
-	m_UpdateConstantBuffer.Misc[m_nCurrSpriteCount].clippingEnabled = m_clippingEnabled ? 1 : 0;
-	// we are translating the clip region to be relative to D3D viewport top-left because it is possible the viewport is not at 0,0
-	m_UpdateConstantBuffer.view[m_nCurrSpriteCount].x = m_clipRegion.left + m_D3DViewPort.TopLeftX;
-	m_UpdateConstantBuffer.view[m_nCurrSpriteCount].y = m_clipRegion.top + m_D3DViewPort.TopLeftY;
-	m_UpdateConstantBuffer.view[m_nCurrSpriteCount].z = m_clipRegion.right + m_D3DViewPort.TopLeftX;
-	m_UpdateConstantBuffer.view[m_nCurrSpriteCount].w = m_clipRegion.bottom + m_D3DViewPort.TopLeftY;
-#endif
-#pragma endregion
-
-#pragma region // increment batch counter
-	m_nCurrSpriteCount++;
-#pragma endregion
+	m_batch.Add(pos, size, { 0, 0, 1, 1 }, color, rotation, false);
 }
 
 // Draws a string using a font atlas at the specified position and color
 void graphics::dx11::renderer::DX11RendererBatchImpl::DrawText(
 	const graphics::renderable::IFontAtlas& font, // Font atlas
-	const std::string& text,                    // Text to render
+	std::string_view text,                    // Text to render
 	const spatial::PositionF pos,                                 // Top-left screen position
 	const graphics::ColorF color                                   // RGBA color tint
 )
 {
+	// laid out once per string by the font. one bind and one span of quads instead of a lookup per char
+	if (const graphics::text::TextLayout* layout = font.GetTextLayout(text))
+	{
+		DrawInstances(font, layout->quads.data(), layout->quads.size(), pos, color);
+		return;
+	}
+
 	float xCurr = pos.x;
 	for (char c : text)
 	{
@@ -486,78 +466,22 @@ void graphics::dx11::renderer::DX11RendererBatchImpl::DrawChar(
 	const float rotation                      // Rotation in radians
 )
 {
-#pragma region // if there's enough on queue to draw in batch, let's do it
-	if (m_nCurrSpriteCount >= MAXSPRITEBATCH)
-	{
-		DrawBatch();
-		m_nCurrSpriteCount = 0;
-	}
-#pragma endregion
-
 #pragma region // check if we need to bind texture. if current bound texture is same as what is needed for this draw call, then no need to bind this
-	if (font.CanBind())
+	const bool bind = font.CanBind();
+	m_statistics.RecordBind(bind);
+	if (bind)
 	{
 		// if there is any draw request on queue, flush it first
-		if (m_nCurrSpriteCount > 0)
-		{
-			DrawBatch();
-			m_nCurrSpriteCount = 0;
-		}
+		DrawBatch(graphics::renderer::FlushCause::Texture);
+
 		// then bind its texture
 		font.Bind();
 	}
 #pragma endregion
 
-#pragma region // set texture use flag
-	m_UpdateConstantBuffer.Misc[m_nCurrSpriteCount].useTexture = 1;
-#pragma endregion
-
-#pragma region // update texture transform for this draw request. since we are rendering the whole texture, we set the scale to 1 and translate to 0
-	float u0, v0, u1, v1;
-	font.GetNormalizedTexCoord(character, u0, v0, u1, v1);
-	m_UpdateConstantBuffer.texture[m_nCurrSpriteCount].scale.x = u1 - u0;
-	m_UpdateConstantBuffer.texture[m_nCurrSpriteCount].scale.y = v1 - v0;
-	m_UpdateConstantBuffer.texture[m_nCurrSpriteCount].translate.x = u0;
-	m_UpdateConstantBuffer.texture[m_nCurrSpriteCount].translate.y = v0;
-#pragma endregion
-
-#pragma region // calculate vertex scale tranform based on the size of the font. 
-	float width = font.GetWidth(character);
-	float height = font.GetHeight(character);
-	m_UpdateConstantBuffer.vertex[m_nCurrSpriteCount].scale.x = width;
-	m_UpdateConstantBuffer.vertex[m_nCurrSpriteCount].scale.y = height;
-#pragma endregion
-
-#pragma region // update vertex translate transform. this will be the position. 
-	m_UpdateConstantBuffer.vertex[m_nCurrSpriteCount].translate.x = (-m_D3DViewPort.Width + width) / 2 + pos.x;
-	m_UpdateConstantBuffer.vertex[m_nCurrSpriteCount].translate.y = (m_D3DViewPort.Height - height) / 2 + -pos.y;
-#pragma endregion
-
-#pragma region // update rotation
-	m_UpdateConstantBuffer.Misc[m_nCurrSpriteCount].rotate = rotation;
-#pragma endregion
-
-#pragma region // set color to white as it will be multiplied with texture color and we don't want to change the texture color
-	m_UpdateConstantBuffer.color[m_nCurrSpriteCount].r = color.red;
-	m_UpdateConstantBuffer.color[m_nCurrSpriteCount].g = color.green;
-	m_UpdateConstantBuffer.color[m_nCurrSpriteCount].b = color.blue;
-	m_UpdateConstantBuffer.color[m_nCurrSpriteCount].a = color.alpha;
-#pragma endregion
-
-#pragma region // set view clip
-#if SPRITEBATCH_USESHADERWITHRECTVIEW
-	m_UpdateConstantBuffer.Misc[m_nCurrSpriteCount].clippingEnabled = m_clippingEnabled ? 1 : 0;
-	// we are translating the clip region to be relative to D3D viewport top-left because it is possible the viewport is not at 0,0
-	m_UpdateConstantBuffer.view[m_nCurrSpriteCount].x = m_clipRegion.left + m_D3DViewPort.TopLeftX;
-	m_UpdateConstantBuffer.view[m_nCurrSpriteCount].y = m_clipRegion.top + m_D3DViewPort.TopLeftY;
-	m_UpdateConstantBuffer.view[m_nCurrSpriteCount].z = m_clipRegion.right + m_D3DViewPort.TopLeftX;
-	m_UpdateConstantBuffer.view[m_nCurrSpriteCount].w = m_clipRegion.bottom + m_D3DViewPort.TopLeftY;
-#endif
-#pragma endregion
-
-#pragma region // increment batch counter
-	m_nCurrSpriteCount++;
-#pragma endregion
+	math::geometry::RectF uv{};
+	font.GetNormalizedTexCoord(character, uv.left, uv.top, uv.right, uv.bottom);
+	m_batch.Add(pos, { font.GetWidth(character), font.GetHeight(character) }, uv, color, rotation, true);
 }
 
 void graphics::dx11::renderer::DX11RendererBatchImpl::DrawRenderable(
@@ -568,91 +492,298 @@ void graphics::dx11::renderer::DX11RendererBatchImpl::DrawRenderable(
 	const float rotation
 )
 {
-#pragma region // if there's enough on queue to draw in batch, let's do it
-	if (m_nCurrSpriteCount >= MAXSPRITEBATCH)
+#pragma region // check if we need to bind texture. if current bound texture is same as what is needed for this draw call, then no need to bind this
+	const bool bind = renderable.CanBind();
+	m_statistics.RecordBind(bind);
+	if (bind)
 	{
-		DrawBatch();
-		m_nCurrSpriteCount = 0;
+		// if there is any draw request on queue, flush it first
+		DrawBatch(graphics::renderer::FlushCause::Texture);
+
+		// then bind its texture
+		renderable.Bind();
 	}
 #pragma endregion
 
-#pragma region // check if we need to bind texture. if current bound texture is same as what is needed for this draw call, then no need to bind this
-	if (renderable.CanBind())
+	m_batch.Add(pos, size, renderable.GetUVRect(), color, rotation, true);
+}
+
+void graphics::dx11::renderer::DX11RendererBatchImpl::DrawInstances(
+	const graphics::renderable::IRenderable& renderable,
+	const graphics::renderer::SpriteInstance* instances,
+	const size_t count,
+	const spatial::PositionF offset,
+	const graphics::ColorF color
+)
+{
+	// same as DrawRenderable but texture is checked once for the whole span
+	const bool bind = renderable.CanBind();
+	m_statistics.RecordBind(bind);
+	if (bind)
 	{
 		// if there is any draw request on queue, flush it first
-		if (m_nCurrSpriteCount > 0)
+		DrawBatch(graphics::renderer::FlushCause::Texture);
+		renderable.Bind();
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const graphics::renderer::SpriteInstance& instance = instances[i];
+		m_batch.Add({ offset.x + instance.x, offset.y + instance.y }, { instance.width, instance.height }, instance.uv, color, 0.0f, true);
+	}
+}
+
+void graphics::dx11::renderer::DX11RendererBatchImpl::ReleaseRetained(const uint64_t id)
+{
+	m_retained.erase(id);
+}
+
+void graphics::dx11::renderer::DX11RendererBatchImpl::DrawRetained(
+	const graphics::renderable::IRenderable& renderable,
+	const graphics::renderer::SpriteInstance* instances,
+	const size_t count,
+	const spatial::PositionF offset,
+	const graphics::ColorF color,
+	const uint64_t id,
+	const uint64_t version
+)
+{
+	PROFILE_SCOPE("DX11RendererBatchImpl::DrawRetained");
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	// span is drawn from its own buffer, so whatever was batched before it has to be drawn first
+	const bool bind = renderable.CanBind();
+	m_statistics.RecordBind(bind);
+	DrawBatch(graphics::renderer::FlushCause::Retained);
+	if (bind)
+	{
+		renderable.Bind();
+	}
+
+	RetainedBuffer& retained = m_retained[id];
+	retained.lastFrame = m_frame;
+
+	const bool clipped = m_batch.IsClippingEnabled();
+	const math::geometry::RectF& clip = m_batch.GetCurrentClipRegion();
+
+	// everything that ends up in the packed instances has to match, otherwise the span is packed again
+	const bool unchanged =
+		retained.buffer &&
+		retained.version == version &&
+		retained.count == count &&
+		retained.offset.x == offset.x && retained.offset.y == offset.y &&
+		retained.color.red == color.red && retained.color.green == color.green &&
+		retained.color.blue == color.blue && retained.color.alpha == color.alpha &&
+		retained.viewPort.TopLeftX == m_D3DViewPort.TopLeftX && retained.viewPort.TopLeftY == m_D3DViewPort.TopLeftY &&
+		retained.viewPort.Width == m_D3DViewPort.Width && retained.viewPort.Height == m_D3DViewPort.Height &&
+		retained.clipped == clipped &&
+		(!clipped || (retained.clip.left == clip.left && retained.clip.top == clip.top &&
+			retained.clip.right == clip.right && retained.clip.bottom == clip.bottom));
+
+	if (!unchanged)
+	{
+		retained.version = version;
+		retained.offset = offset;
+		retained.color = color;
+		retained.viewPort = m_D3DViewPort;
+		retained.clipped = clipped;
+		retained.clip = clip;
+
+		if (!UploadRetained(retained, instances, count, offset, color))
 		{
-			DrawBatch();
-			m_nCurrSpriteCount = 0;
+			m_retained.erase(id);
+			return;
 		}
-		// then bind its texture
-		renderable.Bind();
+		++m_statistics.retainedUploads;
+		m_statistics.bytesUploaded += count * sizeof(InstanceData);
+	}
+	else
+	{
+		++m_statistics.retainedDraws;
 	}
-#pragma endregion
 
-#pragma region // set texture use flag
-	m_UpdateConstantBuffer.Misc[m_nCurrSpriteCount].useTexture = 1;
+#pragma region // draw from span's buffer, then put batch's buffer back on slot 1
+	DX11Core& rCore = DX11Core::Instance();
+	unsigned int stride = sizeof(InstanceData);
+	unsigned int bufferOffset = 0;
+	rCore.GetContext()->IASetVertexBuffers(1, 1, retained.buffer.GetAddressOf(), &stride, &bufferOffset);
+	rCore.GetContext()->DrawInstanced(4, static_cast<UINT>(count), 0, 0);
+	rCore.GetContext()->IASetVertexBuffers(1, 1, m_pd3dInstanceBuffer.GetAddressOf(), &stride, &bufferOffset);
 #pragma endregion
 
-#pragma region // update texture transform for this draw request
-	math::geometry::RectF rect = renderable.GetUVRect();
-	m_UpdateConstantBuffer.texture[m_nCurrSpriteCount].scale.x = (rect.right - rect.left);
-	m_UpdateConstantBuffer.texture[m_nCurrSpriteCount].scale.y = (rect.bottom - rect.top);
-	m_UpdateConstantBuffer.texture[m_nCurrSpriteCount].translate.x = rect.left;
-	m_UpdateConstantBuffer.texture[m_nCurrSpriteCount].translate.y = rect.top;
-#pragma endregion
+	m_statistics.instances += count;
+	++m_statistics.drawCalls;
+}
 
-#pragma region // calculate vertex scale tranform based on the size of the font. note that font size is normalized so actual size is based on font texture size
-	m_UpdateConstantBuffer.vertex[m_nCurrSpriteCount].scale.x = size.width;
-	m_UpdateConstantBuffer.vertex[m_nCurrSpriteCount].scale.y = size.height;
-#pragma endregion
+bool graphics::dx11::renderer::DX11RendererBatchImpl::UploadRetained(
+	RetainedBuffer& retained,
+	const graphics::renderer::SpriteInstance* instances,
+	const size_t count,
+	const spatial::PositionF offset,
+	const graphics::ColorF color
+)
+{
+	DX11Core& rCore = DX11Core::Instance();
 
-#pragma region // update vertex translate transform. this will be the position. 
-	m_UpdateConstantBuffer.vertex[m_nCurrSpriteCount].translate.x = (-m_D3DViewPort.Width + size.width) / 2 + pos.x;
-	m_UpdateConstantBuffer.vertex[m_nCurrSpriteCount].translate.y = (m_D3DViewPort.Height - size.height) / 2 + -pos.y;
-#pragma endregion
+	// same growth as batch buffer. spans that change size a little do not recreate their buffer every time
+	if (!retained.buffer || count > retained.capacity)
+	{
+		size_t capacity = retained.capacity > 0 ? retained.capacity : 1;
+		while (capacity < count)
+		{
+			capacity *= 2;
+		}
 
-#pragma region // update rotation
-	m_UpdateConstantBuffer.Misc[m_nCurrSpriteCount].rotate = rotation;
-#pragma endregion
+		if (FAILED(CreateDynamicVertexBuffer(capacity, sizeof(InstanceData), retained.buffer)))
+		{
+			LOGERROR("Failed to create instance buffer for retained span. Instance count: " << capacity);
+			return false;
+		}
+		retained.capacity = capacity;
+		++m_statistics.bufferGrowths;
+	}
 
-#pragma region // update color
-	m_UpdateConstantBuffer.color[m_nCurrSpriteCount].r = color.red;
-	m_UpdateConstantBuffer.color[m_nCurrSpriteCount].g = color.green;
-	m_UpdateConstantBuffer.color[m_nCurrSpriteCount].b = color.blue;
-	m_UpdateConstantBuffer.color[m_nCurrSpriteCount].a = color.alpha;
-#pragma endregion
+	D3D11_MAPPED_SUBRESOURCE mapped = {};
+	if (FAILED(rCore.GetContext()->Map(retained.buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)))
+	{
+		LOGERROR("Failed to map instance buffer for retained span.");
+		return false;
+	}
 
-#pragma region // set view clip
-#if SPRITEBATCH_USESHADERWITHRECTVIEW
-	m_UpdateConstantBuffer.Misc[m_nCurrSpriteCount].clippingEnabled = m_clippingEnabled ? 1 : 0;
-	// we are translating the clip region to be relative to D3D viewport top-left because it is possible the viewport is not at 0,0
-	m_UpdateConstantBuffer.view[m_nCurrSpriteCount].x = m_clipRegion.left + m_D3DViewPort.TopLeftX;
-	m_UpdateConstantBuffer.view[m_nCurrSpriteCount].y = m_clipRegion.top + m_D3DViewPort.TopLeftY;
-	m_UpdateConstantBuffer.view[m_nCurrSpriteCount].z = m_clipRegion.right + m_D3DViewPort.TopLeftX;
-	m_UpdateConstantBuffer.view[m_nCurrSpriteCount].w = m_clipRegion.bottom + m_D3DViewPort.TopLeftY;
-#endif
-#pragma endregion
+	InstanceData* packed = static_cast<InstanceData*>(mapped.pData);
 
-#pragma region // increment batch counter
-	m_nCurrSpriteCount++;
-#pragma endregion
+	const float halfViewWidth = m_D3DViewPort.Width / 2;
+	const float halfViewHeight = m_D3DViewPort.Height / 2;
+
+	// clip region is the same for the whole span
+	Float4 view = {};
+	if (retained.clipped)
+	{
+		view = {
+			retained.clip.left + m_D3DViewPort.TopLeftX,
+			retained.clip.top + m_D3DViewPort.TopLeftY,
+			retained.clip.right + m_D3DViewPort.TopLeftX,
+			retained.clip.bottom + m_D3DViewPort.TopLeftY
+		};
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const graphics::renderer::SpriteInstance& instance = instances[i];
+		InstanceData& data = packed[i];
+
+		// same packing as DrawBatch, see there
+		const float x = offset.x + instance.x;
+		const float y = offset.y + instance.y;
+		data.vertex = { instance.width, instance.height, -halfViewWidth + instance.width / 2 + x, halfViewHeight - instance.height / 2 - y };
+		data.texcoord = { instance.uv.right - instance.uv.left, instance.uv.bottom - instance.uv.top, instance.uv.left, instance.uv.top };
+		data.color = { color.red, color.green, color.blue, color.alpha };
+		data.misc = { 0.0f, 1.0f, retained.clipped ? 1.0f : 0.0f, 0 };
+		data.view = view;
+	}
+
+	rCore.GetContext()->Unmap(retained.buffer.Get(), 0);
+	retained.count = count;
+	return true;
 }
 
-void graphics::dx11::renderer::DX11RendererBatchImpl::DrawBatch()
+void graphics::dx11::renderer::DX11RendererBatchImpl::DrawBatch(const graphics::renderer::FlushCause cause)
 {
+	PROFILE_SCOPE("DX11RendererBatchImpl::DrawBatch");
+
+	if (!m_batch.HasPending())
+	{
+		return;
+	}
+
 	DX11Core& rCore = DX11Core::Instance();
+	graphics::renderer::SpriteBatchBuilder::Span span = m_batch.GetPending();
 
-#pragma region // update constant buffers
-	rCore.GetContext()->UpdateSubresource(m_pd3dConstantBufferUpdate.Get(), 0, NULL, &m_UpdateConstantBuffer, 0, 0);
+	if (!ReserveInstanceBuffer(span.count))
+	{
+		m_batch.MarkSubmitted();
+		return;
+	}
+
+#pragma region // pack pending instances into instance buffer. only the used range is written
+	D3D11_MAPPED_SUBRESOURCE mapped = {};
+	if (FAILED(rCore.GetContext()->Map(m_pd3dInstanceBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)))
+	{
+		LOGERROR("Failed to map instance buffer for sprite batch.");
+		m_batch.MarkSubmitted();
+		return;
+	}
+
+	InstanceData* instances = static_cast<InstanceData*>(mapped.pData);
+
+	const float* x = m_batch.GetX();
+	const float* y = m_batch.GetY();
+	const float* width = m_batch.GetWidth();
+	const float* height = m_batch.GetHeight();
+	const float* rotation = m_batch.GetRotation();
+	const float* u = m_batch.GetU();
+	const float* v = m_batch.GetV();
+	const float* uScale = m_batch.GetUScale();
+	const float* vScale = m_batch.GetVScale();
+	const float* red = m_batch.GetRed();
+	const float* green = m_batch.GetGreen();
+	const float* blue = m_batch.GetBlue();
+	const float* alpha = m_batch.GetAlpha();
+	const uint8_t* flags = m_batch.GetFlags();
+	const uint16_t* clipIndex = m_batch.GetClipIndex();
+
+	const float halfViewWidth = m_D3DViewPort.Width / 2;
+	const float halfViewHeight = m_D3DViewPort.Height / 2;
+
+	for (size_t i = span.first, n = 0; n < span.count; ++i, ++n)
+	{
+		InstanceData& instance = instances[n];
+
+		// vertex translate is the quad's center relative to D3D viewport center, with y going up
+		instance.vertex = { width[i], height[i], -halfViewWidth + width[i] / 2 + x[i], halfViewHeight - height[i] / 2 - y[i] };
+		instance.texcoord = { uScale[i], vScale[i], u[i], v[i] };
+		instance.color = { red[i], green[i], blue[i], alpha[i] };
+
+		const bool clipped = (flags[i] & graphics::renderer::SpriteBatchBuilder::Clipped) != 0;
+		instance.misc = {
+			rotation[i],
+			(flags[i] & graphics::renderer::SpriteBatchBuilder::Textured) ? 1.0f : 0.0f,
+			clipped ? 1.0f : 0.0f,
+			0
+		};
+
+		// we are translating the clip region to be relative to D3D viewport top-left because it is possible the viewport is not at 0,0
+		if (clipped)
+		{
+			const math::geometry::RectF& clip = m_batch.GetClipRegion(clipIndex[i]);
+			instance.view = {
+				clip.left + m_D3DViewPort.TopLeftX,
+				clip.top + m_D3DViewPort.TopLeftY,
+				clip.right + m_D3DViewPort.TopLeftX,
+				clip.bottom + m_D3DViewPort.TopLeftY
+			};
+		}
+		else
+		{
+			instance.view = {};
+		}
+	}
+
+	rCore.GetContext()->Unmap(m_pd3dInstanceBuffer.Get(), 0);
 #pragma endregion
 
 #pragma region // draw batched
-	rCore.GetContext()->DrawInstanced(4, m_nCurrSpriteCount, 0, 0);
+	rCore.GetContext()->DrawInstanced(4, static_cast<UINT>(span.count), 0, 0);
 #pragma endregion
-}
 
+	m_statistics.RecordFlush(cause, span.count, span.count * sizeof(InstanceData));
 
-#pragma endregion
+	m_batch.MarkSubmitted();
+}
 
 
+#pragma endregion
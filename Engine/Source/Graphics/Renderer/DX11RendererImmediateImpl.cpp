@@ -256,6 +256,9 @@ void graphics::dx11::renderer::DX11RendererImmediateImpl::Begin()
 	MatrixTransform projection = { DirectX::XMMatrixTranspose(DirectX::XMMatrixOrthographicLH(m_D3DViewPort.Width, m_D3DViewPort.Height, 0.1f, 100.0f)) };
 	rCore.GetContext()->UpdateSubresource(m_pd3dConstantBufferProjection.Get(), 0, NULL, &projection, 0, 0);
 #pragma endregion
+
+	m_statistics = {};
+	m_statistics.bytesUploaded = sizeof(MatrixTransform);
 }
 
 void graphics::dx11::renderer::DX11RendererImmediateImpl::End()
@@ -264,11 +267,13 @@ void graphics::dx11::renderer::DX11RendererImmediateImpl::End()
 
 void graphics::dx11::renderer::DX11RendererImmediateImpl::SetClipRegion(const math::geometry::RectF& region)
 {
+	m_statistics.RecordClipRegion(m_clipRegion, region);
 	m_clipRegion = region;
 }
 
 void graphics::dx11::renderer::DX11RendererImmediateImpl::EnableClipping(const bool enable)
 {
+	m_statistics.RecordClipping(m_clippingEnabled, enable);
 	m_clippingEnabled = enable;
 }
 
@@ -325,16 +330,25 @@ void graphics::dx11::renderer::DX11RendererImmediateImpl::Draw(
 #pragma region //draw
 	rCore.GetContext()->Draw(4, 0);
 #pragma endregion
+
+	CountDraw();
 }
 
 // Draws a string using a font atlas at the specified position and color
 void graphics::dx11::renderer::DX11RendererImmediateImpl::DrawText(
 	const graphics::renderable::IFontAtlas& font, // Font atlas
-	const std::string& text,                    // Text to render
+	std::string_view text,                    // Text to render
 	const spatial::PositionF pos,                                 // Top-left screen position
 	const graphics::ColorF color                                   // RGBA color tint
 )
 {
+	// laid out once per string by the font. one bind and one span of quads instead of a lookup per char
+	if (const graphics::text::TextLayout* layout = font.GetTextLayout(text))
+	{
+		DrawInstances(font, layout->quads.data(), layout->quads.size(), pos, color);
+		return;
+	}
+
 	float xCurr = pos.x;
 	for (char c : text)
 	{
@@ -356,7 +370,9 @@ void graphics::dx11::renderer::DX11RendererImmediateImpl::DrawChar(
 )
 {
 #pragma region // check if we need to bind texture. if current bound texture is same as what is needed for this draw call, then no need to bind this
-	if (font.CanBind())
+	const bool bind = font.CanBind();
+	m_statistics.RecordBind(bind);
+	if (bind)
 	{
 		// then bind its texture
 		font.Bind();
@@ -406,6 +422,8 @@ void graphics::dx11::renderer::DX11RendererImmediateImpl::DrawChar(
 #pragma region //draw
 	graphics::dx11::DX11Core::Instance().GetContext()->Draw(4, 0);
 #pragma endregion
+
+	CountDraw();
 }
 
 void graphics::dx11::renderer::DX11RendererImmediateImpl::DrawRenderable(
@@ -417,6 +435,7 @@ void graphics::dx11::renderer::DX11RendererImmediateImpl::DrawRenderable(
 )
 {
 #pragma region // binds the texture. this will only bind it if current texture is different from this texture.
+	m_statistics.RecordBind(renderable.CanBind());
 	renderable.Bind();
 #pragma endregion
 
@@ -460,4 +479,6 @@ void graphics::dx11::renderer::DX11RendererImmediateImpl::DrawRenderable(
 #pragma region //draw
 	graphics::dx11::DX11Core::Instance().GetContext()->Draw(4, 0);
 #pragma endregion
+
+	CountDraw();
 }
@@ -0,0 +1,173 @@
+#include <Graphics/Renderer/DrawStream.h>
+#include <Utilities/Logger.h>
+#include <fstream>
+
+void graphics::renderer::DrawStream::Clear()
+{
+	m_data.clear();
+	m_frames.clear();
+	m_fonts.clear();
+	m_textureCount = 0;
+	m_inFrame = false;
+	m_textureIds.clear();
+	m_fontIds.clear();
+}
+
+graphics::renderer::DrawStream::Reader graphics::renderer::DrawStream::GetFrame(size_t index) const
+{
+	if (index >= m_frames.size())
+	{
+		throw std::out_of_range("DrawStream::GetFrame - index out of bounds");
+	}
+	return Reader(m_data.data() + m_frames[index].begin, m_data.data() + m_frames[index].end);
+}
+
+void graphics::renderer::DrawStream::BeginFrame()
+{
+	// a frame that never ended is discarded. we don't want partial frames in the stream
+	if (m_inFrame)
+	{
+		m_data.resize(m_frames.back().begin);
+		m_frames.pop_back();
+	}
+
+	m_frames.push_back({ m_data.size(), m_data.size() });
+	m_inFrame = true;
+}
+
+void graphics::renderer::DrawStream::EndFrame()
+{
+	if (!m_inFrame)
+	{
+		return;
+	}
+
+	m_frames.back().end = m_data.size();
+	m_inFrame = false;
+}
+
+uint16_t graphics::renderer::DrawStream::GetTextureId(const void* texture)
+{
+	if (!texture)
+	{
+		return NoTexture;
+	}
+
+	auto it = m_textureIds.find(texture);
+	if (it != m_textureIds.end())
+	{
+		return it->second;
+	}
+
+	uint16_t id = m_textureCount++;
+	m_textureIds[texture] = id;
+	return id;
+}
+
+uint16_t graphics::renderer::DrawStream::FindFontId(const void* font) const
+{
+	auto it = m_fontIds.find(font);
+	return it != m_fontIds.end() ? it->second : NoTexture;
+}
+
+uint16_t graphics::renderer::DrawStream::AddFont(const void* font, const FontDefinition& definition)
+{
+	uint16_t id = static_cast<uint16_t>(m_fonts.size());
+	m_fonts.push_back(definition);
+	m_fontIds[font] = id;
+	return id;
+}
+
+bool graphics::renderer::DrawStream::SaveToFile(const std::string& filename) const
+{
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		LOGERROR("Failed to create draw stream file: " << filename);
+		return false;
+	}
+
+	auto write = [&file](const void* data, size_t size)
+		{
+			file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+		};
+
+	uint32_t frameCount = static_cast<uint32_t>(m_frames.size());
+	uint32_t fontCount = static_cast<uint32_t>(m_fonts.size());
+	uint64_t dataSize = m_data.size();
+
+	write(&Magic, sizeof(Magic));
+	write(&Version, sizeof(Version));
+	write(&m_textureCount, sizeof(m_textureCount));
+	write(&fontCount, sizeof(fontCount));
+	write(m_fonts.data(), sizeof(FontDefinition) * m_fonts.size());
+	write(&frameCount, sizeof(frameCount));
+	write(m_frames.data(), sizeof(Frame) * m_frames.size());
+	write(&dataSize, sizeof(dataSize));
+	write(m_data.data(), m_data.size());
+
+	return static_cast<bool>(file);
+}
+
+bool graphics::renderer::DrawStream::LoadFromFile(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		LOGERROR("Failed to open draw stream file: " << filename);
+		return false;
+	}
+
+	auto read = [&file](void* data, size_t size) -> bool
+		{
+			file.read(static_cast<char*>(data), static_cast<std::streamsize>(size));
+			return static_cast<bool>(file);
+		};
+
+	Clear();
+
+	uint32_t magic = 0, version = 0, fontCount = 0, frameCount = 0;
+	uint64_t dataSize = 0;
+
+	if (!read(&magic, sizeof(magic)) || !read(&version, sizeof(version)) || magic != Magic || version != Version)
+	{
+		LOGERROR("Invalid draw stream file or unsupported version: " << filename);
+		return false;
+	}
+
+	bool ok = read(&m_textureCount, sizeof(m_textureCount)) && read(&fontCount, sizeof(fontCount));
+	if (ok)
+	{
+		m_fonts.resize(fontCount);
+		ok = read(m_fonts.data(), sizeof(FontDefinition) * fontCount) && read(&frameCount, sizeof(frameCount));
+	}
+	if (ok)
+	{
+		m_frames.resize(frameCount);
+		ok = read(m_frames.data(), sizeof(Frame) * frameCount) && read(&dataSize, sizeof(dataSize));
+	}
+	if (ok)
+	{
+		m_data.resize(static_cast<size_t>(dataSize));
+		ok = read(m_data.data(), m_data.size());
+	}
+
+	if (!ok)
+	{
+		LOGERROR("Draw stream file is truncated: " << filename);
+		Clear();
+		return false;
+	}
+
+	for (const Frame& frame : m_frames)
+	{
+		if (frame.begin > frame.end || frame.end > m_data.size())
+		{
+			LOGERROR("Draw stream file has invalid frame table: " << filename);
+			Clear();
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,281 @@
+#include <Graphics/Renderer/DrawStreamPlayer.h>
+#include <Graphics/Resource/SoftwareTextureImpl.h>
+#include <Graphics/Renderable/IFontAtlas.h>
+#include <Utilities/Logger.h>
+#include <stdexcept>
+
+#pragma region // proxies
+class graphics::renderer::DrawStreamPlayer::ReplayRenderable : public graphics::renderable::IRenderable
+{
+public:
+	graphics::resource::ITexture* texture = nullptr;
+	math::geometry::RectF uv = { 0, 0, 1, 1 };
+
+	virtual void Bind() const override
+	{
+		if (texture)
+		{
+			texture->Bind();
+		}
+	}
+
+	virtual bool CanBind() const override
+	{
+		return texture ? texture->CanBind() : false;
+	}
+
+	virtual math::geometry::RectF GetUVRect() const override
+	{
+		return uv;
+	}
+
+	virtual const void* GetBindKey() const override
+	{
+		return texture;
+	}
+};
+
+class graphics::renderer::DrawStreamPlayer::ReplayFontAtlas : public graphics::renderable::IFontAtlas
+{
+private:
+	const graphics::renderer::DrawStream::FontDefinition& m_definition;
+	std::vector<graphics::text::Glyph> m_glyphs;
+
+	static bool IsValid(const unsigned char character)
+	{
+		return character >= DrawStream::FirstGlyph && character <= DrawStream::LastGlyph;
+	}
+
+public:
+	ReplayRenderable& renderable;
+
+	ReplayFontAtlas(const graphics::renderer::DrawStream::FontDefinition& definition, ReplayRenderable& renderable) :
+		m_definition(definition),
+		renderable(renderable)
+	{
+		m_glyphs.reserve(DrawStream::GlyphCount);
+		for (size_t i = 0; i < DrawStream::GlyphCount; ++i)
+		{
+			m_glyphs.push_back({ m_definition.uv[i], m_definition.size[i] });
+		}
+	}
+
+	virtual bool Initialize(const std::string&, const unsigned int) override
+	{
+		return true;
+	}
+
+	virtual void Reset() override
+	{
+	}
+
+	virtual const graphics::text::Glyph* GetGlyph(const unsigned char character) const override
+	{
+		return IsValid(character) ? &m_glyphs[character - DrawStream::FirstGlyph] : nullptr;
+	}
+
+	virtual bool GetNormalizedTexCoord(const unsigned char character, float& u0, float& v0, float& u1, float& v1) const override
+	{
+		if (!IsValid(character))
+		{
+			return false;
+		}
+		const math::geometry::RectF& uv = m_definition.uv[character - DrawStream::FirstGlyph];
+		u0 = uv.left;
+		v0 = uv.top;
+		u1 = uv.right;
+		v1 = uv.bottom;
+		return true;
+	}
+
+	virtual const float GetWidth(const unsigned char character) const override
+	{
+		return IsValid(character) ? m_definition.size[character - DrawStream::FirstGlyph].width : 0.0f;
+	}
+
+	virtual const float GetHeight(const unsigned char character) const override
+	{
+		return IsValid(character) ? m_definition.size[character - DrawStream::FirstGlyph].height : 0.0f;
+	}
+
+	virtual const float GetWidth(const std::string& text) const override
+	{
+		float width = 0;
+		for (unsigned char c : text)
+		{
+			width += GetWidth(c);
+		}
+		return width;
+	}
+
+	virtual float GetWidth() const override
+	{
+		return m_definition.atlasSize.width;
+	}
+
+	virtual float GetHeight() const override
+	{
+		return m_definition.atlasSize.height;
+	}
+
+	virtual spatial::SizeF GetSize() const override
+	{
+		return m_definition.atlasSize;
+	}
+
+	virtual math::geometry::RectF GetUVRect() const override
+	{
+		return math::geometry::RectF{ 0, 0, 1, 1 };
+	}
+
+	virtual void Bind() const override
+	{
+		renderable.Bind();
+	}
+
+	virtual bool CanBind() const override
+	{
+		return renderable.CanBind();
+	}
+
+	virtual const void* GetBindKey() const override
+	{
+		return renderable.GetBindKey();
+	}
+};
+#pragma endregion
+
+graphics::renderer::DrawStreamPlayer::DrawStreamPlayer(const graphics::renderer::DrawStream& stream) :
+	m_stream(stream),
+	m_noTexture(std::make_unique<ReplayRenderable>())
+{
+	const uint32_t white = 0xffffffff;
+
+	for (uint16_t id = 0; id < m_stream.GetTextureCount(); ++id)
+	{
+		auto texture = std::make_unique<graphics::software::resource::SoftwareTextureImpl>();
+		texture->Initialize(1, 1, &white, sizeof(white));
+
+		auto renderable = std::make_unique<ReplayRenderable>();
+		renderable->texture = texture.get();
+
+		m_defaultTextures.push_back(std::move(texture));
+		m_renderables.push_back(std::move(renderable));
+	}
+
+	for (const DrawStream::FontDefinition& definition : m_stream.GetFonts())
+	{
+		m_fonts.push_back(std::make_unique<ReplayFontAtlas>(definition, GetRenderable(definition.texture)));
+	}
+}
+
+// defined here since proxies are incomplete types in header
+graphics::renderer::DrawStreamPlayer::~DrawStreamPlayer() = default;
+
+graphics::renderer::DrawStreamPlayer::ReplayRenderable& graphics::renderer::DrawStreamPlayer::GetRenderable(uint16_t textureId)
+{
+	return textureId < m_renderables.size() ? *m_renderables[textureId] : *m_noTexture;
+}
+
+void graphics::renderer::DrawStreamPlayer::SetTexture(uint16_t textureId, graphics::resource::ITexture* texture)
+{
+	if (textureId >= m_renderables.size())
+	{
+		LOGERROR("Invalid texture id for draw stream: " << textureId);
+		return;
+	}
+
+	// revert to default stand-in if null
+	m_renderables[textureId]->texture = texture ? texture : m_defaultTextures[textureId].get();
+}
+
+size_t graphics::renderer::DrawStreamPlayer::PlayFrame(graphics::renderer::IRenderer& renderer, size_t index)
+{
+	DrawStream::Reader reader = m_stream.GetFrame(index);
+	size_t drawCount = 0;
+
+	while (!reader.IsEnd())
+	{
+		switch (static_cast<DrawStream::Opcode>(reader.Read<uint8_t>()))
+		{
+		case DrawStream::Opcode::Begin:
+			renderer.Begin();
+			break;
+
+		case DrawStream::Opcode::End:
+			renderer.End();
+			break;
+
+		case DrawStream::Opcode::SetClipRegion:
+			renderer.SetClipRegion(reader.Read<math::geometry::RectF>());
+			break;
+
+		case DrawStream::Opcode::EnableClipping:
+			renderer.EnableClipping(reader.Read<uint8_t>() != 0);
+			break;
+
+		case DrawStream::Opcode::Draw:
+		{
+			auto pos = reader.ReadPosition();
+			auto size = reader.Read<spatial::SizeF>();
+			auto color = reader.Read<graphics::ColorF>();
+			auto rotation = reader.Read<float>();
+			renderer.Draw(pos, size, color, rotation);
+			++drawCount;
+			break;
+		}
+
+		case DrawStream::Opcode::DrawRenderable:
+		{
+			ReplayRenderable& renderable = GetRenderable(reader.Read<uint16_t>());
+			renderable.uv = reader.Read<math::geometry::RectF>();
+			auto pos = reader.ReadPosition();
+			auto size = reader.Read<spatial::SizeF>();
+			auto color = reader.Read<graphics::ColorF>();
+			auto rotation = reader.Read<float>();
+			renderer.DrawRenderable(renderable, pos, size, color, rotation);
+			++drawCount;
+			break;
+		}
+
+		case DrawStream::Opcode::DrawText:
+		{
+			const ReplayFontAtlas& font = *m_fonts.at(reader.Read<uint16_t>());
+			auto pos = reader.ReadPosition();
+			auto color = reader.Read<graphics::ColorF>();
+			auto length = reader.Read<uint32_t>();
+			std::string text(reinterpret_cast<const char*>(reader.ReadBytes(length)), length);
+			renderer.DrawText(font, text, pos, color);
+			drawCount += length;
+			break;
+		}
+
+		case DrawStream::Opcode::DrawChar:
+		{
+			const ReplayFontAtlas& font = *m_fonts.at(reader.Read<uint16_t>());
+			auto character = reader.Read<unsigned char>();
+			auto pos = reader.ReadPosition();
+			auto color = reader.Read<graphics::ColorF>();
+			auto rotation = reader.Read<float>();
+			renderer.DrawChar(font, character, pos, color, rotation);
+			++drawCount;
+			break;
+		}
+
+		default:
+			throw std::runtime_error("DrawStreamPlayer::PlayFrame - unknown opcode in draw stream.");
+		}
+	}
+
+	return drawCount;
+}
+
+size_t graphics::renderer::DrawStreamPlayer::Play(graphics::renderer::IRenderer& renderer)
+{
+	size_t drawCount = 0;
+	for (size_t i = 0; i < m_stream.GetFrameCount(); ++i)
+	{
+		drawCount += PlayFrame(renderer, i);
+	}
+	return drawCount;
+}
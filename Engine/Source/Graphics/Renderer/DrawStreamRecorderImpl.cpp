@@ -0,0 +1,326 @@
+#include <Graphics/Renderer/DrawStreamRecorderImpl.h>
+#include <Graphics/Resource/ITexture.h>
+#include <Cache/BindCache.h>
+
+graphics::renderer::DrawStreamRecorderImpl::DrawStreamRecorderImpl(graphics::renderer::DrawStream& stream, std::unique_ptr<graphics::renderer::IRenderer> inner) :
+	m_stream(stream),
+	m_inner(std::move(inner))
+{
+}
+
+std::string graphics::renderer::DrawStreamRecorderImpl::GetTypeName() const
+{
+	return TypeName;
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::ShutDown()
+{
+	if (m_inner)
+	{
+		m_inner->ShutDown();
+	}
+}
+
+bool graphics::renderer::DrawStreamRecorderImpl::Initialize()
+{
+	return m_inner ? m_inner->Initialize() : true;
+}
+
+graphics::renderer::RenderStatistics graphics::renderer::DrawStreamRecorderImpl::GetStatistics() const
+{
+	return m_inner ? m_inner->GetStatistics() : graphics::renderer::RenderStatistics{};
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::Begin()
+{
+	if (m_inner)
+	{
+		m_inner->Begin();
+	}
+
+	m_recording = m_recordingRequested;
+	if (!m_recording)
+	{
+		return;
+	}
+
+	m_stream.BeginFrame();
+	m_stream.WriteOpcode(DrawStream::Opcode::Begin);
+	m_stream.WriteOpcode(DrawStream::Opcode::SetClipRegion);
+	m_stream.Write(m_clipRegion);
+	m_stream.WriteOpcode(DrawStream::Opcode::EnableClipping);
+	m_stream.Write(static_cast<uint8_t>(m_clippingEnabled ? 1 : 0));
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::End()
+{
+	if (m_inner)
+	{
+		m_inner->End();
+	}
+
+	if (!m_recording)
+	{
+		return;
+	}
+
+	m_stream.WriteOpcode(DrawStream::Opcode::End);
+	m_stream.EndFrame();
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::SetClipRegion(const math::geometry::RectF& region)
+{
+	if (m_inner)
+	{
+		m_inner->SetClipRegion(region);
+	}
+	m_clipRegion = region;
+
+	if (!m_recording)
+	{
+		return;
+	}
+
+	m_stream.WriteOpcode(DrawStream::Opcode::SetClipRegion);
+	m_stream.Write(region);
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::EnableClipping(const bool enable)
+{
+	if (m_inner)
+	{
+		m_inner->EnableClipping(enable);
+	}
+	m_clippingEnabled = enable;
+
+	if (!m_recording)
+	{
+		return;
+	}
+
+	m_stream.WriteOpcode(DrawStream::Opcode::EnableClipping);
+	m_stream.Write(static_cast<uint8_t>(enable ? 1 : 0));
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::Draw(
+	const spatial::PositionF pos,
+	const spatial::SizeF size,
+	const graphics::ColorF color,
+	const float rotation
+)
+{
+	if (m_inner)
+	{
+		m_inner->Draw(pos, size, color, rotation);
+	}
+
+	if (!m_recording)
+	{
+		return;
+	}
+
+	m_stream.WriteOpcode(DrawStream::Opcode::Draw);
+	m_stream.Write(pos);
+	m_stream.Write(size);
+	m_stream.Write(color);
+	m_stream.Write(rotation);
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::DrawText(
+	const graphics::renderable::IFontAtlas& font,
+	std::string_view text,
+	const spatial::PositionF pos,
+	const graphics::ColorF color
+)
+{
+	if (m_inner)
+	{
+		m_inner->DrawText(font, text, pos, color);
+	}
+
+	if (!m_recording)
+	{
+		return;
+	}
+
+	// text is stored as is. the player lays it out again using the font snapshot, same as the backends do
+	uint16_t fontId = GetFontId(font);
+	uint32_t length = static_cast<uint32_t>(text.size());
+
+	m_stream.WriteOpcode(DrawStream::Opcode::DrawText);
+	m_stream.Write(fontId);
+	m_stream.Write(pos);
+	m_stream.Write(color);
+	m_stream.Write(length);
+	m_stream.WriteBytes(text.data(), text.size());
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::DrawChar(
+	const graphics::renderable::IFontAtlas& font,
+	const unsigned char character,
+	const spatial::PositionF pos,
+	const graphics::ColorF color,
+	const float rotation
+)
+{
+	if (m_inner)
+	{
+		m_inner->DrawChar(font, character, pos, color, rotation);
+	}
+
+	if (!m_recording)
+	{
+		return;
+	}
+
+	uint16_t fontId = GetFontId(font);
+
+	m_stream.WriteOpcode(DrawStream::Opcode::DrawChar);
+	m_stream.Write(fontId);
+	m_stream.Write(character);
+	m_stream.Write(pos);
+	m_stream.Write(color);
+	m_stream.Write(rotation);
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::DrawRenderable(
+	const graphics::renderable::IRenderable& renderable,
+	const spatial::PositionF pos,
+	const spatial::SizeF size,
+	const graphics::ColorF color,
+	const float rotation
+)
+{
+	if (m_inner)
+	{
+		m_inner->DrawRenderable(renderable, pos, size, color, rotation);
+	}
+
+	if (!m_recording)
+	{
+		return;
+	}
+
+	uint16_t textureId = GetTextureId(renderable);
+	math::geometry::RectF uv = renderable.GetUVRect();
+
+	m_stream.WriteOpcode(DrawStream::Opcode::DrawRenderable);
+	m_stream.Write(textureId);
+	m_stream.Write(uv);
+	m_stream.Write(pos);
+	m_stream.Write(size);
+	m_stream.Write(color);
+	m_stream.Write(rotation);
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::DrawInstances(
+	const graphics::renderable::IRenderable& renderable,
+	const graphics::renderer::SpriteInstance* instances,
+	const size_t count,
+	const spatial::PositionF offset,
+	const graphics::ColorF color
+)
+{
+	if (m_inner)
+	{
+		m_inner->DrawInstances(renderable, instances, count, offset, color);
+	}
+
+	RecordInstances(renderable, instances, count, offset, color);
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::DrawRetained(
+	const graphics::renderable::IRenderable& renderable,
+	const graphics::renderer::SpriteInstance* instances,
+	const size_t count,
+	const spatial::PositionF offset,
+	const graphics::ColorF color,
+	const uint64_t id,
+	const uint64_t version
+)
+{
+	if (m_inner)
+	{
+		m_inner->DrawRetained(renderable, instances, count, offset, color, id, version);
+	}
+
+	// a replayed frame has to stand on its own, so retained spans are written out in full every frame
+	RecordInstances(renderable, instances, count, offset, color);
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::ReleaseRetained(const uint64_t id)
+{
+	if (m_inner)
+	{
+		m_inner->ReleaseRetained(id);
+	}
+}
+
+void graphics::renderer::DrawStreamRecorderImpl::RecordInstances(
+	const graphics::renderable::IRenderable& renderable,
+	const graphics::renderer::SpriteInstance* instances,
+	const size_t count,
+	const spatial::PositionF offset,
+	const graphics::ColorF color
+)
+{
+	if (!m_recording)
+	{
+		return;
+	}
+
+	// stream has no span opcode. every instance is recorded as a renderable draw so the player stays simple
+	uint16_t textureId = GetTextureId(renderable);
+	const float rotation = 0.0f;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const SpriteInstance& instance = instances[i];
+		spatial::PositionF pos(offset.x + instance.x, offset.y + instance.y);
+		spatial::SizeF size = { instance.width, instance.height };
+
+		m_stream.WriteOpcode(DrawStream::Opcode::DrawRenderable);
+		m_stream.Write(textureId);
+		m_stream.Write(instance.uv);
+		m_stream.Write(pos);
+		m_stream.Write(size);
+		m_stream.Write(color);
+		m_stream.Write(rotation);
+	}
+}
+
+uint16_t graphics::renderer::DrawStreamRecorderImpl::GetTextureId(const graphics::renderable::IRenderable& renderable)
+{
+	// inner renderer would have bound it already. if there is none, we bind it ourselves
+	if (renderable.CanBind())
+	{
+		renderable.Bind();
+	}
+
+	return m_stream.GetTextureId(cache::BindCache<graphics::resource::ITexture>::Instance().Get());
+}
+
+uint16_t graphics::renderer::DrawStreamRecorderImpl::GetFontId(const graphics::renderable::IFontAtlas& font)
+{
+	uint16_t id = m_stream.FindFontId(&font);
+	if (id != DrawStream::NoTexture)
+	{
+		return id;
+	}
+
+	DrawStream::FontDefinition definition;
+	definition.texture = GetTextureId(font);
+	definition.atlasSize = font.GetSize();
+
+	for (size_t i = 0; i < DrawStream::GlyphCount; ++i)
+	{
+		unsigned char c = static_cast<unsigned char>(DrawStream::FirstGlyph + i);
+		math::geometry::RectF& uv = definition.uv[i];
+		if (font.GetNormalizedTexCoord(c, uv.left, uv.top, uv.right, uv.bottom))
+		{
+			definition.size[i] = { font.GetWidth(c), font.GetHeight(c) };
+		}
+	}
+
+	return m_stream.AddFont(&font, definition);
+}
@@ -34,6 +34,11 @@ void graphics::renderer::Renderer::End()
     impl->End();
 }
 
+graphics::renderer::RenderStatistics graphics::renderer::Renderer::GetStatistics() const
+{
+    return impl->GetStatistics();
+}
+
 void graphics::renderer::Renderer::SetClipRegion(const math::geometry::RectF& region)
 {
 	impl->SetClipRegion(region);
@@ -58,7 +63,7 @@ void graphics::renderer::Renderer::Draw(
 // Draws a string using a font atlas at the specified position and color
 void graphics::renderer::Renderer::DrawText(
     const graphics::renderable::IFontAtlas& font, // Font atlas
-    const std::string& text,                    // Text to render
+    std::string_view text,                    // Text to render
     const spatial::PositionF pos,                                 // Top-left screen position
     const graphics::ColorF color
 )
@@ -89,3 +94,32 @@ void graphics::renderer::Renderer::DrawRenderable(
     impl->DrawRenderable(renderable, pos, size, color, rotation);
 }
 
+void graphics::renderer::Renderer::DrawInstances(
+    const graphics::renderable::IRenderable& renderable,                    // renderable that binds the texture
+    const SpriteInstance* instances,                                        // quads to draw
+    const size_t count,                                                     // number of quads
+    const spatial::PositionF offset,                                        // added to every quad position
+    const graphics::ColorF color                                            // RGBA color tint
+)
+{
+    impl->DrawInstances(renderable, instances, count, offset, color);
+}
+
+void graphics::renderer::Renderer::DrawRetained(
+    const graphics::renderable::IRenderable& renderable,                    // renderable that binds the texture
+    const SpriteInstance* instances,                                        // quads to draw
+    const size_t count,                                                     // number of quads
+    const spatial::PositionF offset,                                        // added to every quad position
+    const graphics::ColorF color,                                           // RGBA color tint
+    const uint64_t id,                                                      // span identity
+    const uint64_t version                                                  // changes when instances change
+)
+{
+    impl->DrawRetained(renderable, instances, count, offset, color, id, version);
+}
+
+void graphics::renderer::Renderer::ReleaseRetained(const uint64_t id)
+{
+    impl->ReleaseRetained(id);
+}
+
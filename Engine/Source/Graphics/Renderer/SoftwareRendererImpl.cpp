@@ -0,0 +1,492 @@
+#include <Graphics/Renderer/SoftwareRendererImpl.h>
+#include <Graphics/Renderable/IFontAtlas.h>
+#include <Cache/BindCache.h>
+#include <Utilities/Logger.h>
+#include <Performance/Profiler.h>
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define SOFTWARERENDERER_USESSE2 1
+#include <emmintrin.h>
+#else
+#define SOFTWARERENDERER_USESSE2 0
+#endif
+
+#pragma region // pixel math
+namespace
+{
+	// pixels are unpacked into 4 floats (r, g, b, a) in 0..1 range. with SSE2, one pixel is one register
+#if SOFTWARERENDERER_USESSE2
+	using Pixel = __m128;
+
+	inline Pixel MakePixel(float r, float g, float b, float a)
+	{
+		return _mm_setr_ps(r, g, b, a);
+	}
+
+	inline Pixel Unpack(uint32_t packed)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128i v = _mm_cvtsi32_si128(static_cast<int>(packed));
+		v = _mm_unpacklo_epi8(v, zero);
+		v = _mm_unpacklo_epi16(v, zero);
+		return _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(1.0f / 255.0f));
+	}
+
+	inline uint32_t Pack(Pixel p)
+	{
+		p = _mm_min_ps(_mm_max_ps(p, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		__m128i v = _mm_cvtps_epi32(_mm_mul_ps(p, _mm_set1_ps(255.0f)));
+		v = _mm_packs_epi32(v, v);
+		v = _mm_packus_epi16(v, v);
+		return static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+	}
+
+	inline Pixel Multiply(Pixel a, Pixel b)
+	{
+		return _mm_mul_ps(a, b);
+	}
+
+	// a + (b - a) * t
+	inline Pixel Lerp(Pixel a, Pixel b, float t)
+	{
+		return _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), _mm_set1_ps(t)));
+	}
+
+	// rgb = src * src.a + dst * (1 - src.a), alpha = dst.a
+	inline Pixel Blend(Pixel src, Pixel dst)
+	{
+		const __m128 rgbMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+		__m128 alpha = _mm_shuffle_ps(src, src, _MM_SHUFFLE(3, 3, 3, 3));
+		__m128 blended = _mm_add_ps(dst, _mm_mul_ps(_mm_sub_ps(src, dst), alpha));
+		return _mm_or_ps(_mm_and_ps(rgbMask, blended), _mm_andnot_ps(rgbMask, dst));
+	}
+#else
+	struct Pixel
+	{
+		float r, g, b, a;
+	};
+
+	inline Pixel MakePixel(float r, float g, float b, float a)
+	{
+		return Pixel{ r, g, b, a };
+	}
+
+	inline Pixel Unpack(uint32_t packed)
+	{
+		return Pixel
+		{
+			static_cast<float>(packed & 0xff) / 255.0f,
+			static_cast<float>((packed >> 8) & 0xff) / 255.0f,
+			static_cast<float>((packed >> 16) & 0xff) / 255.0f,
+			static_cast<float>((packed >> 24) & 0xff) / 255.0f
+		};
+	}
+
+	inline uint32_t Pack(Pixel p)
+	{
+		auto toByte = [](float c) -> uint32_t
+			{
+				return static_cast<uint32_t>(std::lround(std::clamp(c, 0.0f, 1.0f) * 255.0f));
+			};
+		return toByte(p.r) | (toByte(p.g) << 8) | (toByte(p.b) << 16) | (toByte(p.a) << 24);
+	}
+
+	inline Pixel Multiply(Pixel a, Pixel b)
+	{
+		return Pixel{ a.r * b.r, a.g * b.g, a.b * b.b, a.a * b.a };
+	}
+
+	inline Pixel Lerp(Pixel a, Pixel b, float t)
+	{
+		return Pixel{ a.r + (b.r - a.r) * t, a.g + (b.g - a.g) * t, a.b + (b.b - a.b) * t, a.a + (b.a - a.a) * t };
+	}
+
+	inline Pixel Blend(Pixel src, Pixel dst)
+	{
+		return Pixel{ dst.r + (src.r - dst.r) * src.a, dst.g + (src.g - dst.g) * src.a, dst.b + (src.b - dst.b) * src.a, dst.a };
+	}
+#endif
+
+	inline int Wrap(int i, int n)
+	{
+		i %= n;
+		return i < 0 ? i + n : i;
+	}
+
+	// bilinear sampling with wrap addressing. u, v are normalized texture coordinates
+	inline Pixel Sample(const graphics::software::resource::SoftwareTextureImpl& texture, float u, float v)
+	{
+		const int width = static_cast<int>(texture.GetWidth());
+		const int height = static_cast<int>(texture.GetHeight());
+		const uint32_t* pixels = texture.GetPixels();
+
+		// texel centers are at half pixel
+		float fx = u * width - 0.5f;
+		float fy = v * height - 0.5f;
+		float x0f = std::floor(fx);
+		float y0f = std::floor(fy);
+		float tx = fx - x0f;
+		float ty = fy - y0f;
+
+		int x0 = Wrap(static_cast<int>(x0f), width);
+		int y0 = Wrap(static_cast<int>(y0f), height);
+		int x1 = Wrap(x0 + 1, width);
+		int y1 = Wrap(y0 + 1, height);
+
+		Pixel top = Lerp(Unpack(pixels[y0 * width + x0]), Unpack(pixels[y0 * width + x1]), tx);
+		Pixel bottom = Lerp(Unpack(pixels[y1 * width + x0]), Unpack(pixels[y1 * width + x1]), tx);
+		return Lerp(top, bottom, ty);
+	}
+}
+#pragma endregion
+
+#pragma region // renderer::SoftwareRendererImpl
+graphics::software::renderer::SoftwareRendererImpl::SoftwareRendererImpl(unsigned int width, unsigned int height) :
+	m_width(width),
+	m_height(height)
+{
+}
+
+std::string graphics::software::renderer::SoftwareRendererImpl::GetTypeName() const
+{
+	return TypeName;
+}
+
+void graphics::software::renderer::SoftwareRendererImpl::ShutDown()
+{
+	m_renderTarget.Reset();
+	m_lastBoundTexture = nullptr;
+	m_boundTexture = nullptr;
+	m_batch.Reset();
+}
+
+bool graphics::software::renderer::SoftwareRendererImpl::Initialize()
+{
+	ShutDown();
+
+	if (!m_renderTarget.Initialize(m_width, m_height))
+	{
+		LOGERROR("Failed to create render target for software renderer.");
+		return false;
+	}
+
+	return true;
+}
+
+void graphics::software::renderer::SoftwareRendererImpl::Begin()
+{
+	m_batch.Reset();
+	m_statistics = {};
+}
+
+void graphics::software::renderer::SoftwareRendererImpl::End()
+{
+	Flush(graphics::renderer::FlushCause::End);
+}
+
+void graphics::software::renderer::SoftwareRendererImpl::SetClipRegion(const math::geometry::RectF& region)
+{
+	m_statistics.RecordClipRegion(m_batch.GetCurrentClipRegion(), region);
+	m_batch.SetClipRegion(region);
+}
+
+void graphics::software::renderer::SoftwareRendererImpl::EnableClipping(const bool enable)
+{
+	m_statistics.RecordClipping(m_batch.IsClippingEnabled(), enable);
+	m_batch.EnableClipping(enable);
+}
+
+void graphics::software::renderer::SoftwareRendererImpl::Flush(const graphics::renderer::FlushCause cause)
+{
+	PROFILE_SCOPE("SoftwareRendererImpl::Flush");
+
+	if (!m_batch.HasPending())
+	{
+		return;
+	}
+
+	// all pending draw requests use the texture that is bound now
+	const graphics::software::resource::SoftwareTextureImpl* texture = GetBoundTexture();
+	graphics::renderer::SpriteBatchBuilder::Span span = m_batch.GetPending();
+
+	const float* x = m_batch.GetX();
+	const float* y = m_batch.GetY();
+	const float* width = m_batch.GetWidth();
+	const float* height = m_batch.GetHeight();
+	const float* rotation = m_batch.GetRotation();
+	const float* u = m_batch.GetU();
+	const float* v = m_batch.GetV();
+	const float* uScale = m_batch.GetUScale();
+	const float* vScale = m_batch.GetVScale();
+	const float* red = m_batch.GetRed();
+	const float* green = m_batch.GetGreen();
+	const float* blue = m_batch.GetBlue();
+	const float* alpha = m_batch.GetAlpha();
+	const uint8_t* flags = m_batch.GetFlags();
+	const uint16_t* clipIndex = m_batch.GetClipIndex();
+
+	for (size_t i = span.first; i < span.first + span.count; ++i)
+	{
+		const bool textured = (flags[i] & graphics::renderer::SpriteBatchBuilder::Textured) != 0;
+		const bool clipped = (flags[i] & graphics::renderer::SpriteBatchBuilder::Clipped) != 0;
+
+		RasterizeQuad(
+			{ x[i], y[i] },
+			{ width[i], height[i] },
+			{ red[i], green[i], blue[i], alpha[i] },
+			rotation[i],
+			textured ? texture : nullptr,
+			{ u[i], v[i], u[i] + uScale[i], v[i] + vScale[i] },
+			clipped ? &m_batch.GetClipRegion(clipIndex[i]) : nullptr
+		);
+	}
+
+	m_statistics.RecordFlush(cause, span.count, 0);
+	m_batch.MarkSubmitted();
+}
+
+void graphics::software::renderer::SoftwareRendererImpl::Resize(unsigned int width, unsigned int height)
+{
+	m_width = width;
+	m_height = height;
+
+	if (!m_renderTarget.Initialize(m_width, m_height))
+	{
+		LOGERROR("Failed to resize render target for software renderer.");
+	}
+}
+
+void graphics::software::renderer::SoftwareRendererImpl::Clear(const graphics::ColorF& color)
+{
+	m_renderTarget.Clear(color.red, color.green, color.blue, color.alpha);
+}
+
+const graphics::software::resource::SoftwareTextureImpl* graphics::software::renderer::SoftwareRendererImpl::GetBoundTexture()
+{
+	graphics::resource::ITexture* bound = cache::BindCache<graphics::resource::ITexture>::Instance().Get();
+	if (bound != m_lastBoundTexture)
+	{
+		m_lastBoundTexture = bound;
+		m_boundTexture = dynamic_cast<const graphics::software::resource::SoftwareTextureImpl*>(bound);
+		if (bound && !m_boundTexture)
+		{
+			LOGERROR("Bound texture is not a software texture. Software renderer can only sample " << graphics::software::resource::SoftwareTextureImpl::TypeName << " textures. Bound texture type: " << bound->GetTypeName());
+		}
+	}
+	return m_boundTexture;
+}
+
+void graphics::software::renderer::SoftwareRendererImpl::Draw(
+	const spatial::PositionF pos,
+	const spatial::SizeF size,
+	const graphics::ColorF color,
+	const float rotation
+)
+{
+	m_batch.Add(pos, size, math::geometry::RectF{ 0, 0, 1, 1 }, color, rotation, false);
+}
+
+// Draws a string using a font atlas at the specified position and color
+void graphics::software::renderer::SoftwareRendererImpl::DrawText(
+	const graphics::renderable::IFontAtlas& font, // Font atlas
+	std::string_view text,                    // Text to render
+	const spatial::PositionF pos,                                 // Top-left screen position
+	const graphics::ColorF color                                   // RGBA color tint
+)
+{
+	// laid out once per string by the font. one bind and one span of quads instead of a lookup per char
+	if (const graphics::text::TextLayout* layout = font.GetTextLayout(text))
+	{
+		DrawInstances(font, layout->quads.data(), layout->quads.size(), pos, color);
+		return;
+	}
+
+	float xCurr = pos.x;
+	for (unsigned char c : text)
+	{
+		spatial::PositionF _pos = { xCurr, pos.y };
+		// draw the char
+		DrawChar(font, c, _pos, color, 0);
+
+		xCurr += font.GetWidth(c);
+	}
+}
+
+// Draws a single character using a font atlas with color and rotation
+void graphics::software::renderer::SoftwareRendererImpl::DrawChar(
+	const graphics::renderable::IFontAtlas& font, // Font atlas
+	const unsigned char character,            // Character to render
+	const spatial::PositionF pos,                                 // Top-left screen position
+	const graphics::ColorF color,                                   // RGBA color tint
+	const float rotation                      // Rotation in radians
+)
+{
+	math::geometry::RectF uv{};
+	if (!font.GetNormalizedTexCoord(character, uv.left, uv.top, uv.right, uv.bottom))
+	{
+		return;
+	}
+
+	// check if we need to bind texture. if current bound texture is same as what is needed for this draw call, then no need to bind this
+	const bool bind = font.CanBind();
+	m_statistics.RecordBind(bind);
+	if (bind)
+	{
+		// pending draw requests belong to the previous texture
+		Flush(graphics::renderer::FlushCause::Texture);
+		font.Bind();
+	}
+
+	m_batch.Add(pos, { font.GetWidth(character), font.GetHeight(character) }, uv, color, rotation, true);
+}
+
+void graphics::software::renderer::SoftwareRendererImpl::DrawRenderable(
+	const graphics::renderable::IRenderable& renderable,
+	const spatial::PositionF pos,
+	const spatial::SizeF size,
+	const graphics::ColorF color,
+	const float rotation
+)
+{
+	// check if we need to bind texture. if current bound texture is same as what is needed for this draw call, then no need to bind this
+	const bool bind = renderable.CanBind();
+	m_statistics.RecordBind(bind);
+	if (bind)
+	{
+		// pending draw requests belong to the previous texture
+		Flush(graphics::renderer::FlushCause::Texture);
+		renderable.Bind();
+	}
+
+	m_batch.Add(pos, size, renderable.GetUVRect(), color, rotation, true);
+}
+
+void graphics::software::renderer::SoftwareRendererImpl::DrawInstances(
+	const graphics::renderable::IRenderable& renderable,
+	const graphics::renderer::SpriteInstance* instances,
+	const size_t count,
+	const spatial::PositionF offset,
+	const graphics::ColorF color
+)
+{
+	// same as DrawRenderable but texture is checked once for the whole span
+	const bool bind = renderable.CanBind();
+	m_statistics.RecordBind(bind);
+	if (bind)
+	{
+		// pending draw requests belong to the previous texture
+		Flush(graphics::renderer::FlushCause::Texture);
+		renderable.Bind();
+	}
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		const graphics::renderer::SpriteInstance& instance = instances[i];
+		m_batch.Add({ offset.x + instance.x, offset.y + instance.y }, { instance.width, instance.height }, instance.uv, color, 0.0f, true);
+	}
+}
+
+void graphics::software::renderer::SoftwareRendererImpl::RasterizeQuad(
+	const spatial::PositionF pos,
+	const spatial::SizeF size,
+	const graphics::ColorF color,
+	const float rotation,
+	const graphics::software::resource::SoftwareTextureImpl* texture,
+	const math::geometry::RectF& uvRect,
+	const math::geometry::RectF* clip
+)
+{
+	if (size.width <= 0.0f || size.height <= 0.0f || m_renderTarget.GetPixels() == nullptr)
+	{
+		return;
+	}
+
+	// texture with no pixels cannot be sampled
+	if (texture && (texture->GetWidth() == 0 || texture->GetHeight() == 0))
+	{
+		texture = nullptr;
+	}
+
+#pragma region // calculate bounding box of the rotated quad in render target space
+	const float halfWidth = size.width * 0.5f;
+	const float halfHeight = size.height * 0.5f;
+	const float centerX = pos.x + halfWidth;
+	const float centerY = pos.y + halfHeight;
+	const float cosRot = std::cos(rotation);
+	const float sinRot = std::sin(rotation);
+
+	const float extentX = std::abs(cosRot) * halfWidth + std::abs(sinRot) * halfHeight;
+	const float extentY = std::abs(sinRot) * halfWidth + std::abs(cosRot) * halfHeight;
+
+	// pixel (x, y) is covered if its center (x + 0.5, y + 0.5) is inside the quad
+	float minX = std::ceil(centerX - extentX - 0.5f);
+	float minY = std::ceil(centerY - extentY - 0.5f);
+	float maxX = std::floor(centerX + extentX - 0.5f);
+	float maxY = std::floor(centerY + extentY - 0.5f);
+#pragma endregion
+
+#pragma region // clip against render target and clip region
+	minX = std::max(minX, 0.0f);
+	minY = std::max(minY, 0.0f);
+	maxX = std::min(maxX, static_cast<float>(m_renderTarget.GetWidth()) - 1.0f);
+	maxY = std::min(maxY, static_cast<float>(m_renderTarget.GetHeight()) - 1.0f);
+
+	// same as pixel shader, pixel is discarded if its center lies outside the clip region
+	if (clip)
+	{
+		minX = std::max(minX, std::ceil(clip->left - 0.5f));
+		minY = std::max(minY, std::ceil(clip->top - 0.5f));
+		maxX = std::min(maxX, std::floor(clip->right - 0.5f));
+		maxY = std::min(maxY, std::floor(clip->bottom - 0.5f));
+	}
+
+	if (minX > maxX || minY > maxY)
+	{
+		return;
+	}
+#pragma endregion
+
+	const Pixel tint = MakePixel(color.red, color.green, color.blue, color.alpha);
+	const float uvWidth = uvRect.right - uvRect.left;
+	const float uvHeight = uvRect.bottom - uvRect.top;
+	const unsigned int stride = m_renderTarget.GetWidth();
+	uint32_t* pixels = m_renderTarget.GetPixels();
+
+	const int x0 = static_cast<int>(minX);
+	const int x1 = static_cast<int>(maxX);
+	const int y0 = static_cast<int>(minY);
+	const int y1 = static_cast<int>(maxY);
+
+	for (int y = y0; y <= y1; ++y)
+	{
+		// map pixel center back into quad local space (inverse rotation). origin is the quad center
+		// local coordinates are linear in x so we step them incrementally across the row
+		const float offsetX = (x0 + 0.5f) - centerX;
+		const float offsetY = (y + 0.5f) - centerY;
+		float localX = cosRot * offsetX - sinRot * offsetY;
+		float localY = sinRot * offsetX + cosRot * offsetY;
+
+		uint32_t* dst = pixels + static_cast<size_t>(y) * stride;
+
+		for (int x = x0; x <= x1; ++x, localX += cosRot, localY += sinRot)
+		{
+			if (localX < -halfWidth || localX >= halfWidth || localY < -halfHeight || localY >= halfHeight)
+			{
+				continue;
+			}
+
+			Pixel src = tint;
+			if (texture)
+			{
+				float u = uvRect.left + (localX / size.width + 0.5f) * uvWidth;
+				float v = uvRect.top + (localY / size.height + 0.5f) * uvHeight;
+				src = Multiply(tint, Sample(*texture, u, v));
+			}
+
+			dst[x] = Pack(Blend(src, Unpack(dst[x])));
+		}
+	}
+}
+#pragma endregion
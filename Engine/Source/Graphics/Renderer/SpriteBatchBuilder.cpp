@@ -0,0 +1,94 @@
+#include <Graphics/Renderer/SpriteBatchBuilder.h>
+#include <Utilities/Logger.h>
+#include <limits>
+
+graphics::renderer::SpriteBatchBuilder::SpriteBatchBuilder(size_t initialCapacity)
+{
+	Resize(initialCapacity > 0 ? initialCapacity : 1);
+}
+
+void graphics::renderer::SpriteBatchBuilder::Resize(size_t capacity)
+{
+	m_capacity = capacity;
+
+	m_x.resize(m_capacity);
+	m_y.resize(m_capacity);
+	m_width.resize(m_capacity);
+	m_height.resize(m_capacity);
+	m_rotation.resize(m_capacity);
+	m_u.resize(m_capacity);
+	m_v.resize(m_capacity);
+	m_uScale.resize(m_capacity);
+	m_vScale.resize(m_capacity);
+	m_red.resize(m_capacity);
+	m_green.resize(m_capacity);
+	m_blue.resize(m_capacity);
+	m_alpha.resize(m_capacity);
+	m_flags.resize(m_capacity);
+	m_clipIndex.resize(m_capacity);
+}
+
+void graphics::renderer::SpriteBatchBuilder::Reset()
+{
+	m_count = 0;
+	m_submitted = 0;
+	m_clipRegions.clear();
+	m_clipRegionChanged = true;
+}
+
+void graphics::renderer::SpriteBatchBuilder::SetClipRegion(const math::geometry::RectF& region)
+{
+	m_clipRegion = region;
+	m_clipRegionChanged = true;
+}
+
+void graphics::renderer::SpriteBatchBuilder::EnableClipping(const bool enable)
+{
+	m_clippingEnabled = enable;
+}
+
+void graphics::renderer::SpriteBatchBuilder::Add(
+	const spatial::PositionF pos,
+	const spatial::SizeF size,
+	const math::geometry::RectF& uv,
+	const graphics::ColorF color,
+	const float rotation,
+	const bool textured
+)
+{
+	if (m_count == m_capacity)
+	{
+		Resize(m_capacity * 2);
+	}
+
+	// only add clip region to table if it is used by an instance
+	if (m_clippingEnabled && m_clipRegionChanged)
+	{
+		if (m_clipRegions.size() > std::numeric_limits<uint16_t>::max())
+		{
+			LOGERROR("Too many clip regions in one sprite batch frame. Reusing last one.");
+		}
+		else
+		{
+			m_clipRegions.push_back(m_clipRegion);
+		}
+		m_clipRegionChanged = false;
+	}
+
+	const size_t i = m_count++;
+	m_x[i] = pos.x;
+	m_y[i] = pos.y;
+	m_width[i] = size.width;
+	m_height[i] = size.height;
+	m_rotation[i] = rotation;
+	m_u[i] = uv.left;
+	m_v[i] = uv.top;
+	m_uScale[i] = uv.right - uv.left;
+	m_vScale[i] = uv.bottom - uv.top;
+	m_red[i] = color.red;
+	m_green[i] = color.green;
+	m_blue[i] = color.blue;
+	m_alpha[i] = color.alpha;
+	m_flags[i] = static_cast<uint8_t>((textured ? Textured : None) | (m_clippingEnabled ? Clipped : None));
+	m_clipIndex[i] = m_clippingEnabled ? static_cast<uint16_t>(m_clipRegions.size() - 1) : 0;
+}
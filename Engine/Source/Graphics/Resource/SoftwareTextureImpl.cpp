@@ -0,0 +1,117 @@
+#include <Graphics/Resource/SoftwareTextureImpl.h>
+#include <Graphics/IO/BitmapFileHelper.h>
+#include <Cache/BindCache.h>
+#include <Utilities/Logger.h>
+#include <algorithm>
+#include <cstring>
+
+std::string graphics::software::resource::SoftwareTextureImpl::GetTypeName() const
+{
+	return TypeName;
+}
+
+bool graphics::software::resource::SoftwareTextureImpl::Initialize(unsigned int width, unsigned int height, const void* srcData, unsigned int bytesPerRow)
+{
+	if (!srcData || width == 0 || height == 0 || bytesPerRow < width * sizeof(uint32_t))
+	{
+		LOGERROR("Failed to create texture. Invalid source data.");
+		return false;
+	}
+
+	m_width = width;
+	m_height = height;
+	m_pixels.resize(static_cast<size_t>(width) * height);
+
+	// source rows may be padded so copy row by row
+	const uint8_t* src = static_cast<const uint8_t*>(srcData);
+	for (unsigned int row = 0; row < height; ++row)
+	{
+		std::memcpy(m_pixels.data() + static_cast<size_t>(row) * width, src + static_cast<size_t>(row) * bytesPerRow, width * sizeof(uint32_t));
+	}
+
+	return true;
+}
+
+bool graphics::software::resource::SoftwareTextureImpl::Initialize(unsigned int width, unsigned int height)
+{
+	if (width == 0 || height == 0)
+	{
+		LOGERROR("Failed to create texture. Invalid size.");
+		return false;
+	}
+
+	m_width = width;
+	m_height = height;
+	m_pixels.assign(static_cast<size_t>(width) * height, 0);
+
+	return true;
+}
+
+bool graphics::software::resource::SoftwareTextureImpl::Initialize(const wchar_t* fileNamePath)
+{
+	if (!graphics::imageio::bmp::LoadFromFile(fileNamePath, m_width, m_height, m_pixels))
+	{
+		LOGERROR("Failed to create texture.");
+		return false;
+	}
+
+	return true;
+}
+
+bool graphics::software::resource::SoftwareTextureImpl::CanBind()
+{
+	return cache::BindCache<graphics::resource::ITexture>::Instance().CanBind(this, false);
+}
+
+void graphics::software::resource::SoftwareTextureImpl::Bind()
+{
+	// nothing to do on the API side. the software renderer reads the bound texture from bind cache
+	cache::BindCache<graphics::resource::ITexture>::Instance().Bind(this, false);
+}
+
+void graphics::software::resource::SoftwareTextureImpl::BeginDraw()
+{
+}
+
+void graphics::software::resource::SoftwareTextureImpl::Clear(float red, float green, float blue, float alpha)
+{
+	auto toByte = [](float c) -> uint32_t
+		{
+			return static_cast<uint32_t>(std::clamp(c, 0.0f, 1.0f) * 255.0f + 0.5f);
+		};
+
+	uint32_t color = toByte(red) | (toByte(green) << 8) | (toByte(blue) << 16) | (toByte(alpha) << 24);
+	std::fill(m_pixels.begin(), m_pixels.end(), color);
+}
+
+void graphics::software::resource::SoftwareTextureImpl::EndDraw()
+{
+}
+
+const unsigned int graphics::software::resource::SoftwareTextureImpl::GetWidth() const
+{
+	return m_width;
+}
+
+const unsigned int graphics::software::resource::SoftwareTextureImpl::GetHeight() const
+{
+	return m_height;
+}
+
+void graphics::software::resource::SoftwareTextureImpl::Reset()
+{
+	m_pixels.clear();
+	m_pixels.shrink_to_fit();
+	m_width = 0;
+	m_height = 0;
+}
+
+bool graphics::software::resource::SoftwareTextureImpl::SaveToFile(const wchar_t* filename)
+{
+	if (!graphics::imageio::bmp::SaveToFile(filename, m_width, m_height, m_pixels.data()))
+	{
+		LOGERROR("Failed to save texture.");
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,339 @@
+#include <Job/JobSystem.h>
+#include <Performance/Profiler.h>
+
+namespace
+{
+	// queue of the calling thread in the system it belongs to. threads outside a system use queue 0
+	thread_local const job::JobSystem* t_system = nullptr;
+	thread_local size_t t_queue = 0;
+}
+
+job::JobSystem::~JobSystem()
+{
+	Stop();
+}
+
+void job::JobSystem::Start(int workerCount)
+{
+	if (m_running.load())
+	{
+		return;
+	}
+
+	size_t count;
+	if (workerCount < 0)
+	{
+		unsigned int cores = std::thread::hardware_concurrency();
+		count = cores > 1 ? cores - 1 : 0;
+	}
+	else
+	{
+		count = static_cast<size_t>(workerCount);
+	}
+
+	m_queues.clear();
+	for (size_t i = 0; i < count + 1; ++i)
+	{
+		m_queues.push_back(std::make_unique<WorkQueue>());
+	}
+
+	t_system = this;
+	t_queue = 0;
+
+	m_running.store(true);
+	for (size_t i = 1; i <= count; ++i)
+	{
+		m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+}
+
+void job::JobSystem::Stop()
+{
+	if (!m_running.load())
+	{
+		return;
+	}
+
+	// drain what is queued on this thread, workers drain the rest before they see the stop
+	while (Job* job = Next(0))
+	{
+		Execute(job);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_running.store(false);
+	}
+	m_wakeCondition.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+	m_workers.clear();
+	m_queues.clear();
+
+	if (t_system == this)
+	{
+		t_system = nullptr;
+	}
+}
+
+size_t job::JobSystem::QueueIndex() const
+{
+	return t_system == this ? t_queue : 0;
+}
+
+job::Job* job::JobSystem::Allocate()
+{
+	std::lock_guard<std::mutex> lock(m_poolMutex);
+	if (m_freeList)
+	{
+		Job* job = m_freeList;
+		m_freeList = job->nextFree;
+		return job;
+	}
+
+	m_pool.emplace_back();
+	return &m_pool.back();
+}
+
+void job::JobSystem::Release(Job* job)
+{
+	job->work = nullptr;
+	job->parent = nullptr;
+
+	// handles to this slot read as done from here on
+	job->generation.fetch_add(1);
+
+	std::lock_guard<std::mutex> lock(m_poolMutex);
+	job->nextFree = m_freeList;
+	m_freeList = job;
+}
+
+job::Job* job::JobSystem::Pop(size_t index)
+{
+	WorkQueue& queue = *m_queues[index];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.jobs.empty())
+	{
+		return nullptr;
+	}
+
+	Job* job = queue.jobs.back();
+	queue.jobs.pop_back();
+	return job;
+}
+
+job::Job* job::JobSystem::Steal(size_t index)
+{
+	// visit other queues starting after our own, so thieves spread over victims
+	for (size_t i = 1; i < m_queues.size(); ++i)
+	{
+		WorkQueue& queue = *m_queues[(index + i) % m_queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (!queue.jobs.empty())
+		{
+			Job* job = queue.jobs.front();
+			queue.jobs.pop_front();
+			return job;
+		}
+	}
+	return nullptr;
+}
+
+job::Job* job::JobSystem::Next(size_t index)
+{
+	if (m_queues.empty())
+	{
+		return nullptr;
+	}
+
+	Job* job = Pop(index);
+	if (!job)
+	{
+		job = Steal(index);
+	}
+	if (job)
+	{
+		m_pending.fetch_sub(1);
+	}
+	return job;
+}
+
+void job::JobSystem::Execute(Job* job)
+{
+	if (job->work)
+	{
+		PROFILE_SCOPE("Job");
+		job->work();
+	}
+	Finish(job);
+}
+
+void job::JobSystem::Finish(Job* job)
+{
+	if (job->unfinished.fetch_sub(1) != 1)
+	{
+		// children still running. last one to finish completes us
+		return;
+	}
+
+	if (job->continuation)
+	{
+		std::lock_guard<std::mutex> lock(m_continuationMutex);
+		m_continuations.push_back(std::move(job->continuation));
+		job->continuation = nullptr;
+	}
+
+	Job* parent = job->parent;
+	Release(job);
+
+	if (parent)
+	{
+		Finish(parent);
+	}
+}
+
+void job::JobSystem::WorkerLoop(size_t index)
+{
+	t_system = this;
+	t_queue = index;
+
+#if PROFILER_ENABLED
+	performance::Profiler::Instance().SetThreadName("worker " + std::to_string(index));
+#endif
+
+	for (;;)
+	{
+		if (Job* job = Next(index))
+		{
+			Execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		m_wakeCondition.wait(lock, [this]() { return m_pending.load() > 0 || !m_running.load(); });
+		if (!m_running.load() && m_pending.load() == 0)
+		{
+			return;
+		}
+	}
+}
+
+job::JobHandle job::JobSystem::Create(std::function<void()> work, JobHandle parent)
+{
+	Job* job = Allocate();
+	job->work = std::move(work);
+	job->continuation = nullptr;
+	job->unfinished.store(1);
+	job->parent = nullptr;
+
+	if (parent.IsValid() && parent.job->generation.load() == parent.generation)
+	{
+		parent.job->unfinished.fetch_add(1);
+		job->parent = parent.job;
+	}
+
+	return JobHandle{ job, job->generation.load() };
+}
+
+void job::JobSystem::OnComplete(JobHandle handle, std::function<void()> continuation)
+{
+	if (handle.IsValid() && handle.job->generation.load() == handle.generation)
+	{
+		handle.job->continuation = std::move(continuation);
+	}
+}
+
+void job::JobSystem::Submit(JobHandle handle)
+{
+	if (!handle.IsValid() || handle.job->generation.load() != handle.generation)
+	{
+		return;
+	}
+
+	if (m_workers.empty())
+	{
+		Execute(handle.job);
+		return;
+	}
+
+	{
+		WorkQueue& queue = *m_queues[QueueIndex()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(handle.job);
+	}
+
+	// pending goes up before the wake lock is taken, a worker checking it under the lock can't miss it
+	m_pending.fetch_add(1);
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+	}
+	m_wakeCondition.notify_one();
+}
+
+job::JobHandle job::JobSystem::Run(std::function<void()> work, JobHandle parent)
+{
+	JobHandle handle = Create(std::move(work), parent);
+	Submit(handle);
+	return handle;
+}
+
+job::JobHandle job::JobSystem::ParallelFor(size_t count, size_t batchSize, std::function<void(size_t, size_t)> work)
+{
+	if (batchSize == 0)
+	{
+		batchSize = 1;
+	}
+
+	// parent is only submitted after every batch is created, so it can't finish early
+	JobHandle parent = Create(nullptr);
+	auto shared = std::make_shared<std::function<void(size_t, size_t)>>(std::move(work));
+	for (size_t begin = 0; begin < count; begin += batchSize)
+	{
+		size_t end = begin + batchSize < count ? begin + batchSize : count;
+		Run([shared, begin, end]() { (*shared)(begin, end); }, parent);
+	}
+	Submit(parent);
+	return parent;
+}
+
+bool job::JobSystem::IsDone(JobHandle handle) const
+{
+	return !handle.IsValid() || handle.job->generation.load() != handle.generation;
+}
+
+void job::JobSystem::Wait(JobHandle handle)
+{
+	size_t index = QueueIndex();
+	while (!IsDone(handle))
+	{
+		if (Job* job = Next(index))
+		{
+			Execute(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+size_t job::JobSystem::RunContinuations()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_continuationMutex);
+		m_runningContinuations.swap(m_continuations);
+	}
+
+	// continuations may submit jobs whose continuations land in the other list, for next call
+	for (std::function<void()>& continuation : m_runningContinuations)
+	{
+		continuation();
+	}
+
+	size_t count = m_runningContinuations.size();
+	m_runningContinuations.clear();
+	return count;
+}
@@ -1,9 +1,15 @@
 #include <Performance/FrameRateMonitor.h>
 
-performance::FrameRateMonitor::FrameRateMonitor(float measureRange) :
+performance::FrameRateMonitor::FrameRateMonitor(float measureRange, size_t capacity, float resolution) :
 	m_measureRange(measureRange),
 	m_elapsedTimeAccumulator(0.0f),
-	m_elapsedTimes()
+	m_elapsedTimes(capacity > 0 ? capacity : 1),
+	m_head(0),
+	m_count(0),
+	m_resolution(resolution > 0.0f ? resolution : 0.00001f),
+	m_histogram(),
+	m_frameBudget(0.0f),
+	m_overBudget(0)
 {
 }
 
@@ -14,18 +20,18 @@ void performance::FrameRateMonitor::SetMeasureRange(float range)
 
 float performance::FrameRateMonitor::GetAverageFrameRate() const
 {
-	if (m_elapsedTimeAccumulator > 0.0f && !m_elapsedTimes.empty())
+	if (m_elapsedTimeAccumulator > 0.0f && m_count > 0)
 	{
-		return static_cast<float>(m_elapsedTimes.size()) / m_elapsedTimeAccumulator;
+		return static_cast<float>(m_count) / m_elapsedTimeAccumulator;
 	}
 	return 0;
 }
 
 float performance::FrameRateMonitor::GetLastFrameRate() const
 {
-	if (m_elapsedTimes.size() > 0)
+	if (m_count > 0)
 	{
-		float lastElapsed = m_elapsedTimes.back();
+		float lastElapsed = m_elapsedTimes[(m_head + m_count - 1) % m_elapsedTimes.size()];
 		if (lastElapsed > 0.0f)
 		{
 			return 1.0f / lastElapsed;
@@ -34,19 +40,161 @@ float performance::FrameRateMonitor::GetLastFrameRate() const
 	return 0;
 }
 
+void performance::FrameRateMonitor::SetFrameBudget(float budget)
+{
+	m_frameBudget = budget;
+
+	// recount window against new budget
+	m_overBudget = 0;
+	for (size_t i = 0; i < m_count; ++i)
+	{
+		if (m_frameBudget > 0.0f && m_elapsedTimes[(m_head + i) % m_elapsedTimes.size()] > m_frameBudget)
+		{
+			++m_overBudget;
+		}
+	}
+}
+
+// first 64 buckets are one resolution step each. after that each power of two is split in 32 buckets
+uint32_t performance::FrameRateMonitor::BucketOf(float elapsedTime) const
+{
+	float scaled = elapsedTime / m_resolution;
+	if (!(scaled > 0.0f))
+	{
+		return 0;
+	}
+
+	const float largest = static_cast<float>(uint64_t(1) << (Octaves + 5)) - 1.0f;
+	uint64_t value = static_cast<uint64_t>(scaled < largest ? scaled : largest);
+	if (value < LinearBuckets)
+	{
+		return static_cast<uint32_t>(value);
+	}
+
+	uint32_t msb = 0;
+	while ((value >> (msb + 1)) != 0)
+	{
+		++msb;
+	}
+
+	uint32_t shift = msb - 5;
+	uint32_t bucket = LinearBuckets + (shift - 1) * SubBuckets + static_cast<uint32_t>((value >> shift) - SubBuckets);
+	return bucket < BucketCount ? bucket : BucketCount - 1;
+}
+
+// middle of the range of values that fall in bucket
+float performance::FrameRateMonitor::BucketValue(uint32_t bucket) const
+{
+	if (bucket < LinearBuckets)
+	{
+		return (static_cast<float>(bucket) + 0.5f) * m_resolution;
+	}
+
+	uint32_t shift = (bucket - LinearBuckets) / SubBuckets + 1;
+	uint64_t mantissa = SubBuckets + (bucket - LinearBuckets) % SubBuckets;
+	float low = static_cast<float>(mantissa << shift);
+	float width = static_cast<float>(uint64_t(1) << shift);
+	return (low + width * 0.5f) * m_resolution;
+}
+
+void performance::FrameRateMonitor::Remove()
+{
+	float front = m_elapsedTimes[m_head];
+	m_head = (m_head + 1) % m_elapsedTimes.size();
+	--m_count;
+
+	m_elapsedTimeAccumulator -= front;
+	--m_histogram[BucketOf(front)];
+	if (m_frameBudget > 0.0f && front > m_frameBudget)
+	{
+		--m_overBudget;
+	}
+
+	// guard against negative accumulator due to floating point precision issues. make sure it stays zero or positive
+	if (m_elapsedTimeAccumulator < 0.0f || m_count == 0) m_elapsedTimeAccumulator = 0.0f;
+}
+
+float performance::FrameRateMonitor::GetMaxFrameTime() const
+{
+	float max = 0.0f;
+	for (size_t i = 0; i < m_count; ++i)
+	{
+		float elapsed = m_elapsedTimes[(m_head + i) % m_elapsedTimes.size()];
+		if (elapsed > max)
+		{
+			max = elapsed;
+		}
+	}
+	return max;
+}
+
+float performance::FrameRateMonitor::GetFrameTimePercentile(float percent, float max) const
+{
+	if (m_count == 0)
+	{
+		return 0.0f;
+	}
+
+	// rank of the frame at percent, 1 based
+	double rank = static_cast<double>(percent) / 100.0 * static_cast<double>(m_count);
+	uint64_t target = rank < 1.0 ? 1 : static_cast<uint64_t>(rank + 0.999999);
+
+	// bucket value is the middle of its range, the slowest frame may be below it. no frame is slower than max
+	uint64_t seen = 0;
+	for (uint32_t bucket = 0; bucket < BucketCount; ++bucket)
+	{
+		seen += m_histogram[bucket];
+		if (seen >= target)
+		{
+			float value = BucketValue(bucket);
+			return value > max ? max : value;
+		}
+	}
+	return max;
+}
+
+float performance::FrameRateMonitor::GetFrameTimePercentile(float percent) const
+{
+	return GetFrameTimePercentile(percent, GetMaxFrameTime());
+}
+
+performance::FrameTimeStatistics performance::FrameRateMonitor::GetFrameTimeStatistics() const
+{
+	FrameTimeStatistics statistics;
+	statistics.frames = m_count;
+	statistics.overBudget = m_overBudget;
+	if (m_count == 0)
+	{
+		return statistics;
+	}
+
+	statistics.max = GetMaxFrameTime();
+	statistics.p50 = GetFrameTimePercentile(50.0f, statistics.max);
+	statistics.p90 = GetFrameTimePercentile(90.0f, statistics.max);
+	statistics.p99 = GetFrameTimePercentile(99.0f, statistics.max);
+	return statistics;
+}
+
 // using "On" prefix to follow event handler naming convention since this method is used as event handler - it is called when a frame is completed
 void performance::FrameRateMonitor::OnFrameCompleted(float elapsedTime)
 {
-	m_elapsedTimes.push_back(elapsedTime);
-	m_elapsedTimeAccumulator += elapsedTime;
+	if (m_count == m_elapsedTimes.size())
+	{
+		Remove();
+	}
 
-	while (!m_elapsedTimes.empty() && m_elapsedTimeAccumulator > m_measureRange)
+	m_elapsedTimes[(m_head + m_count) % m_elapsedTimes.size()] = elapsedTime;
+	++m_count;
+	m_elapsedTimeAccumulator += elapsedTime;
+	++m_histogram[BucketOf(elapsedTime)];
+	if (m_frameBudget > 0.0f && elapsedTime > m_frameBudget)
 	{
-		float front = m_elapsedTimes.front();
-		m_elapsedTimes.pop_front();
-		m_elapsedTimeAccumulator -= front;
+		++m_overBudget;
+	}
 
-		// guard against negative accumulator due to floating point precision issues. make sure it stays zero or positive
-		if (m_elapsedTimeAccumulator < 0.0f) m_elapsedTimeAccumulator = 0.0f;
+	// newest frame always stays, a hitch longer than the whole range is the one frame percentiles must show
+	while (m_count > 1 && m_elapsedTimeAccumulator > m_measureRange)
+	{
+		Remove();
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,189 @@
+#include <Performance/Profiler.h>
+#include <Utilities/Logger.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+	// buffer of calling thread. buffers live as long as the profiler, so the pointer never dangles
+	thread_local void* t_buffer = nullptr;
+
+	void AppendEscaped(std::ostringstream& out, const std::string& text)
+	{
+		for (char c : text)
+		{
+			switch (c)
+			{
+			case '"': out << "\\\""; break;
+			case '\\': out << "\\\\"; break;
+			case '\n': out << "\\n"; break;
+			case '\t': out << "\\t"; break;
+			default:
+				if (static_cast<unsigned char>(c) >= 0x20)
+				{
+					out << c;
+				}
+				break;
+			}
+		}
+	}
+}
+
+performance::Profiler::ThreadBuffer& performance::Profiler::GetThreadBuffer()
+{
+	if (t_buffer)
+	{
+		return *static_cast<ThreadBuffer*>(t_buffer);
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto buffer = std::make_unique<ThreadBuffer>();
+	buffer->records.resize(m_capacity);
+	buffer->id = static_cast<uint32_t>(m_buffers.size() + 1);
+	buffer->name = "thread " + std::to_string(buffer->id);
+	t_buffer = buffer.get();
+	m_buffers.push_back(std::move(buffer));
+	return *m_buffers.back();
+}
+
+void performance::Profiler::SetThreadName(const std::string& name)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+	std::lock_guard<std::mutex> lock(m_mutex);
+	buffer.name = name;
+}
+
+void performance::Profiler::BeginCapture()
+{
+	if (m_capturing.load())
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (auto& buffer : m_buffers)
+	{
+		buffer->count.store(0, std::memory_order_relaxed);
+		buffer->dropped.store(0, std::memory_order_relaxed);
+	}
+	m_captureStart = Clock::now();
+	m_capturing.store(true);
+}
+
+void performance::Profiler::EndCapture()
+{
+	m_capturing.store(false);
+
+	// a writer that saw capturing before the store above may still be filling its slot
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (auto& buffer : m_buffers)
+	{
+		while (buffer->writing.load())
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+// single writer per buffer. writing flag and capture check are sequentially consistent, so EndCapture either sees
+// the flag and waits, or the writer sees capture ended and writes nothing
+void performance::Profiler::Write(ThreadBuffer& buffer, const char* name, Clock::time_point start, Clock::time_point end)
+{
+	uint32_t depth = --buffer.depth;
+
+	buffer.writing.store(true);
+	if (m_capturing.load())
+	{
+		size_t count = buffer.count.load(std::memory_order_relaxed);
+		if (count < buffer.records.size())
+		{
+			Record& record = buffer.records[count];
+			record.name = name;
+			// scopes opened before capture began are clamped to its start
+			record.start = start > m_captureStart ? std::chrono::duration_cast<std::chrono::nanoseconds>(start - m_captureStart).count() : 0;
+			record.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+			record.depth = depth;
+			buffer.count.store(count + 1, std::memory_order_release);
+		}
+		else
+		{
+			buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	buffer.writing.store(false);
+}
+
+size_t performance::Profiler::GetEventCount()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t count = 0;
+	for (auto& buffer : m_buffers)
+	{
+		count += buffer->count.load(std::memory_order_acquire);
+	}
+	return count;
+}
+
+size_t performance::Profiler::GetDroppedCount()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	size_t dropped = 0;
+	for (auto& buffer : m_buffers)
+	{
+		dropped += buffer->dropped.load(std::memory_order_relaxed);
+	}
+	return dropped;
+}
+
+std::string performance::Profiler::ExportChromeTrace()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	std::ostringstream out;
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool first = true;
+	for (auto& buffer : m_buffers)
+	{
+		size_t count = buffer->count.load(std::memory_order_acquire);
+		if (count == 0)
+		{
+			continue;
+		}
+
+		// thread name metadata
+		out << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id << ",\"args\":{\"name\":\"";
+		AppendEscaped(out, buffer->name);
+		out << "\"}}";
+		first = false;
+
+		// complete events, microseconds with fraction
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Record& record = buffer->records[i];
+			out << ",\n{\"name\":\"";
+			AppendEscaped(out, record.name ? record.name : "");
+			out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+				<< ",\"ts\":" << record.start / 1000 << "." << (record.start % 1000) / 100
+				<< ",\"dur\":" << record.duration / 1000 << "." << (record.duration % 1000) / 100
+				<< ",\"args\":{\"depth\":" << record.depth << "}}";
+		}
+	}
+
+	out << "\n]}\n";
+	return out.str();
+}
+
+bool performance::Profiler::SaveChromeTrace(const std::string& file)
+{
+	std::ofstream stream(file, std::ios::binary);
+	if (!stream)
+	{
+		LOGERROR("Failed to open profile trace file " << file);
+		return false;
+	}
+
+	stream << ExportChromeTrace();
+	return static_cast<bool>(stream);
+}
@@ -0,0 +1,51 @@
+#include <Timer/Clock.h>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define TIMER_HAS_TSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define TIMER_HAS_TSC 1
+#else
+#define TIMER_HAS_TSC 0
+#endif
+
+uint64_t timer::TscClock::ReadTicks()
+{
+#if TIMER_HAS_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+timer::TscClock::TscClock(std::chrono::milliseconds calibration)
+{
+	m_base = std::chrono::steady_clock::now();
+	m_baseTicks = ReadTicks();
+
+#if TIMER_HAS_TSC
+	// measure tick rate over the calibration window. longer window, smaller error
+	std::this_thread::sleep_for(calibration);
+	TimePoint end = std::chrono::steady_clock::now();
+	uint64_t endTicks = ReadTicks();
+
+	double nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - m_base).count());
+	if (endTicks > m_baseTicks && nanoseconds > 0.0)
+	{
+		m_nanosecondsPerTick = nanoseconds / static_cast<double>(endTicks - m_baseTicks);
+	}
+#endif
+}
+
+timer::IClock::TimePoint timer::TscClock::Now() const
+{
+	if (m_nanosecondsPerTick <= 0.0)
+	{
+		return std::chrono::steady_clock::now();
+	}
+
+	double nanoseconds = static_cast<double>(ReadTicks() - m_baseTicks) * m_nanosecondsPerTick;
+	return m_base + std::chrono::duration_cast<Duration>(std::chrono::duration<double, std::nano>(nanoseconds));
+}
@@ -0,0 +1,61 @@
+#include <Timer/FixedTimestep.h>
+#include <cmath>
+
+timer::FixedTimestep::FixedTimestep(float rate, size_t maxStepsPerUpdate) :
+	m_step(1.0f / (rate > 0.0f ? rate : 60.0f)),
+	m_maxStepsPerUpdate(maxStepsPerUpdate > 0 ? maxStepsPerUpdate : 1)
+{
+}
+
+size_t timer::FixedTimestep::Update(float delta)
+{
+	m_accumulator += delta;
+
+	size_t steps = 0;
+	while (m_accumulator >= m_step && steps < m_maxStepsPerUpdate)
+	{
+		m_accumulator -= m_step;
+		steps++;
+
+		StepEvent(m_step);
+	}
+
+	// over the cap. drop whole steps left, keep where we are within a step
+	if (m_accumulator >= m_step)
+	{
+		float dropped = std::floor(m_accumulator / m_step);
+		m_statistics.droppedSteps += static_cast<uint64_t>(dropped);
+		m_accumulator -= dropped * m_step;
+		if (m_accumulator >= m_step || m_accumulator < 0.0f)
+		{
+			// float rounding at the edge
+			m_accumulator = 0.0f;
+		}
+	}
+
+	m_alpha = m_accumulator / m_step;
+
+	m_statistics.steps += steps;
+	m_statistics.caughtUpSteps += steps > 1 ? steps - 1 : 0;
+	m_statistics.lastSteps = steps;
+	if (steps > m_statistics.maxSteps)
+	{
+		m_statistics.maxSteps = steps;
+	}
+
+	return steps;
+}
+
+void timer::FixedTimestep::Reset()
+{
+	m_accumulator = 0.0f;
+	m_alpha = 1.0f;
+}
+
+void timer::FixedTimestep::SetRate(float rate)
+{
+	if (rate > 0.0f)
+	{
+		m_step = 1.0f / rate;
+	}
+}
@@ -0,0 +1,83 @@
+#include <Timer/FramePacer.h>
+#include <algorithm>
+#include <thread>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#pragma comment(lib, "winmm.lib")
+#endif
+
+timer::FramePacer::FramePacer(Mode mode) :
+	m_mode(mode)
+{
+#ifdef _WIN32
+	// default timer resolution is ~15.6 ms, too coarse to sleep inside a frame
+	timeBeginPeriod(1);
+#endif
+}
+
+timer::FramePacer::~FramePacer()
+{
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+void timer::FramePacer::Schedule(float seconds)
+{
+	m_deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(std::max(seconds, 0.0f)));
+	m_hasDeadline = true;
+}
+
+void timer::FramePacer::Wait()
+{
+	if (m_mode == Mode::Spin || !m_hasDeadline)
+	{
+		return;
+	}
+	m_hasDeadline = false;
+
+	Clock::time_point now = Clock::now();
+	if (now >= m_deadline)
+	{
+		return;
+	}
+
+	// coarse sleep. leave the spin tail for the last bit
+	float remaining = std::chrono::duration<float>(m_deadline - now).count();
+	if (remaining > m_spinMargin)
+	{
+		float request = remaining - m_spinMargin;
+		std::this_thread::sleep_for(std::chrono::duration<float>(request));
+
+		Clock::time_point woke = Clock::now();
+		float slept = std::chrono::duration<float>(woke - now).count();
+		m_sleptTime += slept;
+
+		// grow margin right away when sleep overshoots, shrink it slowly when sleeps are accurate
+		float overshoot = slept - request;
+		float target = std::clamp(overshoot * 1.25f, MinSpinMargin, MaxSpinMargin);
+		m_spinMargin = target > m_spinMargin ? target : m_spinMargin * 0.99f + target * 0.01f;
+	}
+
+	// spin tail
+	while ((now = Clock::now()) < m_deadline)
+	{
+		std::this_thread::yield();
+	}
+
+	m_lastJitter = std::chrono::duration<float>(now - m_deadline).count();
+	m_maxJitter = std::max(m_maxJitter, m_lastJitter);
+	m_jitterSum += m_lastJitter;
+	++m_jitterCount;
+}
+
+void timer::FramePacer::ResetStatistics()
+{
+	m_lastJitter = 0.0f;
+	m_maxJitter = 0.0f;
+	m_jitterSum = 0.0;
+	m_jitterCount = 0;
+	m_sleptTime = 0.0f;
+}
@@ -70,3 +70,26 @@ void timer::Pulse::Update(float delta)
         }
     }
 }
+
+void timer::Pulse::Update()
+{
+    if (!m_clock)
+    {
+        return;
+    }
+
+    IClock::TimePoint now = m_clock->Now();
+    float delta = std::chrono::duration<float>(now - m_lastUpdateTime).count();
+    m_lastUpdateTime = now;
+
+    Update(delta);
+}
+
+void timer::Pulse::SetClock(const IClock* clock)
+{
+    m_clock = clock;
+    if (m_clock)
+    {
+        m_lastUpdateTime = m_clock->Now();
+    }
+}
@@ -1 +1,336 @@
 #include <Timer/Scheduler.h>
+#include <Performance/Profiler.h>
+#include <cmath>
+
+timer::Scheduler::Scheduler(float resolution) :
+	m_resolution(resolution > 0.0f ? resolution : 0.001f)
+{
+	for (uint32_t& head : m_heads)
+	{
+		head = NoNode;
+	}
+}
+
+timer::Scheduler::~Scheduler()
+{
+	Clear();
+}
+
+uint64_t timer::Scheduler::ToTick(double time) const
+{
+	return time > 0.0 ? static_cast<uint64_t>(std::floor(time / m_resolution)) : 0;
+}
+
+void timer::Scheduler::Link(uint32_t index, uint32_t list)
+{
+	Node& node = m_nodes[index];
+	node.list = list;
+	node.prev = NoNode;
+	node.next = m_heads[list];
+	if (node.next != NoNode)
+	{
+		m_nodes[node.next].prev = index;
+	}
+	m_heads[list] = index;
+}
+
+void timer::Scheduler::Unlink(uint32_t index)
+{
+	Node& node = m_nodes[index];
+	if (node.list == NoList)
+	{
+		return;
+	}
+
+	if (node.prev != NoNode)
+	{
+		m_nodes[node.prev].next = node.next;
+	}
+	else
+	{
+		m_heads[node.list] = node.next;
+	}
+
+	if (node.next != NoNode)
+	{
+		m_nodes[node.next].prev = node.prev;
+	}
+
+	node.list = NoList;
+}
+
+// puts node in the finest level its due tick fits in, relative to current wheel position
+void timer::Scheduler::Insert(uint32_t index)
+{
+	uint64_t due = ToTick(m_nodes[index].due);
+	if (due < m_tick)
+	{
+		// already late, goes to the slot being processed
+		due = m_tick;
+	}
+
+	uint64_t delta = due - m_tick;
+	for (uint32_t level = 0; level < Levels; ++level)
+	{
+		uint32_t shift = level * SlotBits;
+		if (level == Levels - 1 || delta < (uint64_t(1) << (shift + SlotBits)))
+		{
+			if (level == Levels - 1 && delta >= (uint64_t(1) << (shift + SlotBits)))
+			{
+				// beyond the wheel. parked in the farthest slot, placed again when that slot cascades
+				due = m_tick + (uint64_t(1) << (shift + SlotBits)) - 1;
+			}
+			Link(index, level * SlotsPerLevel + static_cast<uint32_t>((due >> shift) & SlotMask));
+			return;
+		}
+	}
+}
+
+// called each time the wheel moves to a new tick. when level 0 wraps, the next slot of level 1 is spread over
+// level 0, and so on upwards for as long as levels wrap
+void timer::Scheduler::Cascade()
+{
+	for (uint32_t level = 1; level < Levels; ++level)
+	{
+		uint32_t shift = level * SlotBits;
+		if ((m_tick & ((uint64_t(1) << shift) - 1)) != 0)
+		{
+			return;
+		}
+
+		uint32_t list = level * SlotsPerLevel + static_cast<uint32_t>((m_tick >> shift) & SlotMask);
+		uint32_t index = m_heads[list];
+		m_heads[list] = NoNode;
+		while (index != NoNode)
+		{
+			uint32_t next = m_nodes[index].next;
+			m_nodes[index].list = NoList;
+			Insert(index);
+			index = next;
+		}
+	}
+}
+
+// fires due schedules of a level 0 slot. schedules not due yet (same tick, later time) go back to the slot
+void timer::Scheduler::Expire(uint32_t list)
+{
+	if (m_heads[list] == NoNode)
+	{
+		return;
+	}
+
+	// move the slot to the expiring list, so handlers that add schedules or cancel others don't disturb the walk
+	m_heads[ExpiringList] = m_heads[list];
+	m_heads[list] = NoNode;
+	for (uint32_t index = m_heads[ExpiringList]; index != NoNode; index = m_nodes[index].next)
+	{
+		m_nodes[index].list = ExpiringList;
+	}
+
+	while (m_heads[ExpiringList] != NoNode)
+	{
+		uint32_t index = m_heads[ExpiringList];
+		Unlink(index);
+
+		// node storage may move while handlers add schedules, so it is indexed again after every call
+		size_t numUpdate = 0;
+		while (m_nodes[index].due <= m_time && numUpdate < m_nodes[index].maxTriggerPerUpdate)
+		{
+			m_nodes[index].due += m_nodes[index].interval;
+			numUpdate++;
+
+			m_nodes[index].ops->invoke(m_nodes[index].storage, m_nodes[index].interval);
+
+			if (m_nodes[index].cancelled)
+			{
+				break;
+			}
+		}
+
+		Node& node = m_nodes[index];
+		if (node.cancelled)
+		{
+			Release(index);
+			continue;
+		}
+
+		// if we reach max trigger per update, remaining time is processed in next update unless reset is asked for
+		if (numUpdate == node.maxTriggerPerUpdate && node.resetOnOverflow)
+		{
+			node.due = m_time + node.interval;
+		}
+
+		if (node.due <= m_time)
+		{
+			// still late. must not be visited again by the ticks left in this update
+			Link(index, LateList);
+		}
+		else
+		{
+			Insert(index);
+		}
+	}
+}
+
+void timer::Scheduler::Release(uint32_t index)
+{
+	Node& node = m_nodes[index];
+	node.ops->destroy(node.storage);
+	node.generation = 0;
+	node.list = NoList;
+	node.next = m_freeList;
+	m_freeList = index;
+	--m_count;
+}
+
+double timer::Scheduler::EarliestDue(uint32_t list) const
+{
+	double earliest = std::numeric_limits<double>::infinity();
+	for (uint32_t index = m_heads[list]; index != NoNode; index = m_nodes[index].next)
+	{
+		if (m_nodes[index].due < earliest)
+		{
+			earliest = m_nodes[index].due;
+		}
+	}
+	return earliest;
+}
+
+timer::ScheduleHandle timer::Scheduler::AddJob(float interval, std::function<void(float)> work, std::function<void()> onComplete, bool resetOnOverflow, size_t maxTriggerPerUpdate)
+{
+	// last run of this schedule, shared by every copy of the handler
+	auto last = std::make_shared<job::JobHandle>();
+
+	std::function<void(float)> submit = [this, work, onComplete, last](float delta)
+		{
+			if (!m_jobSystem)
+			{
+				work(delta);
+				if (onComplete)
+				{
+					onComplete();
+				}
+				return;
+			}
+
+			if (!m_jobSystem->IsDone(*last))
+			{
+				return;
+			}
+
+			*last = m_jobSystem->Create([work, delta]() { work(delta); });
+			if (onComplete)
+			{
+				m_jobSystem->OnComplete(*last, onComplete);
+			}
+			m_jobSystem->Submit(*last);
+		};
+
+	return Add(std::move(submit), interval, resetOnOverflow, maxTriggerPerUpdate);
+}
+
+void timer::Scheduler::Update(float time)
+{
+	PROFILE_SCOPE("Scheduler::Update");
+
+	m_time += time;
+	uint64_t target = ToTick(m_time);
+
+	// visit every tick from the current one up to now. slots of ticks before now are emptied completely,
+	// the slot of the current tick may keep schedules due later within the tick
+	for (;;)
+	{
+		Expire(static_cast<uint32_t>(m_tick & SlotMask));
+		if (m_tick >= target)
+		{
+			break;
+		}
+
+		++m_tick;
+		Cascade();
+	}
+
+	// late schedules go first next update
+	while (m_heads[LateList] != NoNode)
+	{
+		uint32_t index = m_heads[LateList];
+		Unlink(index);
+		Link(index, static_cast<uint32_t>(m_tick & SlotMask));
+	}
+}
+
+float timer::Scheduler::GetTimeUntilNextTrigger() const
+{
+	if (m_count == 0)
+	{
+		return std::numeric_limits<float>::infinity();
+	}
+
+	// slots of a level are visited in due order starting from the wheel position, so the first non empty slot of
+	// a level holds that level's earliest schedule. a coarser level can still hold one due before anything on a
+	// finer level (parked there before the wheel moved closer), so every level is checked and the earliest wins
+	double earliest = std::numeric_limits<double>::infinity();
+	for (uint32_t level = 0; level < Levels; ++level)
+	{
+		uint32_t shift = level * SlotBits;
+		uint64_t position = m_tick >> shift;
+		for (uint32_t i = level == 0 ? 0 : 1; i <= SlotsPerLevel; ++i)
+		{
+			if (level == 0 && i == SlotsPerLevel)
+			{
+				break;
+			}
+
+			uint32_t list = level * SlotsPerLevel + static_cast<uint32_t>((position + i) & SlotMask);
+			if (m_heads[list] != NoNode)
+			{
+				double due = EarliestDue(list);
+				if (due < earliest)
+				{
+					earliest = due;
+				}
+				break;
+			}
+		}
+	}
+
+	if (earliest == std::numeric_limits<double>::infinity())
+	{
+		return std::numeric_limits<float>::infinity();
+	}
+
+	double until = earliest - m_time;
+	return until > 0.0 ? static_cast<float>(until) : 0.0f;
+}
+
+void timer::Scheduler::Cancel(ScheduleHandle handle)
+{
+	if (!handle.IsValid() || handle.index >= m_nodes.size())
+	{
+		return;
+	}
+
+	Node& node = m_nodes[handle.index];
+	if (node.generation != handle.generation || node.cancelled)
+	{
+		return;
+	}
+
+	if (node.list == NoList)
+	{
+		// handler of this schedule is running, Expire releases it when the handler returns
+		node.cancelled = true;
+		return;
+	}
+
+	Unlink(handle.index);
+	Release(handle.index);
+}
+
+void timer::Scheduler::Clear()
+{
+	for (uint32_t i = 0; i < m_nodes.size(); ++i)
+	{
+		Cancel(ScheduleHandle{ i, m_nodes[i].generation });
+	}
+}
@@ -1,11 +1,12 @@
 #include <Timer/StopWatch.h>
 
-timer::StopWatch::StopWatch() noexcept :
+timer::StopWatch::StopWatch(const IClock& clock) noexcept :
+    m_clock(&clock),
     m_paused(false),
     m_lastLapDurationAccumulator(0.0),
-    m_lastLapTime(std::chrono::steady_clock::now()),
+    m_lastLapTime(clock.Now()),
     m_PausedDurationAccumulator(0.0),
-    m_startTime(std::chrono::steady_clock::now()),
+    m_startTime(clock.Now()),
     m_running(false)
 {
 }
@@ -24,7 +25,7 @@ const bool timer::StopWatch::IsPaused() const
 void timer::StopWatch::Start() noexcept
 {
     // measure current time (start)
-    m_startTime = std::chrono::steady_clock::now();
+    m_startTime = m_clock->Now();
 
     // set last lap to now. so lap calls will return duration between the lap call and this start
     m_lastLapTime = m_startTime;
@@ -50,7 +51,7 @@ void timer::StopWatch::Pause() noexcept
     }
 
     // now is the pause time
-    m_pausedStartTime = std::chrono::steady_clock::now();
+    m_pausedStartTime = m_clock->Now();
 
     // since we paused, we are storing elapsed time since lap time and now
     m_lastLapDurationAccumulator += (m_pausedStartTime - m_lastLapTime);
@@ -70,7 +71,7 @@ void timer::StopWatch::Resume() noexcept
         return;
     }
 
-    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point now = m_clock->Now();
 
     // add this pause duration to our total pause duration
     m_PausedDurationAccumulator += (now - m_pausedStartTime);